@@ -0,0 +1,183 @@
+// per event cost of calling the registered event handlers, the way Application::handleEvent used to do it (looking the
+// type up in an unordered_map and copying its vector of handlers) against EventDispatcher. the events are what a 1 kHz
+// mouse being moved around produces, with the odd key press and window event mixed in, and some handlers are on types
+// that never show up. one handler asks to be removed on its first call and one registers another while dispatching.
+//   event_bench [motion handlers] [seconds of mouse]
+#include <SDL3/SDL.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <event_dispatcher.hpp>
+#include <new>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+static constexpr int mouseRate = 1000;
+
+static std::atomic<Uint64> newCount = 0;
+
+void* operator new(size_t size) {
+    newCount++;
+
+    void* memory = malloc(size);
+    if(memory == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    return memory;
+}
+
+void operator delete(void* memory) noexcept { free(memory); }
+void operator delete(void* memory, size_t) noexcept { free(memory); }
+
+struct Result {
+    double nsPerEvent;
+    double allocationsPerEvent;
+    Uint64 calls;
+};
+
+// what handleEvent did before, erasing from the copy so returning false never removed anything
+class MapDispatcher {
+public:
+    void add(Uint32 type, const EventDispatcher::Handler& handler, void* extraData) { m_handlers[(SDL_EventType)type].push_back(std::make_pair(handler, extraData)); }
+
+    void dispatch(SDL_Event* event) {
+        auto it = m_handlers.find((SDL_EventType)event->type);
+        if(it != m_handlers.end()) {
+            std::vector<std::pair<EventDispatcher::Handler, void*>> handlers = it->second;
+
+            for(auto it = handlers.begin(); it != handlers.end();) {
+                std::pair<EventDispatcher::Handler, void*> handler = *it;
+                if(!(handler.first(event, handler.second))) {
+                    it = handlers.erase(it);
+                    continue;
+                }
+
+                it++;
+            }
+        }
+    }
+
+private:
+    std::unordered_map<SDL_EventType, std::vector<std::pair<EventDispatcher::Handler, void*>>> m_handlers;
+};
+
+static std::vector<SDL_Event> makeEvents(int count) {
+    std::vector<SDL_Event> events(count);
+
+    for(int i = 0; i < count; i++) {
+        SDL_Event& event = events[i];
+        event            = {};
+
+        if(i % 500 == 499) {
+            event.type = SDL_EVENT_WINDOW_MOUSE_LEAVE;
+        }
+        else if(i % 50 == 49) {
+            event.type    = i % 100 == 49 ? SDL_EVENT_KEY_DOWN : SDL_EVENT_KEY_UP;
+            event.key.key = SDLK_A;
+        }
+        else {
+            event.type        = SDL_EVENT_MOUSE_MOTION;
+            event.motion.x    = (float)(i % 1920);
+            event.motion.y    = (float)(i / 1920 % 1080);
+            event.motion.xrel = 1.0f;
+        }
+    }
+
+    return events;
+}
+
+template<typename Dispatcher>
+static Result run(const std::vector<SDL_Event>& events, int motionHandlers) {
+    Dispatcher dispatcher;
+    Uint64 calls = 0;
+
+    const auto count = [](SDL_Event*, void* extraData) {
+        (*(Uint64*)extraData)++;
+        return true;
+    };
+
+    for(int i = 0; i < motionHandlers; i++) {
+        dispatcher.add(SDL_EVENT_MOUSE_MOTION, count, &calls);
+    }
+
+    dispatcher.add(SDL_EVENT_KEY_DOWN, count, &calls);
+    dispatcher.add(SDL_EVENT_KEY_UP, count, &calls);
+    dispatcher.add(SDL_EVENT_WINDOW_MOUSE_LEAVE, count, &calls);
+    dispatcher.add(SDL_EVENT_GAMEPAD_BUTTON_DOWN, count, &calls);
+    dispatcher.add(SDL_EVENT_CAMERA_DEVICE_ADDED, count, &calls);
+
+    dispatcher.add(
+        SDL_EVENT_MOUSE_MOTION,
+        [](SDL_Event*, void* extraData) {
+            (*(Uint64*)extraData)++;
+            return false;
+        },
+        &calls
+    );
+
+    bool added = false;
+    dispatcher.add(
+        SDL_EVENT_KEY_DOWN,
+        [&](SDL_Event*, void*) {
+            if(!added) {
+                added = true;
+                dispatcher.add(SDL_EVENT_KEY_DOWN, count, &calls);
+            }
+
+            return true;
+        },
+        nullptr
+    );
+
+    std::vector<SDL_Event> queue = events;
+
+    const Uint64 news    = newCount;
+    const Uint64 startNS = SDL_GetTicksNS();
+
+    for(SDL_Event& event : queue) {
+        dispatcher.dispatch(&event);
+    }
+
+    const Uint64 elapsedNS = SDL_GetTicksNS() - startNS;
+
+    return Result{
+        .nsPerEvent          = (double)elapsedNS / queue.size(),
+        .allocationsPerEvent = (double)(newCount - news) / queue.size(),
+        .calls               = calls
+    };
+}
+
+int main(int argc, char** argv) {
+    const int motionHandlers = argc > 1 ? std::max(0, atoi(argv[1])) : 4;
+    const int seconds        = argc > 2 ? std::max(1, atoi(argv[2])) : 60;
+
+    const std::vector<SDL_Event> events = makeEvents(seconds * mouseRate);
+    printf("%zu events, %d handlers on mouse motion\n", events.size(), motionHandlers);
+
+    const Result map  = run<MapDispatcher>(events, motionHandlers);
+    const Result flat = run<EventDispatcher>(events, motionHandlers);
+
+    // at 1 kHz the mouse alone is a thousand dispatches a second
+    printf(
+        "map + copy: %.1f ns per event, %.2f allocations per event, %.3f ms per second of mouse, %llu handler calls\n",
+        map.nsPerEvent,
+        map.allocationsPerEvent,
+        map.nsPerEvent * mouseRate / SDL_NS_PER_MS,
+        (unsigned long long)map.calls
+    );
+
+    printf(
+        "flat:       %.1f ns per event, %.2f allocations per event, %.3f ms per second of mouse, %llu handler calls (%.1fx)\n",
+        flat.nsPerEvent,
+        flat.allocationsPerEvent,
+        flat.nsPerEvent * mouseRate / SDL_NS_PER_MS,
+        (unsigned long long)flat.calls,
+        map.nsPerEvent / std::max(flat.nsPerEvent, 0.001)
+    );
+
+    return 0;
+}
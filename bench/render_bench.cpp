@@ -0,0 +1,725 @@
+// replays recorded clay render commands through SDL_Clay_RenderClayCommands into a software renderer, so renderer
+// changes can be measured without a window or gpu. record lays out a ui like the apps own (a camera with two picture in
+// picture ones, a row of bordered picker entries in a clipped container, the stats panel and an animating status) and
+// writes every frames commands to a file. replay draws them again with synthetic camera frames and reports the time
+// per command type, the draw calls and the allocations of a frame.
+//   render_bench record <font.ttf> <file> [frames]
+//   render_bench replay <font.ttf> <file> [passes] [prewarm]
+// prewarm rasterizes the overlays glyphs up front like the app does at startup, compare the cold first frame without it
+#define CLAY_IMPLEMENTATION
+#include <clay.h>
+
+#include <algorithm>
+#include <atomic>
+#include <clay_renderer_SDL3.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+// the file is this, then per frame a Uint32 command count and the commands. every command is its Uint8 type and
+// bounding box, followed by what that type needs. colors are stored as bytes since clay uses 0 to 255 anyway, cameras
+// as their index since the pointers mean nothing in another process, images arent kept at all and replay as a
+// placeholder
+static constexpr char recordingMagic[4] = { 'C', 'C', 'R', 'C' };
+static constexpr Uint32 recordingVersion = 1;
+
+static constexpr int cameraCount  = 3;
+static constexpr int cameraWidth  = 1280;
+static constexpr int cameraHeight = 720;
+static constexpr Uint8 noCamera   = 0xFF;
+
+static constexpr int outputWidth  = 1920;
+static constexpr int outputHeight = 1080;
+
+// operator new for our own code and SDL_malloc for SDL and SDL_ttf
+static std::atomic<Uint64> newCount = 0;
+static std::atomic<Uint64> sdlCount = 0;
+
+void* operator new(size_t size) {
+    newCount++;
+
+    void* memory = malloc(size);
+    if(memory == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    return memory;
+}
+
+void operator delete(void* memory) noexcept { free(memory); }
+void operator delete(void* memory, size_t) noexcept { free(memory); }
+
+static void* countingMalloc(size_t size) {
+    sdlCount++;
+    return malloc(size);
+}
+
+static void* countingCalloc(size_t count, size_t size) {
+    sdlCount++;
+    return calloc(count, size);
+}
+
+static void* countingRealloc(void* memory, size_t size) {
+    sdlCount++;
+    return realloc(memory, size);
+}
+
+static bool measureCacheFull = false;
+
+static void handleClayErrors(Clay_ErrorData errorData) {
+    if(errorData.errorType == CLAY_ERROR_TYPE_TEXT_MEASUREMENT_CAPACITY_EXCEEDED) {
+        measureCacheFull = true;
+        return;
+    }
+
+    printf("%.*s\n", (int)errorData.errorText.length, errorData.errorText.chars);
+}
+
+static void writeFloat(SDL_IOStream* io, float value) {
+    Uint32 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    SDL_WriteU32LE(io, bits);
+}
+
+static float readFloat(SDL_IOStream* io) {
+    Uint32 bits = 0;
+    SDL_ReadU32LE(io, &bits);
+
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static void writeColor(SDL_IOStream* io, const Clay_Color& color) {
+    SDL_WriteU8(io, (Uint8)color.r);
+    SDL_WriteU8(io, (Uint8)color.g);
+    SDL_WriteU8(io, (Uint8)color.b);
+    SDL_WriteU8(io, (Uint8)color.a);
+}
+
+static Clay_Color readColor(SDL_IOStream* io) {
+    Uint8 r = 0, g = 0, b = 0, a = 0;
+    SDL_ReadU8(io, &r);
+    SDL_ReadU8(io, &g);
+    SDL_ReadU8(io, &b);
+    SDL_ReadU8(io, &a);
+
+    return Clay_Color{ (float)r, (float)g, (float)b, (float)a };
+}
+
+static void writeRadius(SDL_IOStream* io, const Clay_CornerRadius& radius) {
+    writeFloat(io, radius.topLeft);
+    writeFloat(io, radius.topRight);
+    writeFloat(io, radius.bottomLeft);
+    writeFloat(io, radius.bottomRight);
+}
+
+static Clay_CornerRadius readRadius(SDL_IOStream* io) {
+    Clay_CornerRadius radius;
+    radius.topLeft     = readFloat(io);
+    radius.topRight    = readFloat(io);
+    radius.bottomLeft  = readFloat(io);
+    radius.bottomRight = readFloat(io);
+
+    return radius;
+}
+
+static void writeFrame(SDL_IOStream* io, const Clay_RenderCommandArray& commands, const CustomElementData* cameras) {
+    SDL_WriteU32LE(io, (Uint32)commands.length);
+
+    for(int32_t i = 0; i < commands.length; i++) {
+        const Clay_RenderCommand& command = commands.internalArray[i];
+
+        SDL_WriteU8(io, (Uint8)command.commandType);
+        writeFloat(io, command.boundingBox.x);
+        writeFloat(io, command.boundingBox.y);
+        writeFloat(io, command.boundingBox.width);
+        writeFloat(io, command.boundingBox.height);
+
+        switch(command.commandType) {
+        case CLAY_RENDER_COMMAND_TYPE_RECTANGLE:
+            writeColor(io, command.renderData.rectangle.backgroundColor);
+            writeRadius(io, command.renderData.rectangle.cornerRadius);
+            break;
+        case CLAY_RENDER_COMMAND_TYPE_BORDER:
+            writeColor(io, command.renderData.border.color);
+            writeRadius(io, command.renderData.border.cornerRadius);
+            SDL_WriteU16LE(io, command.renderData.border.width.left);
+            SDL_WriteU16LE(io, command.renderData.border.width.right);
+            SDL_WriteU16LE(io, command.renderData.border.width.top);
+            SDL_WriteU16LE(io, command.renderData.border.width.bottom);
+            break;
+        case CLAY_RENDER_COMMAND_TYPE_TEXT: {
+            const Clay_TextRenderData& text = command.renderData.text;
+
+            writeColor(io, text.textColor);
+            SDL_WriteU16LE(io, text.fontId);
+            SDL_WriteU16LE(io, text.fontSize);
+            SDL_WriteU32LE(io, (Uint32)text.stringContents.length);
+            SDL_WriteIO(io, text.stringContents.chars, text.stringContents.length);
+            break;
+        }
+        case CLAY_RENDER_COMMAND_TYPE_IMAGE:
+            writeColor(io, command.renderData.image.backgroundColor);
+            writeRadius(io, command.renderData.image.cornerRadius);
+            break;
+        case CLAY_RENDER_COMMAND_TYPE_CUSTOM: {
+            const CustomElementData* data = (const CustomElementData*)command.renderData.custom.customData;
+            const bool isCamera           = data >= cameras && data < cameras + cameraCount;
+
+            writeColor(io, command.renderData.custom.backgroundColor);
+            writeRadius(io, command.renderData.custom.cornerRadius);
+            SDL_WriteU8(io, isCamera ? (Uint8)(data - cameras) : noCamera);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+}
+
+// laid out like Application does it, with counters in the stats and the status sliding in and out as frame goes on
+static void layoutFrame(int frame, CustomElementData* cameras, std::string& statsText, std::string& statusText) {
+    char line[256];
+    statsText.clear();
+    for(int i = 0; i < 12; i++) {
+        snprintf(line, sizeof(line), "Stat %d: %d frames, %.2f ms, %d bytes\n", i, frame * (i + 1), (frame % 100) / 7.0, frame * 1024 + i);
+        statsText += line;
+    }
+
+    statsText.pop_back();
+
+    // shown for 200 frames out of every 300, sliding in and out
+    const int statusFrame = frame % 300;
+    statusText            = statusFrame < 200 ? "Recording Device: USB Capture Card" : "";
+    const float progress  = std::clamp(std::min(statusFrame, 200 - statusFrame) / 60.0f, 0.0f, 1.0f);
+
+    Clay_BeginLayout();
+
+    // clang-format off
+    CLAY(
+        CLAY_ID("Body"),
+        {
+            .layout = {
+                .sizing = {
+                    CLAY_SIZING_PERCENT(1.0),
+                    CLAY_SIZING_PERCENT(1.0)
+                },
+                .padding = CLAY_PADDING_ALL(16),
+                .childGap = 16,
+                .childAlignment = { .y = CLAY_ALIGN_Y_BOTTOM },
+                .layoutDirection = CLAY_TOP_TO_BOTTOM
+            },
+            .backgroundColor = { 0, 0, 0, 255 },
+            .custom = { .customData = &cameras[0] }
+        }
+    ) {
+        for(int i = 1; i < cameraCount; i++) {
+            CLAY(
+                CLAY_IDI("Camera", i),
+                {
+                    .layout = {
+                        .sizing = {
+                            CLAY_SIZING_FIXED(outputWidth / 4.0f),
+                            CLAY_SIZING_FIXED(outputWidth / 4.0f * 9.0f / 16.0f)
+                        }
+                    },
+                    .backgroundColor = { 0, 0, 0, 255 },
+                    .floating = {
+                        .offset = { -16.0f, 16.0f + (i - 1) * (outputWidth / 4.0f * 9.0f / 16.0f + 16.0f) },
+                        .parentId = CLAY_ID("Body").id,
+                        .zIndex = 1,
+                        .attachPoints = {
+                            .element = CLAY_ATTACH_POINT_RIGHT_TOP,
+                            .parent = CLAY_ATTACH_POINT_RIGHT_TOP
+                        },
+                        .attachTo = CLAY_ATTACH_TO_ELEMENT_WITH_ID
+                    },
+                    .custom = { .customData = &cameras[i] }
+                }
+            ) {}
+        }
+
+        CLAY(
+            CLAY_ID("Picker"),
+            {
+                .layout = {
+                    .sizing = {
+                        CLAY_SIZING_GROW(0),
+                        CLAY_SIZING_FIXED(120)
+                    },
+                    .childGap = 16
+                },
+                .clip = { .horizontal = true }
+            }
+        ) {
+            for(int i = 0; i < 6; i++) {
+                CLAY(
+                    CLAY_IDI("PickerEntry", i),
+                    {
+                        .layout = {
+                            .sizing = {
+                                CLAY_SIZING_FIXED(360),
+                                CLAY_SIZING_GROW(0)
+                            },
+                            .padding = CLAY_PADDING_ALL(8)
+                        },
+                        .backgroundColor = { 0x20, 0x20, 0x20, 255 },
+                        .cornerRadius = CLAY_CORNER_RADIUS(6),
+                        .border = {
+                            .color = i == frame / 30 % 6 ? Clay_Color{ 255, 255, 255, 255 } : Clay_Color{ 0x50, 0x50, 0x50, 255 },
+                            .width = CLAY_BORDER_OUTSIDE(2)
+                        }
+                    }
+                ) {
+                    CLAY_TEXT(CLAY_STRING("Capture Card"), CLAY_TEXT_CONFIG({ .textColor = { 255, 255, 255, 255 }, .fontSize = 16 }));
+                }
+            }
+        }
+
+        CLAY(
+            CLAY_ID("Stats"),
+            {
+                .layout = {
+                    .padding = CLAY_PADDING_ALL(8)
+                },
+                .backgroundColor = { 0, 0, 0, 0xAF },
+                .cornerRadius = CLAY_CORNER_RADIUS(6),
+                .floating = {
+                    .offset = { 8.0f, 8.0f },
+                    .parentId = CLAY_ID("Body").id,
+                    .zIndex = 2,
+                    .attachPoints = {
+                        .element = CLAY_ATTACH_POINT_LEFT_TOP,
+                        .parent = CLAY_ATTACH_POINT_LEFT_TOP
+                    },
+                    .attachTo = CLAY_ATTACH_TO_ELEMENT_WITH_ID
+                }
+            }
+        ) {
+            Clay__OpenTextElement(
+                {
+                    .isStaticallyAllocated = false,
+                    .length = static_cast<int32_t>(statsText.size()),
+                    .chars = statsText.c_str()
+                },
+                CLAY_TEXT_CONFIG({
+                    .textColor = { 255, 255, 255, 255 },
+                    .fontSize = 16
+                })
+            );
+        }
+
+        if(!statusText.empty()) {
+            CLAY(
+                CLAY_ID("Status"),
+                {
+                    .layout = {
+                        .padding = CLAY_PADDING_ALL(8)
+                    },
+                    .backgroundColor = { 0, 0, 0, 0xAF },
+                    .cornerRadius = CLAY_CORNER_RADIUS(6),
+                    .floating = {
+                        .offset = { -8.0f, 48.0f - progress * 56.0f },
+                        .parentId = CLAY_ID("Body").id,
+                        .zIndex = 2,
+                        .attachPoints = {
+                            .element = CLAY_ATTACH_POINT_RIGHT_BOTTOM,
+                            .parent = CLAY_ATTACH_POINT_RIGHT_BOTTOM
+                        },
+                        .attachTo = CLAY_ATTACH_TO_ELEMENT_WITH_ID
+                    }
+                }
+            ) {
+                Clay__OpenTextElement(
+                    {
+                        .isStaticallyAllocated = false,
+                        .length = static_cast<int32_t>(statusText.size()),
+                        .chars = statusText.c_str()
+                    },
+                    CLAY_TEXT_CONFIG({
+                        .textColor = { 255, 255, 255, 255 },
+                        .fontSize = 24
+                    })
+                );
+            }
+        }
+    }
+    // clang-format on
+}
+
+static int record(Clay_SDL3RendererData* rendererData, const char* path, int frames) {
+    SDL_IOStream* io = SDL_IOFromFile(path, "wb");
+    if(io == nullptr) {
+        printf("Couldn't create %s: %s\n", path, SDL_GetError());
+        return 1;
+    }
+
+    SDL_WriteIO(io, recordingMagic, sizeof(recordingMagic));
+    SDL_WriteU32LE(io, recordingVersion);
+
+    const uint64_t memorySize = Clay_MinMemorySize();
+    void* memory              = malloc(memorySize);
+
+    Clay_Initialize(Clay_CreateArenaWithCapacityAndMemory(memorySize, memory), Clay_Dimensions{ outputWidth, outputHeight }, Clay_ErrorHandler{ handleClayErrors });
+    Clay_SetMeasureTextFunction(SDL_MeasureText, rendererData);
+
+    CustomElementData cameras[cameraCount];
+    for(CustomElementData& camera : cameras) {
+        camera = { .type = CUSTOM_ELEMENT_TYPE_CAMERA, .camera = { nullptr } };
+    }
+
+    std::string statsText;
+    std::string statusText;
+    Uint64 commands = 0;
+
+    for(int frame = 0; frame < frames; frame++) {
+        layoutFrame(frame, cameras, statsText, statusText);
+        Clay_RenderCommandArray array = Clay_EndLayout();
+
+        // clay only frees the measurements of a text that changed when it happens to look in the same bucket again,
+        // so the ever changing stats fill its cache up eventually and the texts after that measure as empty. start
+        // over and lay the frame out again
+        if(measureCacheFull) {
+            Clay_ResetMeasureTextCache();
+            measureCacheFull = false;
+
+            layoutFrame(frame, cameras, statsText, statusText);
+            array = Clay_EndLayout();
+        }
+        writeFrame(io, array, cameras);
+
+        commands += array.length;
+    }
+
+    const Sint64 size = SDL_TellIO(io);
+    SDL_CloseIO(io);
+    free(memory);
+
+    printf("Recorded %d frames, %.1f commands per frame, %lld bytes\n", frames, (double)commands / frames, (long long)size);
+    return 0;
+}
+
+struct Recording {
+    std::vector<std::vector<Clay_RenderCommand>> frames;
+    // the texts of a frame, the commands point into it
+    std::vector<std::string> strings;
+};
+
+static bool load(const char* path, Recording& recording, CustomElementData* cameras, SDL_Texture* image) {
+    SDL_IOStream* io = SDL_IOFromFile(path, "rb");
+    if(io == nullptr) {
+        printf("Couldn't open %s: %s\n", path, SDL_GetError());
+        return false;
+    }
+
+    char magic[4];
+    Uint32 version = 0;
+    if(SDL_ReadIO(io, magic, sizeof(magic)) != sizeof(magic) || memcmp(magic, recordingMagic, sizeof(magic)) != 0 || !SDL_ReadU32LE(io, &version) || version != recordingVersion) {
+        printf("%s isnt a recording of this version\n", path);
+
+        SDL_CloseIO(io);
+        return false;
+    }
+
+    Uint32 count;
+    while(SDL_ReadU32LE(io, &count)) {
+        std::vector<Clay_RenderCommand>& commands = recording.frames.emplace_back(count);
+        std::string& strings                      = recording.strings.emplace_back();
+
+        // texts are pointed at once the whole frame is read, strings may move until then
+        std::vector<std::pair<size_t, size_t>> textOffsets(count);
+
+        for(Uint32 i = 0; i < count; i++) {
+            Clay_RenderCommand& command = commands[i];
+            command                     = {};
+
+            Uint8 type = 0;
+            SDL_ReadU8(io, &type);
+            command.commandType        = (Clay_RenderCommandType)type;
+            command.boundingBox.x      = readFloat(io);
+            command.boundingBox.y      = readFloat(io);
+            command.boundingBox.width  = readFloat(io);
+            command.boundingBox.height = readFloat(io);
+
+            switch(command.commandType) {
+            case CLAY_RENDER_COMMAND_TYPE_RECTANGLE:
+                command.renderData.rectangle.backgroundColor = readColor(io);
+                command.renderData.rectangle.cornerRadius    = readRadius(io);
+                break;
+            case CLAY_RENDER_COMMAND_TYPE_BORDER:
+                command.renderData.border.color        = readColor(io);
+                command.renderData.border.cornerRadius = readRadius(io);
+                SDL_ReadU16LE(io, &command.renderData.border.width.left);
+                SDL_ReadU16LE(io, &command.renderData.border.width.right);
+                SDL_ReadU16LE(io, &command.renderData.border.width.top);
+                SDL_ReadU16LE(io, &command.renderData.border.width.bottom);
+                break;
+            case CLAY_RENDER_COMMAND_TYPE_TEXT: {
+                Clay_TextRenderData& text = command.renderData.text;
+                text.textColor            = readColor(io);
+                SDL_ReadU16LE(io, &text.fontId);
+                SDL_ReadU16LE(io, &text.fontSize);
+
+                Uint32 length = 0;
+                SDL_ReadU32LE(io, &length);
+
+                textOffsets[i] = { strings.size(), length };
+                strings.resize(strings.size() + length);
+                SDL_ReadIO(io, strings.data() + textOffsets[i].first, length);
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_IMAGE:
+                command.renderData.image.backgroundColor = readColor(io);
+                command.renderData.image.cornerRadius    = readRadius(io);
+                command.renderData.image.imageData       = image;
+                break;
+            case CLAY_RENDER_COMMAND_TYPE_CUSTOM: {
+                command.renderData.custom.backgroundColor = readColor(io);
+                command.renderData.custom.cornerRadius    = readRadius(io);
+
+                Uint8 camera = noCamera;
+                SDL_ReadU8(io, &camera);
+                command.renderData.custom.customData = camera < cameraCount ? &cameras[camera] : nullptr;
+                break;
+            }
+            default:
+                break;
+            }
+        }
+
+        for(Uint32 i = 0; i < count; i++) {
+            if(commands[i].commandType == CLAY_RENDER_COMMAND_TYPE_TEXT) {
+                const char* chars                          = strings.data() + textOffsets[i].first;
+                commands[i].renderData.text.stringContents = { (int32_t)textOffsets[i].second, chars, chars };
+            }
+        }
+    }
+
+    SDL_CloseIO(io);
+
+    if(recording.frames.empty()) {
+        printf("%s has no frames\n", path);
+        return false;
+    }
+
+    return true;
+}
+
+// a bar sweeping across a gradient, so every frame is a new upload like a real camera
+static void updateCamera(SDL_Texture* texture, int index, int frame) {
+    void* pixels;
+    int pitch;
+    if(!SDL_LockTexture(texture, nullptr, &pixels, &pitch)) {
+        return;
+    }
+
+    const int bar = (frame * 8 + index * 200) % cameraWidth;
+    for(int y = 0; y < cameraHeight; y++) {
+        Uint32* row = (Uint32*)((Uint8*)pixels + (size_t)y * pitch);
+        for(int x = 0; x < cameraWidth; x++) {
+            const Uint32 value = x >= bar && x < bar + 32 ? 0xFF : (Uint32)((x + y + index * 64) & 0xFF);
+            row[x]             = 0xFF000000 | value << 16 | (value / 2) << 8 | (0xFF - value);
+        }
+    }
+
+    SDL_UnlockTexture(texture);
+}
+
+static const char* commandTypeNames[] = { "none", "rectangle", "border", "text", "image", "scissor start", "scissor end", "custom" };
+static constexpr int commandTypeCount = sizeof(commandTypeNames) / sizeof(commandTypeNames[0]);
+
+static int replay(Clay_SDL3RendererData* rendererData, const char* path, int passes, bool prewarm) {
+    CustomElementData cameras[cameraCount];
+    for(CustomElementData& camera : cameras) {
+        camera = { .type = CUSTOM_ELEMENT_TYPE_CAMERA, .camera = { SDL_CreateTexture(rendererData->renderer, SDL_PIXELFORMAT_XRGB8888, SDL_TEXTUREACCESS_STREAMING, cameraWidth, cameraHeight) } };
+    }
+
+    SDL_Texture* image = SDL_CreateTexture(rendererData->renderer, SDL_PIXELFORMAT_XRGB8888, SDL_TEXTUREACCESS_STATIC, 64, 64);
+
+    Recording recording;
+    if(!load(path, recording, cameras, image)) {
+        return 1;
+    }
+
+    const int frames = (int)recording.frames.size();
+
+    Uint64 commandCount = 0;
+    for(const std::vector<Clay_RenderCommand>& commands : recording.frames) {
+        commandCount += commands.size();
+    }
+
+    printf("%d frames, %.1f commands per frame, %d passes\n", frames, (double)commandCount / frames, passes);
+
+    if(prewarm) {
+        const Uint64 startNS = SDL_GetTicksNS();
+
+        int glyphs = 0;
+        for(Uint16 size : { 16, 24 }) {
+            glyphs += SDL_Clay_PrewarmFont(rendererData, 0, size, " !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~");
+        }
+
+        printf("prewarmed %d glyphs in %.3f ms\n", glyphs, (double)(SDL_GetTicksNS() - startNS) / SDL_NS_PER_MS);
+    }
+
+    Uint64 coldFirstNS = 0;
+    Uint64 coldNS      = 0;
+    Uint64 totalNS     = 0;
+    Uint64 worstNS     = 0;
+    Uint64 uploadNS    = 0;
+
+    Uint64 drawCalls    = 0;
+    Uint64 textDraws    = 0;
+    Uint64 textureDraws = 0;
+    Uint64 vertices     = 0;
+    Uint64 news         = 0;
+    Uint64 sdlAllocs    = 0;
+
+    // the first pass is the cold one, glyphs are rasterized and texts shaped for the first time
+    for(int pass = 0; pass <= passes; pass++) {
+        for(int frame = 0; frame < frames; frame++) {
+            Uint64 startNS = SDL_GetTicksNS();
+            for(int i = 0; i < cameraCount; i++) {
+                updateCamera(cameras[i].camera.texture, i, frame);
+            }
+
+            SDL_SetRenderDrawColor(rendererData->renderer, 0, 0, 0, 255);
+            SDL_RenderClear(rendererData->renderer);
+            SDL_FlushRenderer(rendererData->renderer);
+
+            const Uint64 uploadedNS = SDL_GetTicksNS() - startNS;
+
+            std::vector<Clay_RenderCommand>& commands = recording.frames[frame];
+            Clay_RenderCommandArray array             = { (int32_t)commands.size(), (int32_t)commands.size(), commands.data() };
+
+            const Uint64 newsBefore = newCount;
+            const Uint64 sdlBefore  = sdlCount;
+
+            startNS = SDL_GetTicksNS();
+            SDL_Clay_BeginFrame(rendererData);
+            SDL_Clay_RenderClayCommands(rendererData, &array);
+            SDL_FlushRenderer(rendererData->renderer);
+            const Uint64 elapsedNS = SDL_GetTicksNS() - startNS;
+
+            if(pass == 0) {
+                coldNS += elapsedNS;
+                if(frame == 0) {
+                    coldFirstNS = elapsedNS;
+                }
+
+                continue;
+            }
+
+            // the frame isnt over until the next SDL_Clay_BeginFrame, so the stats are read before that
+            const Clay_SDL3GeometryStats stats = rendererData->geometry.frame;
+
+            totalNS      += elapsedNS;
+            worstNS       = std::max(worstNS, elapsedNS);
+            uploadNS     += uploadedNS;
+            drawCalls    += stats.drawCalls;
+            textDraws    += stats.textDraws;
+            textureDraws += stats.textureDraws;
+            vertices     += stats.vertices;
+            news         += newCount - newsBefore;
+            sdlAllocs    += sdlCount - sdlBefore;
+        }
+    }
+
+    const double timedFrames = (double)frames * passes;
+
+    printf("cold: %.3f ms first frame, %.3f ms avg\n", (double)coldFirstNS / SDL_NS_PER_MS, (double)coldNS / frames / SDL_NS_PER_MS);
+    printf("warm: %.3f ms avg, %.3f ms worst, plus %.3f ms of camera uploads\n", totalNS / timedFrames / SDL_NS_PER_MS, (double)worstNS / SDL_NS_PER_MS, uploadNS / timedFrames / SDL_NS_PER_MS);
+    printf("draw calls per frame: %.1f geometry (%.0f vertices), %.1f text, %.1f texture\n", drawCalls / timedFrames, vertices / timedFrames, textDraws / timedFrames, textureDraws / timedFrames);
+    printf("allocations per frame: %.1f new, %.1f SDL_malloc\n", news / timedFrames, sdlAllocs / timedFrames);
+
+    // each command on its own with a flush after it, since SDL only rasterizes on flush. that loses the batching, so
+    // these add up to more than a frame
+    Uint64 typeNS[commandTypeCount]    = {};
+    Uint64 typeCount[commandTypeCount] = {};
+
+    for(int pass = 0; pass < passes; pass++) {
+        for(int frame = 0; frame < frames; frame++) {
+            SDL_SetRenderDrawColor(rendererData->renderer, 0, 0, 0, 255);
+            SDL_RenderClear(rendererData->renderer);
+            SDL_FlushRenderer(rendererData->renderer);
+
+            // one frame as far as the text cache is concerned, or it would evict texts between the commands of a frame
+            SDL_Clay_BeginFrame(rendererData);
+
+            for(Clay_RenderCommand& command : recording.frames[frame]) {
+                Clay_RenderCommandArray array = { 1, 1, &command };
+
+                const Uint64 startNS = SDL_GetTicksNS();
+                SDL_Clay_RenderClayCommands(rendererData, &array);
+                SDL_FlushRenderer(rendererData->renderer);
+
+                const int type   = std::clamp((int)command.commandType, 0, commandTypeCount - 1);
+                typeNS[type]    += SDL_GetTicksNS() - startNS;
+                typeCount[type] += 1;
+            }
+        }
+    }
+
+    printf("%-14s %10s %10s %12s\n", "per command", "per frame", "ms/frame", "us/command");
+    for(int type = 0; type < commandTypeCount; type++) {
+        if(typeCount[type] == 0) {
+            continue;
+        }
+
+        printf("%-14s %10.1f %10.3f %12.2f\n", commandTypeNames[type], typeCount[type] / timedFrames, typeNS[type] / timedFrames / SDL_NS_PER_MS, (double)typeNS[type] / typeCount[type] / SDL_NS_PER_US);
+    }
+
+    for(CustomElementData& camera : cameras) {
+        SDL_DestroyTexture(camera.camera.texture);
+    }
+
+    SDL_DestroyTexture(image);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if(argc < 4 || (strcmp(argv[1], "record") != 0 && strcmp(argv[1], "replay") != 0)) {
+        printf("usage: %s record <font.ttf> <file> [frames]\n", argv[0]);
+        printf("       %s replay <font.ttf> <file> [passes] [prewarm]\n", argv[0]);
+        return 1;
+    }
+
+    const bool recording = strcmp(argv[1], "record") == 0;
+    const int count      = argc > 4 ? std::max(1, atoi(argv[4])) : recording ? 600 : 3;
+
+    // has to happen before SDL allocates anything
+    SDL_SetMemoryFunctions(countingMalloc, countingCalloc, countingRealloc, free);
+
+    if(!SDL_Init(0) || !TTF_Init()) {
+        printf("Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    SDL_Surface* surface = SDL_CreateSurface(outputWidth, outputHeight, SDL_PIXELFORMAT_XRGB8888);
+
+    Clay_SDL3RendererData rendererData;
+    rendererData.renderer   = SDL_CreateSoftwareRenderer(surface);
+    rendererData.textEngine = TTF_CreateRendererTextEngine(rendererData.renderer);
+    rendererData.fonts.push_back(TTF_OpenFont(argv[2], 40.0f));
+
+    if(rendererData.textEngine == nullptr || rendererData.fonts[0] == nullptr) {
+        printf("Couldn't set up text rendering: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    const int result = recording ? record(&rendererData, argv[3], count) : replay(&rendererData, argv[3], count, argc > 5 && strcmp(argv[5], "prewarm") == 0);
+
+    SDL_Clay_ClearTextCache(&rendererData);
+    TTF_CloseFont(rendererData.fonts[0]);
+    TTF_DestroyRendererTextEngine(rendererData.textEngine);
+    SDL_DestroyRenderer(rendererData.renderer);
+    SDL_DestroySurface(surface);
+
+    TTF_Quit();
+    SDL_Quit();
+
+    return result;
+}
@@ -0,0 +1,163 @@
+// throughput of the shared memory frame export: one writer publishing frames as fast as it can, or at a fixed rate,
+// and a few readers in their own threads going through the same shm_open'd ring a separate process would use.
+//   shm_bench [width] [height] [readers] [fps, 0 for unlimited] [seconds]
+#include <SDL3/SDL.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <shm_ring.hpp>
+#include <thread>
+#include <vector>
+
+struct ReaderResult {
+    Uint64 frames   = 0;
+    Uint64 torn     = 0;
+    Uint64 missed   = 0;
+    Uint64 bytes    = 0;
+    Uint64 latency  = 0;
+    Uint64 worstNS  = 0;
+    Uint64 checksum = 0;
+};
+
+static void readFrames(const char* name, std::atomic<bool>& ready, ReaderResult& result) {
+    ShmRing ring;
+    while(!ring.open(name)) {
+        SDL_DelayNS(SDL_NS_PER_MS);
+    }
+
+    ready = true;
+
+    Uint64 seen = ring.getHeader()->published;
+    while(true) {
+        const Uint64 published = ring.wait(seen, 100);
+        if(ring.isClosed()) {
+            break;
+        }
+
+        if(published == seen) {
+            continue;
+        }
+
+        ShmRing::View view;
+        if(!ring.acquire(published - 1, &view)) {
+            result.missed++;
+            seen = published;
+            continue;
+        }
+
+        const Uint64 latencyNS = SDL_GetTicksNS() - view.header->timestampNS;
+
+        Uint64 sum = 0;
+        for(Uint64 i = 0; i < view.header->size; i += 64) {
+            sum += view.data[i];
+        }
+
+        if(ring.validate(view)) {
+            result.frames++;
+            result.bytes    += view.header->size;
+            result.latency  += latencyNS;
+            result.worstNS   = std::max(result.worstNS, latencyNS);
+            result.checksum += sum;
+        }
+        else {
+            result.torn++;
+        }
+
+        result.missed += published - seen - 1;
+        seen           = published;
+    }
+}
+
+int main(int argc, char** argv) {
+    const int width      = argc > 1 ? std::atoi(argv[1]) : 1920;
+    const int height     = argc > 2 ? std::atoi(argv[2]) : 1080;
+    const int readers    = argc > 3 ? std::atoi(argv[3]) : 2;
+    const int fps        = argc > 4 ? std::atoi(argv[4]) : 0;
+    const double seconds = argc > 5 ? std::atof(argv[5]) : 5.0;
+
+    const char* name  = "/capturecardrelay-bench";
+    const size_t size = (size_t)width * height * 2;
+
+    ShmRing ring;
+    if(!ring.create(name, 4, size)) {
+        return 1;
+    }
+
+    std::vector<ReaderResult> results(readers);
+    std::vector<std::atomic<bool>> ready(readers);
+    std::vector<std::thread> threads;
+    for(int i = 0; i < readers; i++) {
+        threads.emplace_back(readFrames, name, std::ref(ready[i]), std::ref(results[i]));
+    }
+
+    for(int i = 0; i < readers; i++) {
+        while(!ready[i]) {
+            SDL_DelayNS(SDL_NS_PER_MS);
+        }
+    }
+
+    // a moving gradient so every frame is different
+    std::vector<Uint8> pixels(size);
+    for(size_t i = 0; i < size; i++) {
+        pixels[i] = (Uint8)(i * 7);
+    }
+
+    const Uint64 startNS    = SDL_GetTicksNS();
+    const Uint64 durationNS = (Uint64)(seconds * SDL_NS_PER_SECOND);
+    Uint64 written          = 0;
+
+    while(SDL_GetTicksNS() - startNS < durationNS) {
+        if(fps > 0) {
+            const Uint64 dueNS = startNS + written * SDL_NS_PER_SECOND / fps;
+            const Uint64 nowNS = SDL_GetTicksNS();
+            if(dueNS > nowNS) {
+                SDL_DelayNS(dueNS - nowNS);
+            }
+        }
+
+        pixels[written % size]++;
+
+        const ShmSlotHeader info = {
+            .sequence      = {},
+            .format        = SDL_PIXELFORMAT_YUY2,
+            .width         = (Uint32)width,
+            .height        = (Uint32)height,
+            .pitch         = (Uint32)width * 2,
+            .size          = size,
+            .timestampNS   = SDL_GetTicksNS(),
+            .frameSequence = written
+        };
+
+        ring.write(info, pixels.data());
+        written++;
+    }
+
+    const double elapsed = (double)(SDL_GetTicksNS() - startNS) / SDL_NS_PER_SECOND;
+    ring.close();
+
+    for(std::thread& thread : threads) {
+        thread.join();
+    }
+
+    printf("%dx%d YUY2 (%.1f MiB per frame), %d readers\n", width, height, size / (1024.0 * 1024.0), readers);
+    printf("writer: %llu frames, %.1f fps, %.2f GiB/s\n", (unsigned long long)written, written / elapsed, written * size / elapsed / (1024.0 * 1024.0 * 1024.0));
+
+    for(int i = 0; i < readers; i++) {
+        const ReaderResult& result = results[i];
+
+        printf(
+            "reader %d: %.1f fps, %.2f GiB/s, %llu missed, %llu torn, latency %.3f ms avg %.3f ms worst\n",
+            i,
+            result.frames / elapsed,
+            result.bytes / elapsed / (1024.0 * 1024.0 * 1024.0),
+            (unsigned long long)result.missed,
+            (unsigned long long)result.torn,
+            result.frames > 0 ? (double)result.latency / result.frames / SDL_NS_PER_MS : 0.0,
+            (double)result.worstNS / SDL_NS_PER_MS
+        );
+    }
+
+    return 0;
+}
@@ -0,0 +1,216 @@
+// per frame cost of drawing many overlay labels, the way the renderer used to do it (a TTF_Text created, colored, drawn
+// and destroyed for every text command) against the text cache in SDL_Clay_RenderClayCommands. labels alternate
+// between two sizes like the stats overlay and status message do, and a few of them change every frame like counters.
+// draws into a software renderer, so it runs without a window or gpu. also compares measuring the labels words the way
+// clay does during layout, by resizing the shared font and asking SDL_ttf, against the glyph tables in SDL_MeasureText.
+//   text_bench <font.ttf> [labels] [changing labels] [frames]
+#define CLAY_IMPLEMENTATION
+#include <clay.h>
+
+#include <algorithm>
+#include <clay_renderer_SDL3.hpp>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+struct Result {
+    double averageMS;
+    double worstMS;
+};
+
+static void updateLabels(std::vector<std::string>& strings, std::vector<Clay_RenderCommand>& commands, int changing, int frame) {
+    for(size_t i = 0; i < strings.size(); i++) {
+        // the changing ones get a new string, the rest keep theirs
+        if(i < (size_t)changing || frame == 0) {
+            char text[64];
+            snprintf(text, sizeof(text), "Label %zu: %d frames, %.1f ms", i, i < (size_t)changing ? frame : 0, (i * 7 % 100) / 10.0);
+            strings[i] = text;
+        }
+
+        Clay_TextRenderData& data = commands[i].renderData.text;
+        data.stringContents       = { (int32_t)strings[i].size(), strings[i].c_str(), strings[i].c_str() };
+    }
+}
+
+static Result run(Clay_SDL3RendererData* rendererData, int labels, int changing, int frames, bool cached) {
+    std::vector<std::string> strings(labels);
+    std::vector<Clay_RenderCommand> commands(labels);
+
+    for(int i = 0; i < labels; i++) {
+        Clay_RenderCommand& command = commands[i];
+        command                     = {};
+        command.commandType         = CLAY_RENDER_COMMAND_TYPE_TEXT;
+        command.boundingBox         = { (float)(i % 4) * 480.0f, (float)(i / 4 % 40) * 26.0f, 480.0f, 26.0f };
+
+        Clay_TextRenderData& data = command.renderData.text;
+        data.textColor            = { 255, 255, (float)(i % 2) * 255, 255 };
+        data.fontId               = 0;
+        data.fontSize             = i % 2 == 0 ? 16 : 24;
+    }
+
+    Clay_RenderCommandArray array = { (int32_t)commands.size(), (int32_t)commands.size(), commands.data() };
+
+    Uint64 totalNS = 0;
+    Uint64 worstNS = 0;
+
+    for(int frame = 0; frame < frames; frame++) {
+        updateLabels(strings, commands, changing, frame);
+
+        SDL_SetRenderDrawColor(rendererData->renderer, 0, 0, 0, 255);
+        SDL_RenderClear(rendererData->renderer);
+
+        const Uint64 startNS = SDL_GetTicksNS();
+
+        if(cached) {
+            SDL_Clay_BeginFrame(rendererData);
+            SDL_Clay_RenderClayCommands(rendererData, &array);
+        }
+        else {
+            for(Clay_RenderCommand& command : commands) {
+                Clay_TextRenderData* config = &command.renderData.text;
+
+                TTF_Font* font = rendererData->fonts[config->fontId];
+                TTF_SetFontSize(font, config->fontSize);
+
+                TTF_Text* text = TTF_CreateText(rendererData->textEngine, font, config->stringContents.chars, config->stringContents.length);
+                TTF_SetTextColor(text, config->textColor.r, config->textColor.g, config->textColor.b, config->textColor.a);
+                TTF_DrawRendererText(text, command.boundingBox.x, command.boundingBox.y);
+                TTF_DestroyText(text);
+            }
+        }
+
+        SDL_FlushRenderer(rendererData->renderer);
+
+        // the first frame fills the glyph atlas either way
+        const Uint64 elapsedNS = SDL_GetTicksNS() - startNS;
+        if(frame > 0) {
+            totalNS += elapsedNS;
+            worstNS  = std::max(worstNS, elapsedNS);
+        }
+    }
+
+    return Result{
+        .averageMS = (double)totalNS / std::max(1, frames - 1) / SDL_NS_PER_MS,
+        .worstMS   = (double)worstNS / SDL_NS_PER_MS
+    };
+}
+
+struct MeasureResult {
+    double uncachedMS;
+    double cachedMS;
+    float worstDifference;
+};
+
+static MeasureResult measure(Clay_SDL3RendererData* rendererData, int labels, int frames) {
+    std::vector<std::string> words;
+    for(int i = 0; i < labels; i++) {
+        char text[64];
+        snprintf(text, sizeof(text), "Label %d: %d frames, %.1f ms", i, i * 31, (i * 7 % 100) / 10.0);
+
+        // clay measures word by word
+        std::string label = text;
+        size_t start      = 0;
+        while(start < label.size()) {
+            const size_t end = std::min(label.find(' ', start), label.size());
+            words.push_back(label.substr(start, end - start));
+            start = end + 1;
+        }
+    }
+
+    MeasureResult result = {};
+
+    Uint64 startNS = SDL_GetTicksNS();
+    for(int frame = 0; frame < frames; frame++) {
+        for(size_t i = 0; i < words.size(); i++) {
+            TTF_Font* font = rendererData->fonts[0];
+            TTF_SetFontSize(font, i % 2 == 0 ? 16 : 24);
+
+            int width, height;
+            TTF_GetStringSize(font, words[i].c_str(), words[i].size(), &width, &height);
+        }
+    }
+    result.uncachedMS = (double)(SDL_GetTicksNS() - startNS) / frames / SDL_NS_PER_MS;
+
+    startNS = SDL_GetTicksNS();
+    for(int frame = 0; frame < frames; frame++) {
+        for(size_t i = 0; i < words.size(); i++) {
+            Clay_TextElementConfig config = {};
+            config.fontSize               = i % 2 == 0 ? 16 : 24;
+
+            SDL_MeasureText({ (int32_t)words[i].size(), words[i].c_str(), words[i].c_str() }, &config, rendererData);
+        }
+    }
+    result.cachedMS = (double)(SDL_GetTicksNS() - startNS) / frames / SDL_NS_PER_MS;
+
+    // the tables sum advances and kerning instead of shaping, check how far off that is
+    for(size_t i = 0; i < words.size(); i++) {
+        TTF_Font* font = rendererData->fonts[0];
+        TTF_SetFontSize(font, i % 2 == 0 ? 16 : 24);
+
+        int width, height;
+        TTF_GetStringSize(font, words[i].c_str(), words[i].size(), &width, &height);
+
+        Clay_TextElementConfig config = {};
+        config.fontSize               = i % 2 == 0 ? 16 : 24;
+
+        const Clay_Dimensions dimensions = SDL_MeasureText({ (int32_t)words[i].size(), words[i].c_str(), words[i].c_str() }, &config, rendererData);
+        result.worstDifference           = std::max(result.worstDifference, std::abs(dimensions.width - (float)width));
+    }
+
+    return result;
+}
+
+int main(int argc, char** argv) {
+    if(argc < 2) {
+        printf("usage: %s <font.ttf> [labels] [changing labels] [frames]\n", argv[0]);
+        return 1;
+    }
+
+    const int labels   = argc > 2 ? std::max(1, atoi(argv[2])) : 200;
+    const int changing = argc > 3 ? std::clamp(atoi(argv[3]), 0, labels) : 10;
+    const int frames   = argc > 4 ? std::max(2, atoi(argv[4])) : 300;
+
+    if(!SDL_Init(0) || !TTF_Init()) {
+        printf("Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    SDL_Surface* surface = SDL_CreateSurface(1920, 1080, SDL_PIXELFORMAT_XRGB8888);
+
+    Clay_SDL3RendererData rendererData;
+    rendererData.renderer   = SDL_CreateSoftwareRenderer(surface);
+    rendererData.textEngine = TTF_CreateRendererTextEngine(rendererData.renderer);
+    rendererData.fonts.push_back(TTF_OpenFont(argv[1], 40.0f));
+
+    if(rendererData.textEngine == nullptr || rendererData.fonts[0] == nullptr) {
+        printf("Couldn't set up text rendering: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    printf("%d labels, %d changing every frame, %d frames\n", labels, changing, frames);
+
+    const Result uncached = run(&rendererData, labels, changing, frames, false);
+    printf("create per draw: %.3f ms avg, %.3f ms worst\n", uncached.averageMS, uncached.worstMS);
+
+    const Result cached = run(&rendererData, labels, changing, frames, true);
+    printf("cached:          %.3f ms avg, %.3f ms worst (%.1fx)\n", cached.averageMS, cached.worstMS, uncached.averageMS / std::max(cached.averageMS, 0.001));
+
+    const Clay_SDL3TextCacheStats stats = SDL_Clay_GetTextCacheStats(&rendererData);
+    printf("cache: %zu texts in %zu font sizes, %llu hits, %llu misses, %llu evictions\n", stats.texts, stats.fonts, (unsigned long long)stats.hits, (unsigned long long)stats.misses, (unsigned long long)stats.evictions);
+
+    const MeasureResult measured = measure(&rendererData, labels, frames);
+    printf("measure per frame: %.3f ms resizing, %.3f ms from glyph tables (%.1fx), widths off by at most %.0f px\n", measured.uncachedMS, measured.cachedMS, measured.uncachedMS / std::max(measured.cachedMS, 0.0001), measured.worstDifference);
+
+    SDL_Clay_ClearTextCache(&rendererData);
+    TTF_CloseFont(rendererData.fonts[0]);
+    TTF_DestroyRendererTextEngine(rendererData.textEngine);
+    SDL_DestroyRenderer(rendererData.renderer);
+    SDL_DestroySurface(surface);
+
+    TTF_Quit();
+    SDL_Quit();
+
+    return 0;
+}
@@ -9,15 +9,104 @@
 #include <SDL3_ttf/SDL_ttf.h>
 #include <clay.h>
 
+#include <array>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 struct Clay_Color;
 struct Clay_RenderCommandArray;
 
+struct Clay_SDL3CachedText {
+    TTF_Text* text;
+
+    // the cache is keyed by a hash of these, so they are compared on every hit
+    std::string contents;
+    Uint16 fontId;
+    Uint16 fontSize;
+
+    Clay_Color color;
+    Uint64 lastUsed;
+};
+
+// what SDL_MeasureText needs of a font at one size, filled in as glyphs show up so measuring is only table lookups
+struct Clay_SDL3GlyphTable {
+    TTF_Font* font;
+    int height;
+
+    // ascii is indexed directly, -1 until looked up
+    std::array<int, 128> advances;
+    std::unordered_map<Uint32, int> otherAdvances;
+
+    // kerning between ascii pairs at previous * 128 + current, INT_MIN until looked up. empty if the font has none
+    std::vector<int> kerning;
+    std::unordered_map<Uint64, int> otherKerning;
+};
+
+struct Clay_SDL3TextCacheStats {
+    size_t texts;
+    size_t fonts;
+    Uint64 hits;
+    Uint64 misses;
+    Uint64 evictions;
+
+    Uint64 measurements;
+    Uint64 glyphsLoaded;
+
+    // roughly what the glyph tables and cached strings take, the shaped glyphs and atlas belong to SDL_ttf
+    size_t bytes;
+};
+
+struct Clay_SDL3GeometryStats {
+    // rectangles, rounded rectangles, border edges and corners
+    Uint64 primitives;
+    Uint64 drawCalls;
+    Uint64 vertices;
+    Uint64 indices;
+
+    // the draws that arent batched
+    Uint64 textDraws;
+    Uint64 textureDraws;
+};
+
+// solid triangles collected between the commands that need the renderer to themselves (text, images, cameras and
+// clipping) and drawn with one SDL_RenderGeometry. the buffers are only cleared, so once they've grown to fit the
+// overlay a frame doesnt allocate
+struct Clay_SDL3Geometry {
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+
+    Clay_SDL3GeometryStats frame;
+    Clay_SDL3GeometryStats lastFrame;
+};
+
 struct Clay_SDL3RendererData {
     SDL_Renderer* renderer;
     TTF_TextEngine* textEngine;
     std::vector<TTF_Font*> fonts;
+
+    // a copy of each font for every size it's drawn at. cached texts are reshaped whenever their font changes, so they
+    // cant share one that keeps being resized
+    std::unordered_map<Uint32, TTF_Font*> sizedFonts;
+
+    // shaped texts kept across frames, a frame only creates the ones that changed since the last
+    std::unordered_map<Uint64, Clay_SDL3CachedText> textCache;
+    // bumped by SDL_Clay_BeginFrame, texts unused for a while are destroyed
+    Uint64 generation = 0;
+
+    // keyed like sizedFonts
+    std::unordered_map<Uint32, Clay_SDL3GlyphTable> glyphTables;
+
+    // made by SDL_Clay_PrewarmFont and never drawn, they hold on to their glyphs in the text engines atlas
+    std::vector<TTF_Text*> prewarmedTexts;
+
+    Uint64 textCacheHits      = 0;
+    Uint64 textCacheMisses    = 0;
+    Uint64 textCacheEvictions = 0;
+    Uint64 measurements       = 0;
+    Uint64 glyphsLoaded       = 0;
+
+    Clay_SDL3Geometry geometry = {};
 };
 
 typedef enum {
@@ -25,7 +114,7 @@ typedef enum {
 } CustomElementType;
 
 struct CameraData {
-    SDL_Camera* device;
+    // owned and kept up to date by the camera stream or the time-shift player, may be null until the first frame arrives
     SDL_Texture* texture;
 };
 
@@ -36,10 +125,29 @@ typedef struct {
     };
 } CustomElementData;
 
+// userData is the Clay_SDL3RendererData
 Clay_Dimensions SDL_MeasureText(Clay_StringSlice text, Clay_TextElementConfig* config, void* userData);
 
-void SDL_Clay_RenderFillRoundedRect(Clay_SDL3RendererData* rendererData, const SDL_FRect rect, const float cornerRadius, const Clay_Color _color);
-void SDL_Clay_RenderArc(Clay_SDL3RendererData* rendererData, const SDL_FPoint center, const float radius, const float startAngle, const float endAngle, const float thickness, const Clay_Color color);
+// these only add to the batch, it's drawn by SDL_Clay_FlushGeometry
+void SDL_Clay_BatchFillRect(Clay_SDL3RendererData* rendererData, const SDL_FRect rect, const Clay_Color color);
+void SDL_Clay_BatchFillRoundedRect(Clay_SDL3RendererData* rendererData, const SDL_FRect rect, const float cornerRadius, const Clay_Color color);
+// a quarter of a ring, startAngle is 0, 90, 180 or 270 degrees clockwise from the right
+void SDL_Clay_BatchArc(Clay_SDL3RendererData* rendererData, const SDL_FPoint center, const float radius, const float startAngle, const float thickness, const Clay_Color color);
+void SDL_Clay_FlushGeometry(Clay_SDL3RendererData* rendererData);
+
+// starts a frame for the text cache and the geometry stats, once per frame however many times the commands are rendered
+void SDL_Clay_BeginFrame(Clay_SDL3RendererData* rendererData);
 void SDL_Clay_RenderClayCommands(Clay_SDL3RendererData* rendererData, Clay_RenderCommandArray* rcommands);
+// what the previous frame batched, between the last two SDL_Clay_BeginFrame calls
+Clay_SDL3GeometryStats SDL_Clay_GetGeometryStats(Clay_SDL3RendererData* rendererData);
+
+// fonts[fontId] at fontSize, copied the first time that size is asked for
+TTF_Font* SDL_Clay_GetFont(Clay_SDL3RendererData* rendererData, Uint16 fontId, Uint16 fontSize);
+// rasterizes every glyph in glyphs at fontSize into the text engines atlas and loads their advances for measuring, so
+// the first frame showing them doesnt stall on it. returns how many glyphs were new to the measurement table
+int SDL_Clay_PrewarmFont(Clay_SDL3RendererData* rendererData, Uint16 fontId, Uint16 fontSize, const char* glyphs);
+// destroys every cached text, glyph table and sized font, has to happen before the fonts and text engine go away
+void SDL_Clay_ClearTextCache(Clay_SDL3RendererData* rendererData);
+Clay_SDL3TextCacheStats SDL_Clay_GetTextCacheStats(Clay_SDL3RendererData* rendererData);
 
 #endif
\ No newline at end of file
@@ -7,232 +7,450 @@
 #include <clay.h>
 
 #include <clay_renderer_SDL3.hpp>
+#include <climits>
 #include <cstdint>
 #include <cstring>
+#include <string>
 #include <vector>
 
+// texts not drawn for this many frames are destroyed, long enough for anything that blinks or is shown every other second
+static constexpr Uint64 TEXT_CACHE_MAX_AGE = 120;
+// past this many an old text is destroyed as soon as a frame didnt use it, the stats overlay alone makes new ones every second
+static constexpr size_t TEXT_CACHE_MAX_SIZE = 1024;
+
+TTF_Font* SDL_Clay_GetFont(Clay_SDL3RendererData* rendererData, Uint16 fontId, Uint16 fontSize) {
+    const Uint32 key = ((Uint32)fontId << 16) | fontSize;
+
+    auto it = rendererData->sizedFonts.find(key);
+    if(it != rendererData->sizedFonts.end()) {
+        return it->second;
+    }
+
+    TTF_Font* font = TTF_CopyFont(rendererData->fonts[fontId]);
+    if(font == nullptr || !TTF_SetFontSize(font, fontSize)) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Failed to create font %u at size %u: %s", fontId, fontSize, SDL_GetError());
+
+        TTF_CloseFont(font);
+        return rendererData->fonts[fontId];
+    }
+
+    rendererData->sizedFonts[key] = font;
+    return font;
+}
+
+static Clay_SDL3GlyphTable& SDL_Clay_GetGlyphTable(Clay_SDL3RendererData* rendererData, Uint16 fontId, Uint16 fontSize) {
+    const Uint32 key = ((Uint32)fontId << 16) | fontSize;
+
+    auto it = rendererData->glyphTables.find(key);
+    if(it != rendererData->glyphTables.end()) {
+        return it->second;
+    }
+
+    Clay_SDL3GlyphTable& table = rendererData->glyphTables[key];
+    table.font                 = SDL_Clay_GetFont(rendererData, fontId, fontSize);
+    table.height               = TTF_GetFontHeight(table.font);
+    table.advances.fill(-1);
+
+    if(TTF_GetFontKerning(table.font)) {
+        table.kerning.assign(128 * 128, INT_MIN);
+    }
+
+    return table;
+}
+
+static int SDL_Clay_GetAdvance(Clay_SDL3RendererData* rendererData, Clay_SDL3GlyphTable& table, Uint32 ch) {
+    int* advance = nullptr;
+    if(ch < 128) {
+        advance = &table.advances[ch];
+    }
+    else {
+        auto it = table.otherAdvances.try_emplace(ch, -1).first;
+        advance = &it->second;
+    }
+
+    if(*advance >= 0) {
+        return *advance;
+    }
+
+    int minX, maxX, minY, maxY;
+    if(!TTF_GetGlyphMetrics(table.font, ch, &minX, &maxX, &minY, &maxY, advance)) {
+        *advance = 0;
+    }
+
+    rendererData->glyphsLoaded++;
+    return *advance;
+}
+
+static int SDL_Clay_GetKerning(Clay_SDL3GlyphTable& table, Uint32 previous, Uint32 ch) {
+    if(table.kerning.empty()) {
+        return 0;
+    }
+
+    int* kerning = nullptr;
+    if(previous < 128 && ch < 128) {
+        kerning = &table.kerning[previous * 128 + ch];
+    }
+    else {
+        auto it = table.otherKerning.try_emplace(((Uint64)previous << 32) | ch, INT_MIN).first;
+        kerning = &it->second;
+    }
+
+    if(*kerning == INT_MIN && !TTF_GetGlyphKerning(table.font, previous, ch, kerning)) {
+        *kerning = 0;
+    }
+
+    return *kerning;
+}
+
+// clay measures every word on its own and again whenever a text changes, so this only sums cached advances and
+// kerning instead of shaping the string. overhangs of the last glyph arent counted, which only italic fonts have
 Clay_Dimensions SDL_MeasureText(Clay_StringSlice text, Clay_TextElementConfig* config, void* userData) {
-    std::vector<TTF_Font*>& fonts = *reinterpret_cast<std::vector<TTF_Font*>*>(userData);
-    TTF_Font* font                = fonts[config->fontId];
-    int width, height;
+    Clay_SDL3RendererData* rendererData = reinterpret_cast<Clay_SDL3RendererData*>(userData);
+    Clay_SDL3GlyphTable& table          = SDL_Clay_GetGlyphTable(rendererData, config->fontId, config->fontSize);
+
+    rendererData->measurements++;
+
+    const char* chars = text.chars;
+    size_t length     = text.length;
+
+    int width       = 0;
+    Uint32 previous = 0;
+    while(length > 0) {
+        const Uint32 ch = SDL_StepUTF8(&chars, &length);
+        if(previous != 0) {
+            width += SDL_Clay_GetKerning(table, previous, ch);
+        }
 
-    TTF_SetFontSize(font, config->fontSize);
-    if(!TTF_GetStringSize(font, text.chars, text.length, &width, &height)) {
-        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Failed to measure text: %s", SDL_GetError());
+        width    += SDL_Clay_GetAdvance(rendererData, table, ch);
+        previous  = ch;
     }
 
     return Clay_Dimensions{
         (float)width,
-        (float)height,
+        (float)table.height,
     };
 }
 
-/* Global for convenience. Even in 4K this is enough for smooth curves (low radius or rect size coupled with
- * no AA or low resolution might make it appear as jagged curves) */
-static int NUM_CIRCLE_SEGMENTS = 16;
+int SDL_Clay_PrewarmFont(Clay_SDL3RendererData* rendererData, Uint16 fontId, Uint16 fontSize, const char* glyphs) {
+    TTF_Font* font = SDL_Clay_GetFont(rendererData, fontId, fontSize);
 
-// all rendering is performed by a single SDL call, avoiding multiple RenderRect + plumbing choice for circles.
-void SDL_Clay_RenderFillRoundedRect(Clay_SDL3RendererData* rendererData, const SDL_FRect rect, const float cornerRadius, const Clay_Color _color) {
-    const SDL_FColor color = { _color.r / 255, _color.g / 255, _color.b / 255, _color.a / 255 };
+    // laying the text out is when the engine rasterizes its glyphs and uploads them, it doesnt have to be drawn
+    TTF_Text* text = TTF_CreateText(rendererData->textEngine, font, glyphs, 0);
+    if(text == nullptr || !TTF_UpdateText(text)) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Failed to prewarm font %u at size %u: %s", fontId, fontSize, SDL_GetError());
 
-    int indexCount = 0, vertexCount = 0;
+        TTF_DestroyText(text);
+        return 0;
+    }
 
-    const float minRadius     = SDL_min(rect.w, rect.h) / 2.0f;
-    const float clampedRadius = SDL_min(cornerRadius, minRadius);
+    rendererData->prewarmedTexts.push_back(text);
 
-    const int numCircleSegments = SDL_max(NUM_CIRCLE_SEGMENTS, (int)clampedRadius * 0.5f);
+    Clay_TextElementConfig config = {};
+    config.fontId                 = fontId;
+    config.fontSize               = fontSize;
 
-    const int totalVertices = 4 + (4 * (numCircleSegments * 2)) + 2 * 4;
-    const int totalIndices  = 6 + (4 * (numCircleSegments * 3)) + 6 * 4;
+    const Uint64 glyphsLoaded = rendererData->glyphsLoaded;
+    SDL_MeasureText({ (int32_t)strlen(glyphs), glyphs, glyphs }, &config, rendererData);
 
-    std::vector<SDL_Vertex> vertices(totalVertices);
-    std::vector<int> indices(totalIndices);
+    return (int)(rendererData->glyphsLoaded - glyphsLoaded);
+}
 
-    // define center rectangle
-    vertices[vertexCount++] = (SDL_Vertex){
-        { rect.x + clampedRadius, rect.y + clampedRadius },
-        color,
-        { 0,                      0                      }
-    };  // 0 center TL
-    vertices[vertexCount++] = (SDL_Vertex){
-        { rect.x + rect.w - clampedRadius, rect.y + clampedRadius },
-        color,
-        { 1,                               0                      }
-    };  // 1 center TR
-    vertices[vertexCount++] = (SDL_Vertex){
-        { rect.x + rect.w - clampedRadius, rect.y + rect.h - clampedRadius },
-        color,
-        { 1,                               1                               }
-    };  // 2 center BR
-    vertices[vertexCount++] = (SDL_Vertex){
-        { rect.x + clampedRadius, rect.y + rect.h - clampedRadius },
-        color,
-        { 0,                      1                               }
-    };  // 3 center BL
-
-    indices[indexCount++] = 0;
-    indices[indexCount++] = 1;
-    indices[indexCount++] = 3;
-    indices[indexCount++] = 1;
-    indices[indexCount++] = 2;
-    indices[indexCount++] = 3;
-
-    // define rounded corners as triangle fans
-    const float step = (SDL_PI_F / 2) / numCircleSegments;
-    for(int i = 0; i < numCircleSegments; i++) {
-        const float angle1 = (float)i * step;
-        const float angle2 = ((float)i + 1.0f) * step;
-
-        for(int j = 0; j < 4; j++) {  // Iterate over four corners
-            float cx, cy, signX, signY;
-
-            switch(j) {
-            case 0:
-                cx    = rect.x + clampedRadius;
-                cy    = rect.y + clampedRadius;
-                signX = -1;
-                signY = -1;
-                break;  // Top-left
-            case 1:
-                cx    = rect.x + rect.w - clampedRadius;
-                cy    = rect.y + clampedRadius;
-                signX = 1;
-                signY = -1;
-                break;  // Top-right
-            case 2:
-                cx    = rect.x + rect.w - clampedRadius;
-                cy    = rect.y + rect.h - clampedRadius;
-                signX = 1;
-                signY = 1;
-                break;  // Bottom-right
-            case 3:
-                cx    = rect.x + clampedRadius;
-                cy    = rect.y + rect.h - clampedRadius;
-                signX = -1;
-                signY = 1;
-                break;  // Bottom-left
-            default: return;
-            }
+void SDL_Clay_ClearTextCache(Clay_SDL3RendererData* rendererData) {
+    for(auto& [key, cached] : rendererData->textCache) {
+        TTF_DestroyText(cached.text);
+    }
 
-            vertices[vertexCount++] = (SDL_Vertex){
-                { cx + SDL_cosf(angle1) * clampedRadius * signX, cy + SDL_sinf(angle1) * clampedRadius * signY },
-                color,
-                { 0,                                             0                                             }
-            };
-            vertices[vertexCount++] = (SDL_Vertex){
-                { cx + SDL_cosf(angle2) * clampedRadius * signX, cy + SDL_sinf(angle2) * clampedRadius * signY },
-                color,
-                { 0,                                             0                                             }
-            };
+    for(TTF_Text* text : rendererData->prewarmedTexts) {
+        TTF_DestroyText(text);
+    }
+
+    for(auto& [key, font] : rendererData->sizedFonts) {
+        TTF_CloseFont(font);
+    }
+
+    rendererData->textCache.clear();
+    rendererData->prewarmedTexts.clear();
+    rendererData->glyphTables.clear();
+    rendererData->sizedFonts.clear();
+}
+
+Clay_SDL3TextCacheStats SDL_Clay_GetTextCacheStats(Clay_SDL3RendererData* rendererData) {
+    // hash map nodes are counted as their key and value plus a next pointer and the cached hash
+    size_t bytes = 0;
+    for(const auto& [key, table] : rendererData->glyphTables) {
+        bytes += sizeof(key) + sizeof(table) + 2 * sizeof(void*);
+        bytes += table.kerning.capacity() * sizeof(int);
+        bytes += table.otherAdvances.size() * (sizeof(Uint32) + sizeof(int) + 2 * sizeof(void*));
+        bytes += table.otherKerning.size() * (sizeof(Uint64) + sizeof(int) + 2 * sizeof(void*));
+    }
+
+    for(const auto& [key, cached] : rendererData->textCache) {
+        bytes += sizeof(key) + sizeof(cached) + 2 * sizeof(void*);
+        bytes += cached.contents.capacity();
+    }
 
-            indices[indexCount++] = j;  // Connect to corresponding central rectangle vertex
-            indices[indexCount++] = vertexCount - 2;
-            indices[indexCount++] = vertexCount - 1;
+    return Clay_SDL3TextCacheStats{
+        .texts        = rendererData->textCache.size(),
+        .fonts        = rendererData->sizedFonts.size(),
+        .hits         = rendererData->textCacheHits,
+        .misses       = rendererData->textCacheMisses,
+        .evictions    = rendererData->textCacheEvictions,
+        .measurements = rendererData->measurements,
+        .glyphsLoaded = rendererData->glyphsLoaded,
+        .bytes        = bytes
+    };
+}
+
+// FNV-1a over the string, font and size
+static Uint64 SDL_Clay_HashText(Clay_StringSlice string, Uint16 fontId, Uint16 fontSize) {
+    Uint64 hash = 0xCBF29CE484222325ull;
+
+    for(int32_t i = 0; i < string.length; i++) {
+        hash = (hash ^ (Uint8)string.chars[i]) * 0x100000001B3ull;
+    }
+
+    hash = (hash ^ fontId) * 0x100000001B3ull;
+    hash = (hash ^ fontSize) * 0x100000001B3ull;
+
+    return hash;
+}
+
+static TTF_Text* SDL_Clay_GetCachedText(Clay_SDL3RendererData* rendererData, Clay_TextRenderData* config) {
+    const Clay_StringSlice string = config->stringContents;
+    const Uint64 key              = SDL_Clay_HashText(string, config->fontId, config->fontSize);
+
+    auto it = rendererData->textCache.find(key);
+    if(it != rendererData->textCache.end() && it->second.fontId == config->fontId && it->second.fontSize == config->fontSize && it->second.contents.compare(0, std::string::npos, string.chars, string.length) == 0) {
+        rendererData->textCacheHits++;
+    }
+    else {
+        // a hash collision just replaces the other text
+        if(it != rendererData->textCache.end()) {
+            TTF_DestroyText(it->second.text);
+            rendererData->textCache.erase(it);
+        }
+
+        TTF_Font* font = SDL_Clay_GetFont(rendererData, config->fontId, config->fontSize);
+        TTF_Text* text = TTF_CreateText(rendererData->textEngine, font, string.chars, string.length);
+        if(text == nullptr) {
+            SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Failed to create text: %s", SDL_GetError());
+            return nullptr;
         }
+
+        rendererData->textCacheMisses++;
+
+        // -1 never matches a real color, so the first draw sets it
+        it = rendererData->textCache.emplace(key, Clay_SDL3CachedText{
+            .text     = text,
+            .contents = std::string(string.chars, string.length),
+            .fontId   = config->fontId,
+            .fontSize = config->fontSize,
+            .color    = { -1.0f, -1.0f, -1.0f, -1.0f },
+            .lastUsed = 0
+        }).first;
     }
 
-    // Define edge rectangles
-    //  Top edge
-    vertices[vertexCount++] = (SDL_Vertex){
-        { rect.x + clampedRadius, rect.y },
-        color,
-        { 0,                      0      }
-    };  // TL
-    vertices[vertexCount++] = (SDL_Vertex){
-        { rect.x + rect.w - clampedRadius, rect.y },
-        color,
-        { 1,                               0      }
-    };  // TR
-
-    indices[indexCount++] = 0;
-    indices[indexCount++] = vertexCount - 2;  // TL
-    indices[indexCount++] = vertexCount - 1;  // TR
-    indices[indexCount++] = 1;
-    indices[indexCount++] = 0;
-    indices[indexCount++] = vertexCount - 1;  // TR
-    // Right edge
-    vertices[vertexCount++] = (SDL_Vertex){
-        { rect.x + rect.w, rect.y + clampedRadius },
-        color,
-        { 1,               0                      }
-    };  // RT
-    vertices[vertexCount++] = (SDL_Vertex){
-        { rect.x + rect.w, rect.y + rect.h - clampedRadius },
-        color,
-        { 1,               1                               }
-    };  // RB
-
-    indices[indexCount++] = 1;
-    indices[indexCount++] = vertexCount - 2;  // RT
-    indices[indexCount++] = vertexCount - 1;  // RB
-    indices[indexCount++] = 2;
-    indices[indexCount++] = 1;
-    indices[indexCount++] = vertexCount - 1;  // RB
-    // Bottom edge
-    vertices[vertexCount++] = (SDL_Vertex){
-        { rect.x + rect.w - clampedRadius, rect.y + rect.h },
-        color,
-        { 1,                               1               }
-    };  // BR
-    vertices[vertexCount++] = (SDL_Vertex){
-        { rect.x + clampedRadius, rect.y + rect.h },
-        color,
-        { 0,                      1               }
-    };  // BL
-
-    indices[indexCount++] = 2;
-    indices[indexCount++] = vertexCount - 2;  // BR
-    indices[indexCount++] = vertexCount - 1;  // BL
-    indices[indexCount++] = 3;
-    indices[indexCount++] = 2;
-    indices[indexCount++] = vertexCount - 1;  // BL
-    // Left edge
-    vertices[vertexCount++] = (SDL_Vertex){
-        { rect.x, rect.y + rect.h - clampedRadius },
-        color,
-        { 0,      1                               }
-    };  // LB
-    vertices[vertexCount++] = (SDL_Vertex){
-        { rect.x, rect.y + clampedRadius },
+    Clay_SDL3CachedText& cached = it->second;
+    cached.lastUsed             = rendererData->generation;
+
+    const Clay_Color color = config->textColor;
+    if(color.r != cached.color.r || color.g != cached.color.g || color.b != cached.color.b || color.a != cached.color.a) {
+        TTF_SetTextColor(cached.text, color.r, color.g, color.b, color.a);
+        cached.color = color;
+    }
+
+    return cached.text;
+}
+
+static void SDL_Clay_EvictTexts(Clay_SDL3RendererData* rendererData) {
+    const bool full = rendererData->textCache.size() > TEXT_CACHE_MAX_SIZE;
+
+    // checking every text each frame isnt worth it until the cache fills up
+    if(!full && rendererData->generation % TEXT_CACHE_MAX_AGE != 0) {
+        return;
+    }
+
+    const Uint64 maxAge = full ? 1 : TEXT_CACHE_MAX_AGE;
+    for(auto it = rendererData->textCache.begin(); it != rendererData->textCache.end();) {
+        if(rendererData->generation - it->second.lastUsed <= maxAge) {
+            it++;
+            continue;
+        }
+
+        TTF_DestroyText(it->second.text);
+        it = rendererData->textCache.erase(it);
+
+        rendererData->textCacheEvictions++;
+    }
+}
+
+// every corner is a quarter circle, drawn with every first, second or fourth point of this depending on its radius. even
+// in 4K 64 segments are smooth
+static constexpr int QUARTER_CIRCLE_SEGMENTS = 64;
+
+struct SDL_Clay_QuarterCircle {
+    float cos[QUARTER_CIRCLE_SEGMENTS + 1];
+    float sin[QUARTER_CIRCLE_SEGMENTS + 1];
+};
+
+// taylor series, only ever asked for 0 to pi/2 where it's exact to float precision
+static constexpr double SDL_Clay_Sine(double x) {
+    double term = x;
+    double sum  = x;
+    for(int i = 1; i < 12; i++) {
+        term *= -x * x / ((2 * i) * (2 * i + 1));
+        sum  += term;
+    }
+
+    return sum;
+}
+
+static constexpr SDL_Clay_QuarterCircle SDL_Clay_MakeQuarterCircle() {
+    SDL_Clay_QuarterCircle circle = {};
+    for(int i = 0; i <= QUARTER_CIRCLE_SEGMENTS; i++) {
+        const double angle = (double)i / QUARTER_CIRCLE_SEGMENTS * (SDL_PI_D / 2);
+        circle.sin[i]      = (float)SDL_Clay_Sine(angle);
+        circle.cos[i]      = (float)SDL_Clay_Sine(SDL_PI_D / 2 - angle);
+    }
+
+    return circle;
+}
+
+static constexpr SDL_Clay_QuarterCircle QUARTER_CIRCLE = SDL_Clay_MakeQuarterCircle();
+
+static SDL_FColor SDL_Clay_ToFColor(const Clay_Color color) {
+    return SDL_FColor{ color.r / 255, color.g / 255, color.b / 255, color.a / 255 };
+}
+
+static void SDL_Clay_AddVertex(Clay_SDL3Geometry& geometry, float x, float y, const SDL_FColor color) {
+    geometry.vertices.push_back(SDL_Vertex{
+        { x, y },
         color,
-        { 0,      0                      }
-    };  // LT
-
-    indices[indexCount++] = 3;
-    indices[indexCount++] = vertexCount - 2;  // LB
-    indices[indexCount++] = vertexCount - 1;  // LT
-    indices[indexCount++] = 0;
-    indices[indexCount++] = 3;
-    indices[indexCount++] = vertexCount - 1;  // LT
-
-    // Render everything
-    SDL_RenderGeometry(rendererData->renderer, NULL, vertices.data(), vertices.size(), indices.data(), indices.size());
+        { 0, 0 }
+    });
 }
 
-void SDL_Clay_RenderArc(Clay_SDL3RendererData* rendererData, const SDL_FPoint center, const float radius, const float startAngle, const float endAngle, const float thickness, const Clay_Color color) {
-    SDL_SetRenderDrawColor(rendererData->renderer, color.r, color.g, color.b, color.a);
+static void SDL_Clay_AddTriangle(Clay_SDL3Geometry& geometry, int a, int b, int c) {
+    geometry.indices.push_back(a);
+    geometry.indices.push_back(b);
+    geometry.indices.push_back(c);
+}
 
-    const float radStart = startAngle * (SDL_PI_F / 180.0f);
-    const float radEnd   = endAngle * (SDL_PI_F / 180.0f);
+static void SDL_Clay_AddRect(Clay_SDL3Geometry& geometry, const SDL_FRect rect, const SDL_FColor color) {
+    if(rect.w <= 0 || rect.h <= 0) {
+        return;
+    }
 
-    const int numCircleSegments = SDL_max(NUM_CIRCLE_SEGMENTS, (int)(radius * 1.5f));  // increase circle segments for larger circles, 1.5 is arbitrary.
+    const int first = (int)geometry.vertices.size();
+    SDL_Clay_AddVertex(geometry, rect.x, rect.y, color);
+    SDL_Clay_AddVertex(geometry, rect.x + rect.w, rect.y, color);
+    SDL_Clay_AddVertex(geometry, rect.x + rect.w, rect.y + rect.h, color);
+    SDL_Clay_AddVertex(geometry, rect.x, rect.y + rect.h, color);
 
-    const float angleStep     = (radEnd - radStart) / (float)numCircleSegments;
-    const float thicknessStep = 0.4f;  // arbitrary value to avoid overlapping lines. Changing THICKNESS_STEP or numCircleSegments might cause artifacts.
+    SDL_Clay_AddTriangle(geometry, first, first + 1, first + 2);
+    SDL_Clay_AddTriangle(geometry, first, first + 2, first + 3);
+}
 
-    for(float t = thicknessStep; t < thickness - thicknessStep; t += thicknessStep) {
-        std::vector<SDL_FPoint> points(numCircleSegments + 1);
-        const float clampedRadius = SDL_max(radius - t, 1.0f);
+// a quarter ring from innerRadius to outerRadius around center, signX and signY pick the quadrant. with no inner
+// radius it's a filled quarter circle
+static void SDL_Clay_AddQuarterRing(Clay_SDL3Geometry& geometry, const SDL_FPoint center, float outerRadius, float innerRadius, float signX, float signY, const SDL_FColor color) {
+    if(outerRadius <= 0) {
+        return;
+    }
 
-        for(int i = 0; i <= numCircleSegments; i++) {
-            const float angle = radStart + i * angleStep;
-            points[i]         = (SDL_FPoint){
-                SDL_roundf(center.x + SDL_cosf(angle) * clampedRadius),
-                SDL_roundf(center.y + SDL_sinf(angle) * clampedRadius)
-            };
+    const int step  = outerRadius < 24 ? 4 : outerRadius < 64 ? 2 : 1;
+    const int first = (int)geometry.vertices.size();
+
+    if(innerRadius <= 0) {
+        SDL_Clay_AddVertex(geometry, center.x, center.y, color);
+
+        for(int i = 0; i <= QUARTER_CIRCLE_SEGMENTS; i += step) {
+            SDL_Clay_AddVertex(geometry, center.x + QUARTER_CIRCLE.cos[i] * outerRadius * signX, center.y + QUARTER_CIRCLE.sin[i] * outerRadius * signY, color);
         }
-        SDL_RenderLines(rendererData->renderer, points.data(), points.size());
+
+        for(int i = 1; i <= QUARTER_CIRCLE_SEGMENTS / step; i++) {
+            SDL_Clay_AddTriangle(geometry, first, first + i, first + i + 1);
+        }
+
+        return;
+    }
+
+    // outer and inner point of each segment next to each other
+    for(int i = 0; i <= QUARTER_CIRCLE_SEGMENTS; i += step) {
+        SDL_Clay_AddVertex(geometry, center.x + QUARTER_CIRCLE.cos[i] * outerRadius * signX, center.y + QUARTER_CIRCLE.sin[i] * outerRadius * signY, color);
+        SDL_Clay_AddVertex(geometry, center.x + QUARTER_CIRCLE.cos[i] * innerRadius * signX, center.y + QUARTER_CIRCLE.sin[i] * innerRadius * signY, color);
     }
+
+    for(int i = 0; i < QUARTER_CIRCLE_SEGMENTS / step; i++) {
+        const int outer = first + i * 2;
+        SDL_Clay_AddTriangle(geometry, outer, outer + 1, outer + 2);
+        SDL_Clay_AddTriangle(geometry, outer + 1, outer + 3, outer + 2);
+    }
+}
+
+void SDL_Clay_BatchFillRect(Clay_SDL3RendererData* rendererData, const SDL_FRect rect, const Clay_Color color) {
+    SDL_Clay_AddRect(rendererData->geometry, rect, SDL_Clay_ToFColor(color));
+    rendererData->geometry.frame.primitives++;
+}
+
+// a cross of three rectangles with a quarter circle in each corner, none of them overlap so translucent colors blend once
+void SDL_Clay_BatchFillRoundedRect(Clay_SDL3RendererData* rendererData, const SDL_FRect rect, const float cornerRadius, const Clay_Color _color) {
+    Clay_SDL3Geometry& geometry = rendererData->geometry;
+    const SDL_FColor color      = SDL_Clay_ToFColor(_color);
+
+    const float minRadius = SDL_min(rect.w, rect.h) / 2.0f;
+    const float radius    = SDL_min(cornerRadius, minRadius);
+
+    SDL_Clay_AddRect(geometry, { rect.x, rect.y + radius, rect.w, rect.h - radius * 2 }, color);
+    SDL_Clay_AddRect(geometry, { rect.x + radius, rect.y, rect.w - radius * 2, radius }, color);
+    SDL_Clay_AddRect(geometry, { rect.x + radius, rect.y + rect.h - radius, rect.w - radius * 2, radius }, color);
+
+    SDL_Clay_AddQuarterRing(geometry, { rect.x + radius, rect.y + radius }, radius, 0, -1, -1, color);
+    SDL_Clay_AddQuarterRing(geometry, { rect.x + rect.w - radius, rect.y + radius }, radius, 0, 1, -1, color);
+    SDL_Clay_AddQuarterRing(geometry, { rect.x + rect.w - radius, rect.y + rect.h - radius }, radius, 0, 1, 1, color);
+    SDL_Clay_AddQuarterRing(geometry, { rect.x + radius, rect.y + rect.h - radius }, radius, 0, -1, 1, color);
+
+    geometry.frame.primitives++;
+}
+
+void SDL_Clay_BatchArc(Clay_SDL3RendererData* rendererData, const SDL_FPoint center, const float radius, const float startAngle, const float thickness, const Clay_Color color) {
+    // screen y points down, so going clockwise from the right the quadrants are bottom right, bottom left, top left, top right
+    const int quadrant = (int)(startAngle / 90.0f) & 3;
+    const float signX  = quadrant == 0 || quadrant == 3 ? 1.0f : -1.0f;
+    const float signY  = quadrant < 2 ? 1.0f : -1.0f;
+
+    SDL_Clay_AddQuarterRing(rendererData->geometry, center, radius, SDL_max(radius - thickness, 0.0f), signX, signY, SDL_Clay_ToFColor(color));
+    rendererData->geometry.frame.primitives++;
+}
+
+void SDL_Clay_FlushGeometry(Clay_SDL3RendererData* rendererData) {
+    Clay_SDL3Geometry& geometry = rendererData->geometry;
+    if(geometry.indices.empty()) {
+        return;
+    }
+
+    // untextured geometry blends with the draw blend mode
+    SDL_SetRenderDrawBlendMode(rendererData->renderer, SDL_BLENDMODE_BLEND);
+    SDL_RenderGeometry(rendererData->renderer, NULL, geometry.vertices.data(), (int)geometry.vertices.size(), geometry.indices.data(), (int)geometry.indices.size());
+
+    geometry.frame.drawCalls++;
+    geometry.frame.vertices += geometry.vertices.size();
+    geometry.frame.indices  += geometry.indices.size();
+
+    geometry.vertices.clear();
+    geometry.indices.clear();
+}
+
+Clay_SDL3GeometryStats SDL_Clay_GetGeometryStats(Clay_SDL3RendererData* rendererData) {
+    return rendererData->geometry.lastFrame;
+}
+
+void SDL_Clay_BeginFrame(Clay_SDL3RendererData* rendererData) {
+    rendererData->generation++;
+    SDL_Clay_EvictTexts(rendererData);
+
+    rendererData->geometry.lastFrame = rendererData->geometry.frame;
+    rendererData->geometry.frame     = {};
 }
 
 SDL_Rect currentClippingRectangle;
@@ -245,27 +463,24 @@ void SDL_Clay_RenderClayCommands(Clay_SDL3RendererData* rendererData, Clay_Rende
         switch(rcmd->commandType) {
         case CLAY_RENDER_COMMAND_TYPE_RECTANGLE: {
             Clay_RectangleRenderData* config = &rcmd->renderData.rectangle;
-            SDL_SetRenderDrawBlendMode(rendererData->renderer, SDL_BLENDMODE_BLEND);
-            SDL_SetRenderDrawColor(rendererData->renderer, config->backgroundColor.r, config->backgroundColor.g, config->backgroundColor.b, config->backgroundColor.a);
 
             if(config->cornerRadius.topLeft > 0) {
-                SDL_Clay_RenderFillRoundedRect(rendererData, rect, config->cornerRadius.topLeft, config->backgroundColor);
+                SDL_Clay_BatchFillRoundedRect(rendererData, rect, config->cornerRadius.topLeft, config->backgroundColor);
                 break;
             }
 
-            SDL_RenderFillRect(rendererData->renderer, &rect);
+            SDL_Clay_BatchFillRect(rendererData, rect, config->backgroundColor);
             break;
         }
         case CLAY_RENDER_COMMAND_TYPE_TEXT: {
             Clay_TextRenderData* config = &rcmd->renderData.text;
+            SDL_Clay_FlushGeometry(rendererData);
 
-            TTF_Font* font = rendererData->fonts[config->fontId];
-            TTF_SetFontSize(font, config->fontSize);
-
-            TTF_Text* text = TTF_CreateText(rendererData->textEngine, font, config->stringContents.chars, config->stringContents.length);
-            TTF_SetTextColor(text, config->textColor.r, config->textColor.g, config->textColor.b, config->textColor.a);
-            TTF_DrawRendererText(text, rect.x, rect.y);
-            TTF_DestroyText(text);
+            TTF_Text* text = SDL_Clay_GetCachedText(rendererData, config);
+            if(text != nullptr) {
+                TTF_DrawRendererText(text, rect.x, rect.y);
+                rendererData->geometry.frame.textDraws++;
+            }
 
             break;
         }
@@ -281,13 +496,12 @@ void SDL_Clay_RenderClayCommands(Clay_SDL3RendererData* rendererData, Clay_Rende
             };
 
             // edges
-            SDL_SetRenderDrawColor(rendererData->renderer, config->color.r, config->color.g, config->color.b, config->color.a);
             if(config->width.left > 0) {
                 const float starting_y = rect.y + clampedRadii.topLeft;
                 const float length     = rect.h - clampedRadii.topLeft - clampedRadii.bottomLeft;
 
                 SDL_FRect line = { rect.x - 1, starting_y, (float)config->width.left, length };
-                SDL_RenderFillRect(rendererData->renderer, &line);
+                SDL_Clay_BatchFillRect(rendererData, line, config->color);
             }
 
             if(config->width.right > 0) {
@@ -296,7 +510,7 @@ void SDL_Clay_RenderClayCommands(Clay_SDL3RendererData* rendererData, Clay_Rende
                 const float length     = rect.h - clampedRadii.topRight - clampedRadii.bottomRight;
 
                 SDL_FRect line = { starting_x, starting_y, (float)config->width.right, length };
-                SDL_RenderFillRect(rendererData->renderer, &line);
+                SDL_Clay_BatchFillRect(rendererData, line, config->color);
             }
 
             if(config->width.top > 0) {
@@ -304,7 +518,7 @@ void SDL_Clay_RenderClayCommands(Clay_SDL3RendererData* rendererData, Clay_Rende
                 const float length     = rect.w - clampedRadii.topLeft - clampedRadii.topRight;
 
                 SDL_FRect line = { starting_x, rect.y - 1, length, (float)config->width.top };
-                SDL_RenderFillRect(rendererData->renderer, &line);
+                SDL_Clay_BatchFillRect(rendererData, line, config->color);
             }
 
             if(config->width.bottom > 0) {
@@ -313,8 +527,7 @@ void SDL_Clay_RenderClayCommands(Clay_SDL3RendererData* rendererData, Clay_Rende
                 const float length     = rect.w - clampedRadii.bottomLeft - clampedRadii.bottomRight;
 
                 SDL_FRect line = { starting_x, starting_y, length, (float)config->width.bottom };
-                SDL_SetRenderDrawColor(rendererData->renderer, config->color.r, config->color.g, config->color.b, config->color.a);
-                SDL_RenderFillRect(rendererData->renderer, &line);
+                SDL_Clay_BatchFillRect(rendererData, line, config->color);
             }
 
             // corners
@@ -322,33 +535,35 @@ void SDL_Clay_RenderClayCommands(Clay_SDL3RendererData* rendererData, Clay_Rende
                 const float centerX = rect.x + clampedRadii.topLeft - 1;
                 const float centerY = rect.y + clampedRadii.topLeft - 1;
 
-                SDL_Clay_RenderArc(rendererData, (SDL_FPoint){ centerX, centerY }, clampedRadii.topLeft, 180.0f, 270.0f, config->width.top, config->color);
+                SDL_Clay_BatchArc(rendererData, { centerX, centerY }, clampedRadii.topLeft, 180.0f, config->width.top, config->color);
             }
 
             if(config->cornerRadius.topRight > 0) {
                 const float centerX = rect.x + rect.w - clampedRadii.topRight;
                 const float centerY = rect.y + clampedRadii.topRight - 1;
 
-                SDL_Clay_RenderArc(rendererData, (SDL_FPoint){ centerX, centerY }, clampedRadii.topRight, 270.0f, 360.0f, config->width.top, config->color);
+                SDL_Clay_BatchArc(rendererData, { centerX, centerY }, clampedRadii.topRight, 270.0f, config->width.top, config->color);
             }
 
             if(config->cornerRadius.bottomLeft > 0) {
                 const float centerX = rect.x + clampedRadii.bottomLeft - 1;
                 const float centerY = rect.y + rect.h - clampedRadii.bottomLeft;
 
-                SDL_Clay_RenderArc(rendererData, (SDL_FPoint){ centerX, centerY }, clampedRadii.bottomLeft, 90.0f, 180.0f, config->width.bottom, config->color);
+                SDL_Clay_BatchArc(rendererData, { centerX, centerY }, clampedRadii.bottomLeft, 90.0f, config->width.bottom, config->color);
             }
 
             if(config->cornerRadius.bottomRight > 0) {
                 const float centerX = rect.x + rect.w - clampedRadii.bottomRight;
                 const float centerY = rect.y + rect.h - clampedRadii.bottomRight;
 
-                SDL_Clay_RenderArc(rendererData, (SDL_FPoint){ centerX, centerY }, clampedRadii.bottomRight, 0.0f, 90.0f, config->width.bottom, config->color);
+                SDL_Clay_BatchArc(rendererData, { centerX, centerY }, clampedRadii.bottomRight, 0.0f, config->width.bottom, config->color);
             }
 
             break;
         }
         case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START: {
+            SDL_Clay_FlushGeometry(rendererData);
+
             Clay_BoundingBox boundingBox = rcmd->boundingBox;
             currentClippingRectangle     = SDL_Rect{
                     .x = (int)boundingBox.x,
@@ -361,14 +576,17 @@ void SDL_Clay_RenderClayCommands(Clay_SDL3RendererData* rendererData, Clay_Rende
             break;
         }
         case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END: {
+            SDL_Clay_FlushGeometry(rendererData);
             SDL_SetRenderClipRect(rendererData->renderer, NULL);
             break;
         }
         case CLAY_RENDER_COMMAND_TYPE_IMAGE: {
             SDL_Texture* texture = (SDL_Texture*)rcmd->renderData.image.imageData;
+            SDL_Clay_FlushGeometry(rendererData);
 
             const SDL_FRect dest = { rect.x, rect.y, rect.w, rect.h };
             SDL_RenderTexture(rendererData->renderer, texture, NULL, &dest);
+            rendererData->geometry.frame.textureDraws++;
 
             break;
         }
@@ -380,33 +598,12 @@ void SDL_Clay_RenderClayCommands(Clay_SDL3RendererData* rendererData, Clay_Rende
 
             switch(data->type) {
             case CUSTOM_ELEMENT_TYPE_CAMERA: {
-                SDL_SetRenderDrawBlendMode(rendererData->renderer, SDL_BLENDMODE_BLEND);
-                SDL_SetRenderDrawColor(rendererData->renderer, rcmd->renderData.custom.backgroundColor.r, rcmd->renderData.custom.backgroundColor.g, rcmd->renderData.custom.backgroundColor.b, rcmd->renderData.custom.backgroundColor.a);
-
-                SDL_RenderFillRect(rendererData->renderer, &rect);
-
-                SDL_Texture*& tex = data->camera.texture;
-                SDL_CameraSpec spec;
-
-                if(SDL_GetCameraPermissionState(data->camera.device) != 1 || !SDL_GetCameraFormat(data->camera.device, &spec)) {
-                    SDL_DestroyTexture(tex);
-                    tex = nullptr;
-
-                    break;
-                }
-
-                if(tex == nullptr || tex->format != spec.format || tex->w != spec.width || tex->h != spec.height) {
-                    SDL_DestroyTexture(tex);
-                    tex = SDL_CreateTexture(rendererData->renderer, spec.format, SDL_TEXTUREACCESS_STREAMING, spec.width, spec.height);
-                }
-
-                SDL_Surface* surface = SDL_AcquireCameraFrame(data->camera.device, nullptr);
-                if(surface != nullptr) {
-                    SDL_UpdateTexture(tex, NULL, surface->pixels, surface->pitch);
-                    SDL_ReleaseCameraFrame(data->camera.device, surface);
-                }
+                SDL_Clay_BatchFillRect(rendererData, rect, rcmd->renderData.custom.backgroundColor);
 
+                SDL_Texture* tex = data->camera.texture;
                 if(tex != nullptr) {
+                    SDL_Clay_FlushGeometry(rendererData);
+
                     float camAspect  = (float)tex->w / tex->h;
                     float dispAspect = rect.w / rect.h;
 
@@ -421,6 +618,7 @@ void SDL_Clay_RenderClayCommands(Clay_SDL3RendererData* rendererData, Clay_Rende
                     }
 
                     SDL_RenderTexture(rendererData->renderer, tex, NULL, &destRect);
+                    rendererData->geometry.frame.textureDraws++;
                 }
 
                 break;
@@ -438,4 +636,6 @@ void SDL_Clay_RenderClayCommands(Clay_SDL3RendererData* rendererData, Clay_Rende
         }
         }
     }
+
+    SDL_Clay_FlushGeometry(rendererData);
 }
\ No newline at end of file
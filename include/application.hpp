@@ -5,20 +5,35 @@
 #include <clay.h>
 
 #include <array>
+#include <atomic>
+#include <audio_sink.hpp>
+#include <audio_socket_server.hpp>
+#include <camera_stream.hpp>
 #include <chrono>
 #include <clay_renderer_SDL3.hpp>
-#include <functional>
+#include <event_dispatcher.hpp>
 #include <list>
 #include <memory>
+#include <mjpeg_http_server.hpp>
+#include <mjpeg_recorder.hpp>
 #include <mutex>
+#include <pipe_output.hpp>
+#include <raw_recorder.hpp>
+#include <replay_buffer.hpp>
+#include <screenshot_writer.hpp>
+#include <settings.hpp>
+#include <shm_exporter.hpp>
 #include <string>
-#include <unordered_map>
+#include <texture_pool.hpp>
+#include <tuple>
+#include <udp_audio.hpp>
+#include <upload_scheduler.hpp>
 #include <vector>
 
 class Application {
 public:
     // if true, keep event handler, else remove from handlers
-    using EventHandler = std::function<bool(SDL_Event* event, void* extraData)>;
+    using EventHandler = EventDispatcher::Handler;
 
     Application();
     virtual ~Application();
@@ -36,10 +51,48 @@ protected:
     void registerEventHandler(SDL_EventType type, const EventHandler& handler, void* extraData = nullptr);
 
 private:
+    enum class CameraSpecPreference {
+        BEST,
+        // smallest resolution and framerate, for thumbnails
+        CHEAPEST,
+        // smallest resolution that still fills its spot on screen, at the highest framerate
+        FIT_WINDOW
+    };
+
     void initCameras();
 
-    void openCamera();
-    void closeCamera();
+    // target is the size in pixels the camera is drawn at, only used by FIT_WINDOW
+    static bool pickCameraSpec(SDL_CameraID camID, CameraSpecPreference preference, const SDL_Point& target, SDL_CameraSpec* out);
+    std::unique_ptr<CameraStream> openCameraStream(SDL_CameraID camID, CameraSpecPreference preference, const SDL_Point& target = { 0, 0 });
+
+    void openCameras();
+    void closeCameras();
+
+    static CameraSpecPreference getDefaultCameraPreference();
+    // where the camera at index out of count ends up on screen in the current layout, in pixels
+    SDL_Point getCameraTargetSize(size_t index, size_t count);
+    // reopens the cameras whose spec no longer suits the window once its size has settled
+    void refitCameras();
+
+    // while the window cant be seen nothing is uploaded or rendered, audio keeps relaying as usual
+    void enterLowPower();
+    void leaveLowPower();
+
+    // makes id the primary stream, reusing it if its already open as a secondary
+    void selectPrimaryCamera(SDL_CameraID id);
+
+    // crops the black borders off the primary camera, or shows all of it again if it already is cropped
+    void toggleCrop();
+
+    // sinks follow the primary stream whenever the cameras are reopened or swapped
+    void addFrameSink(FrameSink* sink);
+    void removeFrameSink(FrameSink* sink);
+    void attachFrameSinks();
+
+    // the picker closes the regular streams and shows every camera at its cheapest spec until one is chosen
+    void openCameraPicker();
+    void closeCameraPicker(bool apply);
+    bool handleCameraPickerKey(SDL_Keycode key);
 
     void initAudioPlaybackDevices();
 
@@ -51,6 +104,52 @@ private:
     void openAudioRecordingDevice();
     void closeAudioRecordingDevice();
 
+    // sinks see the recorded audio in the relay format, called with the audio mutex held
+    void addAudioSink(AudioSink* sink);
+    void removeAudioSink(AudioSink* sink);
+
+    void startRecording();
+    void stopRecording();
+
+    // a single still of the newest primary frame, holding the key bursts every captured frame until its released
+    void takeScreenshot();
+    void startScreenshotBurst();
+    void stopScreenshotBurst();
+
+    // the replay buffer follows the primary camera and the recorded audio for as long as the app runs
+    void startReplayBuffer();
+    void stopReplayBuffer();
+    void saveReplay();
+
+    // publishing to other local processes, each one only runs if it's configured in the settings
+    void startExports();
+    void stopExports();
+
+    // time-shifting swaps the primary camera for frames out of the replay buffer until playback catches up with live
+    void toggleTimeShift();
+    void seekTimeShift(Sint64 offsetNS);
+    void catchUpTimeShift();
+    void exitTimeShift();
+    void updateTimeShift();
+    // called from the playback callback with m_audioMutex held, which keeps m_replay from going away meanwhile
+    void playTimeShiftAudio(SDL_AudioStream* stream, int amount);
+
+    // collects what the overlay would show this frame, true if it differs from when it was last laid out
+    bool updateOverlayInputs();
+    // the whole ui, only laid out again when the overlay inputs changed
+    Clay_RenderCommandArray buildLayout();
+    // everything after the last camera is drawn into the overlay texture and reused until the layout changes
+    void renderOverlay();
+
+    void layoutCameraGrid();
+    void layoutPictureInPicture();
+    void layoutCameraPicker();
+    void layoutStats();
+    void layoutTimeShift();
+
+    std::string collectStats();
+    std::string getTimeShiftText();
+
     void changeStatus(std::string text, std::chrono::milliseconds timeToExpire);
     void updateVolume();
 
@@ -65,6 +164,8 @@ private:
 
     static Uint32 onStatusStepCallback(void* userdata, SDL_TimerID timerID, Uint32 interval);
 
+    static void onClayError(Clay_ErrorData errorData);
+
 private:
     bool m_shouldQuit;
 
@@ -78,6 +179,7 @@ private:
     static constexpr size_t maxAudioBuffers    = 64;
 
     std::list<std::array<Uint16, audioBufferSize>> m_audioBuffers;
+    std::vector<AudioSink*> m_audioSinks;
 
     struct {
         std::string text = "";
@@ -118,9 +220,127 @@ private:
     std::vector<SDL_AudioDeviceID> m_playbackDevices;
     std::vector<SDL_AudioDeviceID> m_recordingDevices;
 
-    std::shared_ptr<CustomElementData> m_cameraData;
+    // declared before every stream so it outlives them
+    TexturePool m_texturePool;
+
+    // first stream is the primary one, the rest are only open in the grid and picture in picture layouts
+    std::vector<std::unique_ptr<CameraStream>> m_streams;
+    UploadScheduler m_uploadScheduler;
+
+    CameraSpecPreference m_cameraPreference = getDefaultCameraPreference();
+
+    struct {
+        // when the window or layout last changed, 0 once the cameras have been refitted
+        Uint64 changedNS   = 0;
+        Uint64 lastRefitNS = 0;
+    } m_cameraFit;
+
+    struct {
+        bool active         = false;
+        bool camerasPaused  = false;
+        bool camerasReduced = false;
+    } m_lowPower;
+
+    std::vector<FrameSink*> m_frameSinks;
+    // MJPG cameras are recorded as is together with the audio, anything else goes to the raw recorder
+    std::unique_ptr<RawRecorder> m_recorder;
+    std::unique_ptr<MjpegRecorder> m_mjpegRecorder;
+
+    // only changes on the main thread, with m_audioMutex held since the playback callback reads it too
+    std::unique_ptr<ReplayBuffer> m_replay;
+    ScreenshotWriter m_screenshots;
+    // pushed by the screenshot writer once a single screenshot is written, code is 1 if it was saved
+    Uint32 m_screenshotEvent = 0;
+
+    std::unique_ptr<ShmExporter> m_shmExporter;
+    std::unique_ptr<AudioSocketServer> m_audioSocket;
+    std::unique_ptr<PipeOutput> m_pipeOutput;
+    std::unique_ptr<MjpegHttpServer> m_httpPreview;
+    std::unique_ptr<UdpAudioSender> m_udpAudioSender;
+    // replaces the local recording in the playback callback while set, only changed with the audio mutex held
+    std::unique_ptr<UdpAudioReceiver> m_udpAudioReceiver;
+
+    struct {
+        // read by the audio callback
+        std::atomic<bool> active     = false;
+        std::atomic<bool> playing    = false;
+        std::atomic<bool> catchingUp = false;
+
+        // position on the capture clock, advanced by the audio callback at 1x and by update() while catching up
+        std::atomic<Uint64> positionNS = 0;
+        Uint64 lastUpdateNS            = 0;
+
+        FramePtr frame;
+        CustomElementData elementData = { .type = CUSTOM_ELEMENT_TYPE_CAMERA, .camera = { nullptr } };
+    } m_timeShift;
+
+    bool m_showStats = false;
+
+    struct {
+        bool open       = false;
+        size_t selected = 0;
+
+        std::vector<std::unique_ptr<CameraStream>> streams;
+    } m_picker;
+
+    // everything the layout depends on besides the camera images, which are only looked up when drawing
+    struct OverlayInputs {
+        int width  = 0;
+        int height = 0;
+
+        CameraLayout layout   = CameraLayout::SINGLE;
+        bool pickerOpen       = false;
+        size_t pickerSelected = 0;
+        bool timeShiftActive  = false;
+        bool showStats        = false;
+
+        std::string statusText;
+        float statusProgress = 0.0f;
+        // the status is positioned by its size in the previous layout
+        float statusHeight = 0.0f;
+
+        std::string statsText;
+        std::string timeShiftText;
+
+        // element data of every camera shown and the size of its texture, picture in picture is sized by it
+        std::vector<std::tuple<const CustomElementData*, int, int>> cameras;
+
+        bool operator==(const OverlayInputs&) const = default;
+    };
+
+    struct {
+        // next is refilled every frame and swapped in when it differs, so neither allocates once they are grown
+        OverlayInputs inputs;
+        OverlayInputs next;
+
+        // lay out again even if the inputs match, the pointer moved or the render targets were lost
+        bool dirty = true;
+        // the texture doesnt show the current commands yet
+        bool stale = true;
+
+        // premultiplied, so it blends the same as drawing the commands straight to the window
+        SDL_Texture* texture = nullptr;
+
+        // stays valid in the clay arena until the next layout. the commands before split are drawn every frame
+        // since cameras are among them
+        Clay_RenderCommandArray commands = {};
+        int32_t split                    = 0;
+
+        Uint64 layouts = 0;
+        Uint64 reuses  = 0;
+    } m_overlay;
+
+    struct {
+        // sized for the element and word counts in the settings, clays context lives in it until it's freed last
+        void* memory = nullptr;
+        size_t size  = 0;
+
+        // set by the error handler when a layout ran out of measured words, the layout is redone with an empty cache
+        bool measureCacheFull     = false;
+        Uint64 measureCacheResets = 0;
+    } m_clay;
 
-    std::unordered_map<SDL_EventType, std::vector<std::pair<EventHandler, void*>>> m_eventHandlers;
+    EventDispatcher m_eventHandlers;
 };
 
 #endif
\ No newline at end of file
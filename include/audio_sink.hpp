@@ -0,0 +1,15 @@
+#ifndef __AUDIO_SINK_HPP__
+#define __AUDIO_SINK_HPP__
+
+#include <SDL3/SDL.h>
+
+class AudioSink {
+public:
+    virtual ~AudioSink() = default;
+
+    // called from the audio recording callback with the relay format (S16, 2 channels, 48kHz), must not block.
+    // timestampNS is when the first sample was recorded, on the same clock as camera frames (SDL_GetTicksNS)
+    virtual void onAudio(const Uint8* data, size_t size, Uint64 timestampNS) = 0;
+};
+
+#endif
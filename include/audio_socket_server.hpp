@@ -0,0 +1,87 @@
+#ifndef __AUDIO_SOCKET_SERVER_HPP__
+#define __AUDIO_SOCKET_SERVER_HPP__
+
+#include <atomic>
+#include <audio_sink.hpp>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <pcm_ring.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+// streams the relayed audio with the playback volume applied to every client of a unix socket, as raw S16LE 2 channel
+// 48kHz PCM with no header. the audio callback only copies into a lock free ring, the server thread does everything else.
+// every client has its own bounded queue and loses its oldest audio when it falls behind, so a stalled one only hurts itself
+class AudioSocketServer : public AudioSink {
+public:
+    struct Stats {
+        size_t clients;
+        Uint64 bytesSent;
+        // chunks thrown away because a client couldnt keep up
+        Uint64 chunksDropped;
+        // audio the server thread didnt get to in time, lost for every client
+        Uint64 bytesOverrun;
+        // the ring between the audio callback and the server thread
+        size_t ringBytes;
+    };
+
+    // audio is handed to clients in chunks of this length, and each one may fall this many chunks behind
+    static constexpr Uint64 chunkDurationMS = 10;
+    static constexpr size_t maxQueuedChunks = 25;
+
+    AudioSocketServer();
+    ~AudioSocketServer();
+
+    bool start(const std::string& path);
+    void stop();
+
+    bool isRunning() const;
+    const std::string& getPath() const;
+
+    // linear gain, same as the playback stream's
+    void setGain(float gain);
+
+    void onAudio(const Uint8* data, size_t size, Uint64 timestampNS) override;
+
+    Stats getStats();
+
+private:
+    using Chunk = std::vector<Uint8>;
+
+    struct Client {
+        int fd;
+        std::deque<std::shared_ptr<const Chunk>> queue;
+        // bytes of the front chunk already sent, chunks are only dropped whole so the stream stays frame aligned
+        size_t offset = 0;
+    };
+
+    void serverThread();
+    void acceptClients();
+    void queueChunk(const std::shared_ptr<const Chunk>& chunk);
+    // false once the client is gone
+    bool sendQueued(Client& client);
+
+private:
+    static constexpr size_t bytesPerSecond = 48000 * 2 * sizeof(Sint16);
+    static constexpr size_t chunkSize      = bytesPerSecond * chunkDurationMS / 1000;
+
+    std::string m_path;
+    int m_listenFD = -1;
+
+    PcmRing m_ring;
+    std::atomic<float> m_gain;
+    std::atomic<Uint64> m_bytesOverrun;
+
+    // server thread only, apart from the stats
+    std::mutex m_statsMutex;
+    std::vector<Client> m_clients;
+    Uint64 m_bytesSent     = 0;
+    Uint64 m_chunksDropped = 0;
+
+    std::atomic<bool> m_running;
+    std::thread m_thread;
+};
+
+#endif
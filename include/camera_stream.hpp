@@ -0,0 +1,109 @@
+#ifndef __CAMERA_STREAM_HPP__
+#define __CAMERA_STREAM_HPP__
+
+#include <atomic>
+#include <clay_renderer_SDL3.hpp>
+#include <deinterlacer.hpp>
+#include <frame.hpp>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <texture_pool.hpp>
+#include <thread>
+#include <vector>
+
+// an open camera with its own capture thread, frames are copied out of SDL as soon as they arrive and handed to the sinks,
+// the newest one is kept for the render thread to upload into this streams texture
+class CameraStream {
+public:
+    struct UploadStats {
+        // totals since the stream was opened
+        Uint64 uploadedBytes;
+        Uint64 skippedBytes;
+    };
+
+    // textures come from and go back to texturePool, which has to outlive the stream
+    CameraStream(SDL_CameraID id, const SDL_CameraSpec& spec, TexturePool* texturePool);
+    ~CameraStream();
+
+    bool isOpen() const;
+
+    SDL_CameraID getID() const;
+    SDL_Camera* getDevice() const;
+    const SDL_CameraSpec& getSpec() const;
+
+    void addSink(FrameSink* sink);
+    void removeSink(FrameSink* sink);
+
+    FramePtr getLatestFrame();
+    // frames captured per second, updated about once a second
+    float getFrameRate() const;
+
+    // bytes that the next upload() would send, 0 if the texture is already up to date
+    size_t getPendingBytes();
+
+    // render thread only, uploads the newest frame that hasnt been uploaded yet and returns how many bytes it sent.
+    // only the tiles that changed since the last upload are sent, nothing at all if the picture is the same
+    size_t upload();
+    UploadStats getUploadStats() const;
+
+    // only this part of each frame is uploaded and shown, sinks still get whole frames. render thread only
+    void setCrop(const std::optional<SDL_FRect>& crop);
+    const std::optional<SDL_FRect>& getCrop() const;
+
+    CustomElementData* getElementData();
+
+    Deinterlacer& getDeinterlacer();
+
+private:
+    void captureThread();
+    // makes frame the latest one for uploading, a deinterlaced field or the captured frame itself
+    void showFrame(const FramePtr& frame);
+    size_t uploadTiles(SDL_Texture* texture, const Frame& frame, const SDL_Rect& region);
+
+private:
+    SDL_CameraID m_id;
+    SDL_Camera* m_device = nullptr;
+    SDL_CameraSpec m_spec;
+
+    TexturePool* m_texturePool;
+
+    std::shared_ptr<FramePool> m_framePool;
+
+    std::mutex m_frameMutex;
+    FramePtr m_latestFrame;
+    FramePtr m_pendingFrame;
+
+    // tiles that changed since the last upload, merged over every frame the render thread skipped.
+    // a full upload is needed after a format change, a new texture or for formats that cant be split into tiles
+    std::vector<Uint8> m_pendingTiles;
+    size_t m_pendingDirtyTiles = 0;
+    bool m_pendingFull         = true;
+
+    // capture thread only
+    std::vector<Uint8> m_frameTiles;
+
+    // render thread only
+    std::vector<Uint8> m_uploadTiles;
+    Uint64 m_uploadedBytes = 0;
+    Uint64 m_skippedBytes  = 0;
+    std::optional<SDL_FRect> m_crop;
+
+    std::mutex m_sinkMutex;
+    std::vector<FrameSink*> m_sinks;
+
+    std::atomic<bool> m_running;
+    std::thread m_thread;
+
+    // runs on the capture thread for what is shown, the second field of a frame is held back until half a frame later
+    Deinterlacer m_deinterlacer;
+    FramePtr m_deferredFrame;
+    Uint64 m_deferredDueNS = 0;
+
+    Uint64 m_sequence = 0;
+    std::atomic<float> m_frameRate;
+
+    CustomElementData m_elementData;
+};
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef __CROP_HPP__
+#define __CROP_HPP__
+
+#include <frame.hpp>
+#include <optional>
+
+// crops are kept as fractions of the frame size so they still fit after the camera switches modes.
+// only formats that can be uploaded in parts can be cropped, anything else is always shown whole
+bool isCropSupported(SDL_PixelFormat format);
+
+// pixels of frame inside crop, aligned to whole chroma samples. the whole frame without a crop or when it cant be cropped
+SDL_Rect getCropRect(const Frame& frame, const std::optional<SDL_FRect>& crop);
+
+// uploads the source rect of frame into destination of texture, null for all of it. returns the bytes sent
+size_t updateTextureRegion(SDL_Texture* texture, const Frame& frame, const SDL_Rect& source, const SDL_Rect* destination);
+
+// finds the black borders around the picture, false if there are none or the whole frame is dark
+bool detectCrop(const Frame& frame, SDL_FRect* out);
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef __DEINTERLACER_HPP__
+#define __DEINTERLACER_HPP__
+
+#include <atomic>
+#include <frame.hpp>
+#include <settings.hpp>
+
+// turns woven interlaced frames into progressive ones on the capture thread, packed 4:2:2 and NV12/NV21 only.
+// bob and adaptive output one frame per field, so a 1080i source at 30 woven frames per second comes out as 1080p60
+class Deinterlacer {
+public:
+    struct Stats {
+        DeinterlaceMode mode;
+        Uint64 frames;
+
+        double lastMS;
+        double averageMS;
+        double maxMS;
+    };
+
+    Deinterlacer();
+
+    void setMode(DeinterlaceMode mode);
+    DeinterlaceMode getMode() const;
+
+    void setTopFieldFirst(bool topFieldFirst);
+
+    static bool isSupported(SDL_PixelFormat format);
+
+    // writes the progressive frames for frame into out in display order, returns how many there are.
+    // 0 means frame should be shown as is
+    int process(const FramePtr& frame, FramePool& pool, FramePtr out[2]);
+
+    Stats getStats() const;
+
+private:
+    void buildField(const Frame& frame, const Frame* previous, int parity, Frame& out);
+
+private:
+    std::atomic<DeinterlaceMode> m_mode;
+    std::atomic<bool> m_topFieldFirst;
+
+    // adaptive mode compares against the last input frame to find motion
+    FramePtr m_previous;
+
+    std::atomic<Uint64> m_frames;
+    std::atomic<Uint64> m_lastNS;
+    std::atomic<Uint64> m_totalNS;
+    std::atomic<Uint64> m_maxNS;
+};
+
+#endif
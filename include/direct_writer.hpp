@@ -0,0 +1,79 @@
+#ifndef __DIRECT_WRITER_HPP__
+#define __DIRECT_WRITER_HPP__
+
+#include <SDL3/SDL.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <worker_pool.hpp>
+
+#ifdef HAVE_LIBURING
+#include <liburing.h>
+#endif
+
+// asynchronous positional writes to a file opened with O_DIRECT, submitted through io_uring when it is available and
+// a small pwrite thread pool otherwise. only meant to be driven from a single thread
+class DirectWriter {
+public:
+    // buffers, sizes and offsets passed to write() have to be multiples of this
+    static constexpr size_t alignment = 4096;
+
+    DirectWriter(size_t queueDepth = 16);
+    ~DirectWriter();
+
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const;
+    // false if the filesystem refused O_DIRECT (e.g. tmpfs) and the page cache is used instead
+    bool isDirect() const;
+    bool isUsingUring() const;
+
+    // keepAlive is held until the write has completed, waits while queueDepth writes are already in flight
+    void write(const void* data, size_t size, Uint64 offset, std::shared_ptr<void> keepAlive);
+    // waits for every submitted write to complete
+    void flush();
+
+    Uint64 getBytesWritten() const;
+    Uint64 getWriteErrors() const;
+    size_t getInFlight() const;
+
+private:
+    struct Request {
+        const Uint8* data;
+        size_t size;
+        Uint64 offset;
+
+        std::shared_ptr<void> keepAlive;
+    };
+
+    // how much of a short write to skip before retrying the rest, rounded down to a block under O_DIRECT so the retry
+    // stays aligned (the bytes past it are written again)
+    size_t getResumableSize(size_t written) const;
+    void writeBlocking(Request* request);
+
+#ifdef HAVE_LIBURING
+    bool submitUring(Request* request);
+    void reapUring(bool wait);
+#endif
+
+private:
+    int m_fd      = -1;
+    bool m_direct = false;
+
+    size_t m_queueDepth;
+    std::atomic<size_t> m_inFlight;
+
+    std::atomic<Uint64> m_bytesWritten;
+    std::atomic<Uint64> m_writeErrors;
+
+#ifdef HAVE_LIBURING
+    struct io_uring m_ring;
+    bool m_uring = false;
+#endif
+
+    std::unique_ptr<WorkerPool> m_pool;
+};
+
+#endif
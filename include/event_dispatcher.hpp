@@ -0,0 +1,62 @@
+#ifndef __EVENT_DISPATCHER_HPP__
+#define __EVENT_DISPATCHER_HPP__
+
+#include <SDL3/SDL.h>
+
+#include <array>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// calls the handlers registered for an event type without hashing, copying or allocating. the high byte of the type
+// picks a page and the low byte the slot in it, SDL numbers related events within the same 256 so a handful of pages
+// covers everything. every handler lives in one array grouped by slot, and anything that would move them while they
+// are being called waits until the outermost dispatch returns
+class EventDispatcher {
+public:
+    // if true, keep the handler, else remove it
+    using Handler = std::function<bool(SDL_Event* event, void* extraData)>;
+
+    EventDispatcher();
+
+    // a handler added from inside another one sees the events after the current one
+    void add(Uint32 type, const Handler& handler, void* extraData = nullptr);
+    void dispatch(SDL_Event* event);
+
+private:
+    struct Entry {
+        Handler handler;
+        void* extraData;
+        Uint8 slot;
+        // returned false, skipped until the entries are compacted
+        bool removed;
+    };
+
+    struct Slot {
+        Uint32 first;
+        Uint32 count;
+    };
+
+    // 0 if nothing was ever registered for the type, else its index in m_slots + 1
+    Uint8 getSlot(Uint32 type) const;
+    void insert(Uint32 type, Entry&& entry);
+    // drops the removed entries and adds the ones registered while dispatching
+    void flush();
+
+private:
+    // slots are stored in a byte, 0 meaning none
+    static constexpr size_t maxSlots = 255;
+
+    // per high byte of the type, 0 or the index in m_pages + 1
+    std::array<Uint8, 256> m_pageIndices;
+    std::vector<std::array<Uint8, 256>> m_pages;
+
+    std::vector<Slot> m_slots;
+    std::vector<Entry> m_entries;
+
+    std::vector<std::pair<Uint32, Entry>> m_pending;
+    int m_depth    = 0;
+    bool m_removed = false;
+};
+
+#endif
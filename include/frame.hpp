@@ -0,0 +1,68 @@
+#ifndef __FRAME_HPP__
+#define __FRAME_HPP__
+
+#include <SDL3/SDL.h>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// a copy of a single camera frame, owned by a FramePool and shared between the capture thread, the renderer and any sinks
+struct Frame {
+    SDL_PixelFormat format;
+
+    int width;
+    int height;
+    int pitch;
+
+    // bytes of valid data in pixels, includes every plane
+    size_t size;
+    size_t capacity;
+    Uint8* pixels;
+
+    Uint64 timestampNS;
+    Uint64 sequence;
+};
+
+using FramePtr = std::shared_ptr<Frame>;
+
+// size in bytes of a frame with all of its planes, compressed formats report their payload length through pitch
+size_t getFrameSize(SDL_PixelFormat format, int height, int pitch);
+
+class FramePool : public std::enable_shared_from_this<FramePool> {
+public:
+    static std::shared_ptr<FramePool> create(size_t maxFreeFrames = 8);
+    ~FramePool();
+
+    // returned frame goes back to the pool when its last reference is dropped, even if that happens on another thread
+    FramePtr acquire(size_t size);
+
+    size_t getAllocatedBytes();
+
+public:
+    // page aligned and padded so frames can be handed straight to O_DIRECT writes
+    static constexpr size_t frameAlignment = 4096;
+
+private:
+    FramePool(size_t maxFreeFrames);
+
+    void release(Frame* frame);
+    static void destroyFrame(Frame* frame);
+
+private:
+    std::mutex m_mutex;
+    std::vector<Frame*> m_freeFrames;
+
+    size_t m_maxFreeFrames;
+    size_t m_allocatedBytes = 0;
+};
+
+class FrameSink {
+public:
+    virtual ~FrameSink() = default;
+
+    // called on the capture thread for every frame, must not block
+    virtual void onFrame(const FramePtr& frame) = 0;
+};
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef __FRAME_CODEC_HPP__
+#define __FRAME_CODEC_HPP__
+
+#include <SDL3/SDL.h>
+
+// fast lossless codec for raw frames, every byte is predicted from the one a row above (pitch bytes back) and the
+// residual is run length encoded. static and flat areas like desktop captures shrink a lot, sensor noise mostly stays raw.
+// works on any uncompressed format since it never looks at the pixels themselves, planes are just more rows
+size_t getMaxEncodedSize(size_t size);
+
+// returns the encoded size, or 0 if the frame didnt get smaller and should be stored as is
+size_t encodeFrame(const Uint8* pixels, size_t size, size_t pitch, Uint8* out);
+// never reads or writes outside data and out whatever data holds, the replay buffer decodes entries that may be
+// overwritten while they are read and throws the result away afterwards
+bool decodeFrame(const Uint8* data, size_t dataSize, size_t pitch, Uint8* out, size_t size);
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef __MATROSKA_WRITER_HPP__
+#define __MATROSKA_WRITER_HPP__
+
+#include <SDL3/SDL.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// minimal streaming Matroska muxer, one video track and an optional PCM audio track.
+// clusters are built in memory and written as they fill up, cues and the seek head are filled in on close
+class MatroskaWriter {
+public:
+    struct VideoTrack {
+        // e.g. V_MJPEG, or V_UNCOMPRESSED together with a fourcc
+        std::string codecID;
+        Uint32 fourcc;
+
+        int width;
+        int height;
+    };
+
+    struct AudioTrack {
+        int sampleRate;
+        int channels;
+        int bitDepth;
+    };
+
+    MatroskaWriter();
+    ~MatroskaWriter();
+
+    bool open(const std::string& path, const VideoTrack& video, const AudioTrack* audio);
+    void close();
+
+    bool isOpen() const;
+
+    // timestamps are relative to the start of the file, blocks should be written in roughly increasing order
+    void writeVideo(const Uint8* data, size_t size, Uint64 timestampNS, bool keyframe = true);
+    void writeAudio(const Uint8* data, size_t size, Uint64 timestampNS);
+
+    Uint64 getBytesWritten() const;
+
+private:
+    void writeBlock(Uint8 track, const Uint8* data, size_t size, Uint64 timestampNS, bool keyframe);
+    void flushCluster();
+
+    void writeRaw(const void* data, size_t size);
+
+private:
+    struct CuePoint {
+        Uint64 timestampMS;
+        Uint64 clusterPosition;
+    };
+
+    FILE* m_file = nullptr;
+    bool m_hasAudio;
+
+    // file offsets of the parts that are patched on close
+    Uint64 m_segmentSizePosition;
+    Uint64 m_segmentDataPosition;
+    Uint64 m_seekHeadPosition;
+    Uint64 m_durationPosition;
+    Uint64 m_infoPosition;
+    Uint64 m_tracksPosition;
+
+    Uint64 m_position;
+    Uint64 m_lastTimestampMS;
+
+    std::vector<Uint8> m_cluster;
+    Uint64 m_clusterTimestampMS;
+    bool m_clusterHasKeyframe;
+
+    std::vector<CuePoint> m_cues;
+};
+
+#endif
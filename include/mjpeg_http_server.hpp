@@ -0,0 +1,123 @@
+#ifndef __MJPEG_HTTP_SERVER_HPP__
+#define __MJPEG_HTTP_SERVER_HPP__
+
+#include <atomic>
+#include <frame.hpp>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <worker_pool.hpp>
+
+// serves the primary camera as multipart/x-mixed-replace MJPEG over http, which browsers and most players show as a live
+// picture. mjpg frames are forwarded as the jpegs they already are, anything else is encoded on a small worker pool at
+// a capped rate, and only while someone is watching. one epoll thread handles every connection, each client has a
+// mailbox holding only the latest frame it hasnt started sending yet, so a slow one skips frames instead of buffering
+class MjpegHttpServer : public FrameSink {
+public:
+    struct Stats {
+        size_t clients;
+        Uint64 framesSent;
+        // replaced in a clients mailbox by a newer one before it was sent
+        Uint64 framesDropped;
+        Uint64 bytesSent;
+
+        Uint64 framesPassedThrough;
+        Uint64 framesEncoded;
+        // not encoded because the workers were still busy with earlier ones
+        Uint64 framesSkipped;
+        double averageEncodeMS;
+    };
+
+    MjpegHttpServer(size_t encodeThreads = 2);
+    ~MjpegHttpServer();
+
+    // maxEncodeFPS only limits frames that have to be encoded, quality is 0 to 100
+    bool start(const std::string& address, Uint16 port, int maxEncodeFPS, int quality);
+    void stop();
+
+    bool isRunning() const;
+    const std::string& getAddress() const;
+    Uint16 getPort() const;
+
+    void onFrame(const FramePtr& frame) override;
+
+    Stats getStats();
+
+private:
+    struct Jpeg {
+        // passed through frames keep their camera frame alive instead of being copied
+        FramePtr frame;
+        std::vector<Uint8> encoded;
+
+        const Uint8* data;
+        size_t size;
+        Uint64 sequence;
+    };
+
+    using JpegPtr = std::shared_ptr<const Jpeg>;
+
+    struct Client {
+        int fd;
+        std::string request;
+        bool streaming = false;
+
+        // what is being sent right now: a header, optionally followed by a jpeg and the line ending the part
+        std::string header;
+        JpegPtr body;
+        size_t offset = 0;
+        bool closeWhenSent = false;
+
+        // latest frame that hasnt been started yet
+        JpegPtr mailbox;
+    };
+
+    void encode(const FramePtr& frame);
+    void publish(const JpegPtr& jpeg);
+
+    void serverThread();
+    void acceptClients();
+    // false once the client should be closed
+    bool readRequest(Client& client);
+    bool flush(Client& client);
+    void deliver(const JpegPtr& jpeg);
+    void closeClient(int fd);
+
+private:
+    std::string m_address;
+    Uint16 m_port             = 0;
+    int m_quality             = 75;
+    Uint64 m_encodeIntervalNS = 0;
+
+    int m_listenFD = -1;
+    int m_epollFD  = -1;
+    // written whenever a new jpeg is published, wakes the server thread
+    int m_eventFD = -1;
+
+    std::mutex m_latestMutex;
+    JpegPtr m_latest;
+
+    // server thread only
+    std::unordered_map<int, Client> m_clients;
+    Uint64 m_deliveredSequence = 0;
+
+    std::atomic<size_t> m_clientCount;
+    std::atomic<Uint64> m_lastEncodeNS;
+    std::atomic<Uint64> m_framesSent;
+    std::atomic<Uint64> m_framesDropped;
+    std::atomic<Uint64> m_bytesSent;
+    std::atomic<Uint64> m_framesPassedThrough;
+    std::atomic<Uint64> m_framesEncoded;
+    std::atomic<Uint64> m_framesSkipped;
+    std::atomic<Uint64> m_encodeNS;
+
+    std::atomic<bool> m_running;
+    std::thread m_thread;
+
+    // declared last so queued encodes finish before the rest is torn down
+    WorkerPool m_pool;
+};
+
+#endif
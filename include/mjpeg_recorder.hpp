@@ -0,0 +1,95 @@
+#ifndef __MJPEG_RECORDER_HPP__
+#define __MJPEG_RECORDER_HPP__
+
+#include <audio_sink.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <frame.hpp>
+#include <matroska_writer.hpp>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// writes the compressed frames of an MJPG camera untouched, muxed with the relay audio into a Matroska file.
+// both sinks only queue, a writer thread interleaves the two queues by timestamp
+class MjpegRecorder : public FrameSink, public AudioSink {
+public:
+    struct Stats {
+        Uint64 framesWritten;
+        Uint64 framesDropped;
+        Uint64 audioPacketsWritten;
+        // packets dropped because the writer fell behind, each one is a gap of packetDurationMS
+        Uint64 audioPacketsDropped;
+        Uint64 bytesWritten;
+
+        size_t queuedFrames;
+        size_t queuedAudioPackets;
+    };
+
+    // audio is cut into packets of this length before it is queued
+    static constexpr Uint64 packetDurationMS = 20;
+
+    MjpegRecorder(size_t maxQueuedFrames = 32, size_t maxQueuedAudioPackets = 128);
+    ~MjpegRecorder();
+
+    bool start(const std::string& path, int width, int height);
+    void stop();
+
+    bool isRecording() const;
+    const std::string& getPath() const;
+
+    void onFrame(const FramePtr& frame) override;
+    void onAudio(const Uint8* data, size_t size, Uint64 timestampNS) override;
+
+    Stats getStats();
+
+private:
+    struct AudioPacket {
+        std::vector<Uint8> data;
+        Uint64 timestampNS;
+    };
+
+    void writerThread();
+
+private:
+    static constexpr int sampleRate = 48000;
+    static constexpr int channels   = 2;
+    static constexpr int bitDepth   = 16;
+
+    static constexpr size_t bytesPerSecond = sampleRate * channels * (bitDepth / 8);
+    static constexpr size_t packetSize     = bytesPerSecond * packetDurationMS / 1000;
+
+    // how long the writer waits for the other stream before writing a block out of order
+    static constexpr Uint64 maxInterleaveDelayNS = 200 * 1000000ull;
+
+    std::string m_path;
+    MatroskaWriter m_writer;
+
+    // every timestamp in the file is relative to this, taken from SDL_GetTicksNS when the recording starts
+    Uint64 m_startNS;
+
+    std::mutex m_queueMutex;
+    std::condition_variable m_queueCondition;
+    std::deque<FramePtr> m_frames;
+    std::deque<AudioPacket> m_audioPackets;
+
+    // packets are preallocated so the audio callback never allocates
+    std::vector<std::vector<Uint8>> m_freeAudioBuffers;
+    AudioPacket m_pendingAudio;
+
+    size_t m_maxQueuedFrames;
+    size_t m_maxQueuedAudioPackets;
+
+    Uint64 m_framesDropped       = 0;
+    Uint64 m_framesWritten       = 0;
+    Uint64 m_audioPacketsDropped = 0;
+    Uint64 m_audioPacketsWritten = 0;
+    Uint64 m_bytesWritten        = 0;
+
+    bool m_recording = false;
+    std::thread m_thread;
+};
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef __PCM_RING_HPP__
+#define __PCM_RING_HPP__
+
+#include <SDL3/SDL.h>
+
+#include <atomic>
+#include <vector>
+
+// lock free single producer single consumer byte ring, writing never blocks or allocates so the producer can be the
+// audio callback. capacity is rounded up to a power of two
+class PcmRing {
+public:
+    PcmRing(size_t capacity);
+
+    // all or nothing, false if there isnt room for size bytes
+    bool write(const Uint8* data, size_t size);
+    // reads up to size bytes, returns how many it got
+    size_t read(Uint8* out, size_t size);
+
+    size_t getAvailable() const;
+    size_t getCapacity() const;
+
+private:
+    std::vector<Uint8> m_buffer;
+    size_t m_mask;
+
+    // on separate cache lines so producer and consumer dont fight over one
+    alignas(64) std::atomic<size_t> m_writePosition;
+    alignas(64) std::atomic<size_t> m_readPosition;
+};
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef __PIPE_OUTPUT_HPP__
+#define __PIPE_OUTPUT_HPP__
+
+#include <atomic>
+#include <audio_sink.hpp>
+#include <condition_variable>
+#include <frame.hpp>
+#include <mutex>
+#include <pcm_ring.hpp>
+#include <settings.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+// writes the primary cameras frames as raw video and the relayed audio as raw S16LE 2 channel 48kHz PCM into two named
+// pipes (or video to stdout), for something like `ffmpeg -f rawvideo ... -i fifo` to encode while we keep displaying.
+// each pipe has its own writer thread so a reader that only drains one of them cant stall the other. the capture thread
+// and the audio callback never block: frames go into a fixed size queue and audio into a lock free ring, and whatever
+// doesnt fit while the reader is behind is dropped according to the PipeFullPolicy
+class PipeOutput : public FrameSink, public AudioSink {
+public:
+    struct Stats {
+        bool videoConnected;
+        Uint64 framesWritten;
+        // lost because the reader fell behind
+        Uint64 framesDropped;
+        // different format or size than the frames already written, rawvideo readers cant follow a change
+        Uint64 framesSkipped;
+        Uint64 videoBytesWritten;
+
+        bool audioConnected;
+        Uint64 audioBytesWritten;
+        Uint64 audioBytesDropped;
+        size_t audioRingBytes;
+    };
+
+    PipeOutput(PipeFullPolicy policy, size_t maxQueuedFrames = 8);
+    ~PipeOutput();
+
+    // either path may be empty, a video path of "-" writes to stdout. missing paths are created as fifos
+    bool start(const std::string& videoPath, const std::string& audioPath);
+    void stop();
+
+    bool isRunning() const;
+
+    void onFrame(const FramePtr& frame) override;
+    void onAudio(const Uint8* data, size_t size, Uint64 timestampNS) override;
+
+    Stats getStats();
+
+private:
+    void videoThread();
+    void audioThread();
+
+    // blocks until a reader opened the pipe or we are stopped, -1 in the latter case
+    int openPipe(const std::string& path);
+    // false if the reader went away or we are stopped before everything was written
+    bool writeAll(int fd, const Uint8* data, size_t size);
+
+private:
+    PipeFullPolicy m_policy;
+
+    std::string m_videoPath;
+    std::string m_audioPath;
+
+    // fixed size ring of queued frames, so queueing never allocates
+    std::mutex m_queueMutex;
+    std::condition_variable m_queueCondition;
+    std::vector<FramePtr> m_queue;
+    size_t m_queueHead  = 0;
+    size_t m_queueCount = 0;
+
+    Uint64 m_framesWritten     = 0;
+    Uint64 m_framesDropped     = 0;
+    Uint64 m_framesSkipped     = 0;
+    Uint64 m_videoBytesWritten = 0;
+    bool m_videoConnected      = false;
+
+    PcmRing m_audioRing;
+    std::atomic<Uint64> m_audioBytesWritten;
+    std::atomic<Uint64> m_audioBytesDropped;
+    std::atomic<bool> m_audioConnected;
+
+    std::atomic<bool> m_running;
+    std::thread m_videoThread;
+    std::thread m_audioThread;
+};
+
+#endif
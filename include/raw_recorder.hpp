@@ -0,0 +1,94 @@
+#ifndef __RAW_RECORDER_HPP__
+#define __RAW_RECORDER_HPP__
+
+#include <condition_variable>
+#include <deque>
+#include <direct_writer.hpp>
+#include <frame.hpp>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// .ccrv layout, every field little endian:
+//   [0, 4096)      RawRecordingHeader, rewritten with the index location when the recording is closed
+//   [4096, ...)    frame payloads exactly as captured, each padded to 4096 bytes
+//   [indexOffset)  frameCount RawRecordingIndexEntry structs
+struct RawRecordingHeader {
+    char magic[4];  // "CCRV"
+    Uint32 version;
+    Uint64 indexOffset;
+    Uint64 frameCount;
+};
+
+struct RawRecordingIndexEntry {
+    Uint64 offset;
+    Uint64 timestampNS;
+    Uint32 size;
+    Uint32 format;
+    Uint32 width;
+    Uint32 height;
+    Uint32 pitch;
+    Uint32 reserved;
+};
+
+// archives captured frames untouched, the capture thread only queues a reference and a writer thread feeds a DirectWriter
+class RawRecorder : public FrameSink {
+public:
+    struct Stats {
+        Uint64 framesWritten;
+        // frames dropped because the disk fell behind and the queue was full
+        Uint64 framesDropped;
+        Uint64 bytesWritten;
+        Uint64 writeErrors;
+
+        size_t queuedFrames;
+        size_t maxQueuedFrames;
+        size_t inFlightWrites;
+
+        bool direct;
+        bool uring;
+    };
+
+    RawRecorder(size_t maxQueuedFrames = 32);
+    ~RawRecorder();
+
+    bool start(const std::string& path);
+    void stop();
+
+    bool isRecording() const;
+    const std::string& getPath() const;
+
+    void onFrame(const FramePtr& frame) override;
+
+    Stats getStats();
+
+private:
+    void writerThread();
+    void writeIndex();
+
+private:
+    static constexpr Uint32 version = 1;
+
+    std::string m_path;
+    DirectWriter m_writer;
+
+    std::mutex m_queueMutex;
+    std::condition_variable m_queueCondition;
+    std::deque<FramePtr> m_queue;
+
+    size_t m_maxQueuedFrames;
+    size_t m_highWaterMark = 0;
+
+    Uint64 m_framesDropped = 0;
+    Uint64 m_framesWritten = 0;
+
+    bool m_recording = false;
+    std::thread m_thread;
+
+    // only touched by the writer thread
+    Uint64 m_offset = 0;
+    std::vector<RawRecordingIndexEntry> m_index;
+};
+
+#endif
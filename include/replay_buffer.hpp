@@ -0,0 +1,145 @@
+#ifndef __REPLAY_BUFFER_HPP__
+#define __REPLAY_BUFFER_HPP__
+
+#include <atomic>
+#include <audio_sink.hpp>
+#include <condition_variable>
+#include <deque>
+#include <frame.hpp>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// keeps the last few minutes of frames and audio in one preallocated ring arena for time-shifting and instant replays.
+// the sinks only queue, an ingest thread compresses raw frames with the frame codec and copies them into the arena,
+// evicting the oldest entries once the arena or the duration limit is full
+class ReplayBuffer : public FrameSink, public AudioSink {
+public:
+    struct Stats {
+        Uint64 framesStored;
+        // frames dropped because the ingest thread fell behind
+        Uint64 framesDropped;
+
+        size_t storedFrames;
+        Uint64 durationNS;
+
+        // arena bytes in use against what the same frames take uncompressed
+        size_t usedBytes;
+        size_t rawBytes;
+        size_t capacity;
+    };
+
+    ReplayBuffer(size_t capacity, Uint64 maxDurationNS, bool compress, size_t maxQueuedFrames = 8);
+    ~ReplayBuffer();
+
+    bool isValid() const;
+
+    void onFrame(const FramePtr& frame) override;
+    void onAudio(const Uint8* data, size_t size, Uint64 timestampNS) override;
+
+    // timestamps of the oldest and newest stored frame, 0 when empty
+    Uint64 getOldestTimestamp();
+    Uint64 getNewestTimestamp();
+
+    // newest frame at or before timestampNS, decoded into a pool frame.
+    // returns current without decoding again if that is still the frame to show
+    FramePtr getFrame(Uint64 timestampNS, const FramePtr& current = nullptr);
+
+    // fills size bytes starting at timestampNS, anything not in the buffer is silence. safe to call from the audio callback
+    void readAudio(Uint64 timestampNS, Uint8* out, size_t size);
+
+    // writes the last durationNS to a Matroska file on a background thread, fails if a save is still running
+    bool save(const std::string& path, Uint64 durationNS);
+    bool isSaving() const;
+
+    Stats getStats();
+
+private:
+    struct FrameEntry {
+        size_t offset;
+        size_t storedSize;
+
+        Uint64 sequence;
+        Uint64 timestampNS;
+
+        SDL_PixelFormat format;
+        int width;
+        int height;
+        int pitch;
+        size_t size;
+
+        bool compressed;
+    };
+
+    struct AudioEntry {
+        size_t offset;
+        size_t size;
+
+        Uint64 sequence;
+        Uint64 timestampNS;
+    };
+
+    void ingestThread();
+    void saveThread(std::string path, std::vector<FrameEntry> frames, std::vector<AudioEntry> audio);
+
+    void storeFrame(const FramePtr& frame);
+    void storeAudio(const Uint8* data, size_t size, Uint64 timestampNS);
+
+    // call with m_mutex held, evicts whatever overlaps the returned range
+    size_t reserve(size_t size);
+    void trim();
+
+    // entries only leave from the front, so one is stored as long as it isnt older than the oldest. takes m_mutex
+    bool isStored(const FrameEntry& entry);
+    // call without m_mutex held. the arena is read without the lock, so the ingest thread may be writing over the
+    // entry meanwhile and the bytes may be torn. it evicts entries under the lock before reusing their range, so the
+    // isStored check afterwards tells whether that happened, nullptr if it did
+    FramePtr decode(const FrameEntry& entry);
+
+private:
+    static constexpr size_t bytesPerSecond = 48000 * 2 * sizeof(Sint16);
+
+    Uint8* m_arena = nullptr;
+    size_t m_capacity;
+    size_t m_writeOffset = 0;
+
+    Uint64 m_maxDurationNS;
+    bool m_compress;
+
+    std::mutex m_mutex;
+    std::deque<FrameEntry> m_frames;
+    std::deque<AudioEntry> m_audio;
+    Uint64 m_frameSequence = 0;
+    Uint64 m_audioSequence = 0;
+    size_t m_usedBytes     = 0;
+    size_t m_rawBytes      = 0;
+
+    std::shared_ptr<FramePool> m_decodePool;
+
+    // sinks hand over to the ingest thread here
+    std::mutex m_queueMutex;
+    std::condition_variable m_queueCondition;
+    std::deque<FramePtr> m_queue;
+    size_t m_maxQueuedFrames;
+    Uint64 m_framesStored  = 0;
+    Uint64 m_framesDropped = 0;
+
+    // about a second of audio collected from the callback between ingest passes
+    std::mutex m_audioMutex;
+    std::vector<Uint8> m_pendingAudio;
+    size_t m_pendingAudioSize  = 0;
+    Uint64 m_pendingAudioStart = 0;
+
+    // only touched by the ingest thread
+    std::vector<Uint8> m_scratch;
+    std::vector<Uint8> m_audioScratch;
+
+    bool m_running = false;
+    std::thread m_thread;
+
+    std::atomic<bool> m_saving;
+    std::thread m_saveThread;
+};
+
+#endif
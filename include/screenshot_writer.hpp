@@ -0,0 +1,70 @@
+#ifndef __SCREENSHOT_WRITER_HPP__
+#define __SCREENSHOT_WRITER_HPP__
+
+#include <atomic>
+#include <frame.hpp>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <worker_pool.hpp>
+
+// saves stills of captured frames on a small worker pool. frames are queued by reference, so neither the render
+// nor the capture thread ever copies or converts anything. while bursting it saves every captured frame as a sink
+class ScreenshotWriter : public FrameSink {
+public:
+    enum class Format {
+        PNG,
+        QOI,
+        // uncompressed
+        BMP
+    };
+
+    struct Stats {
+        Uint64 saved;
+        // frames that didnt fit in the queue, only happens while bursting faster than the pool can encode
+        Uint64 dropped;
+        Uint64 failed;
+
+        size_t queued;
+        double averageEncodeMS;
+    };
+
+    // called on a worker thread once the file is written or couldnt be
+    using Done = std::function<void(bool saved)>;
+
+    ScreenshotWriter(size_t threadCount = 2, size_t maxQueuedFrames = 16);
+
+    void setFormat(Format format);
+
+    // path is without extension, mjpg frames are always written as the jpeg they already are
+    bool capture(const FramePtr& frame, const std::string& path, const Done& done = nullptr);
+
+    // frames are numbered by their sequence after basePath
+    void startBurst(const std::string& basePath);
+    void stopBurst();
+    bool isBursting() const;
+
+    void onFrame(const FramePtr& frame) override;
+
+    Stats getStats();
+
+private:
+    bool encode(const FramePtr& frame, const std::string& path, Format format);
+
+private:
+    std::atomic<Format> m_format;
+
+    std::mutex m_burstMutex;
+    std::string m_burstPath;
+    std::atomic<bool> m_bursting;
+
+    std::atomic<Uint64> m_saved;
+    std::atomic<Uint64> m_dropped;
+    std::atomic<Uint64> m_failed;
+    std::atomic<Uint64> m_encodeNS;
+
+    // declared last so queued jobs finish before the rest is torn down
+    WorkerPool m_pool;
+};
+
+#endif
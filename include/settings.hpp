@@ -7,11 +7,49 @@
 #include <string>
 #include <unordered_map>
 
+enum class CameraLayout {
+    SINGLE,
+    GRID,
+    PICTURE_IN_PICTURE
+};
+
+enum class DeinterlaceMode {
+    OFF,
+    // fields stay woven together as captured, sharp but combs on motion
+    WEAVE,
+    // every field becomes its own frame with the missing lines interpolated, doubling the framerate
+    BOB,
+    // like bob, but still areas take the missing lines from the other field
+    ADAPTIVE
+};
+
+// what happens to the cameras while the window is minimized, hidden or fully covered
+enum class HiddenCameraMode {
+    // keep capturing, only uploads and rendering stop
+    KEEP,
+    // reopen at the cheapest spec
+    LOWEST,
+    // close them until the window is visible again
+    PAUSE
+};
+
+// what the raw pipe output does with a new frame while the reader is behind and the queue in front of it is full
+enum class PipeFullPolicy {
+    // keep the queued frames and lose the new one
+    DROP_NEWEST,
+    // lose the oldest queued frame instead, the reader stays closer to live
+    DROP_OLDEST
+};
+
 class Settings {
 public:
     SDL_CameraID getSelectedCamera();
     void setSelectedCamera(SDL_CameraID camera);
 
+    // part of the picture shown for a camera as fractions of the frame size, nullopt for all of it
+    std::optional<SDL_FRect> getCameraCrop(SDL_CameraID camera);
+    void setCameraCrop(SDL_CameraID camera, const std::optional<SDL_FRect>& crop);
+
     SDL_AudioDeviceID getSelectedRecordingDevice();
     void setSelectedRecordingDevice(SDL_AudioDeviceID recordingDevice);
 
@@ -22,6 +60,76 @@ public:
     bool isFullscreen();
     void setFullscreen(bool fullscreen = true);
 
+    CameraLayout getCameraLayout();
+    void setCameraLayout(CameraLayout layout);
+
+    DeinterlaceMode getDeinterlaceMode();
+    void setDeinterlaceMode(DeinterlaceMode mode);
+    // field order of interlaced sources, most capture cards deliver top field first
+    bool isTopFieldFirst();
+    // pick the smallest camera spec that fills the window instead of the biggest one
+    bool isFitCameraToWindow();
+
+    HiddenCameraMode getHiddenCameraMode();
+
+    // how many cameras are opened at once in the grid and picture in picture layouts
+    int getMaxCameras();
+
+    // bytes of texture uploads allowed per rendered frame across all cameras, 0 for unlimited
+    size_t getUploadBudget();
+    // bytes of camera textures kept around for reuse after a stream closes or changes mode
+    size_t getTexturePoolSize();
+
+    // capacity of clays layout arena, the overlay is a few dozen elements and a few hundred words so the defaults
+    // are far below clays own. clays debug view needs more elements
+    int getClayMaxElements();
+    // words clay keeps measured between layouts, it starts over whenever they run out
+    int getClayMaxMeasuredWords();
+
+    // where recordings are written, defaults to the users videos folder
+    std::string getRecordingDirectory();
+
+    // where screenshots are written, defaults to the users pictures folder
+    std::string getScreenshotDirectory();
+    // png, qoi or bmp
+    std::string getScreenshotFormat();
+
+    // memory set aside for the instant replay buffer, 0 disables it and time-shifting
+    size_t getReplayBufferSize();
+    // how far back the replay buffer reaches if memory allows, and how much of it a saved replay gets
+    int getReplaySeconds();
+    int getReplaySaveSeconds();
+    bool isReplayCompressionEnabled();
+
+    // shm_open name the primary cameras frames are published under for other local processes, empty to disable
+    std::string getShmExportName();
+    int getShmExportSlots();
+    // unix socket path the relayed audio is served on as raw PCM, empty to disable
+    std::string getAudioSocketPath();
+    // fifos raw video and audio are written to for ffmpeg and the like, "-" sends video to stdout, empty to disable
+    std::string getPipeVideoPath();
+    std::string getPipeAudioPath();
+    PipeFullPolicy getPipeFullPolicy();
+    // mjpeg preview served over http, port 0 disables it. only reachable from this machine unless the address is changed
+    int getHttpPreviewPort();
+    std::string getHttpPreviewAddress();
+    // caps how often frames are encoded for it, mjpg cameras are passed through at their own rate
+    int getHttpPreviewFPS();
+    int getHttpPreviewQuality();
+    // host:port the relayed audio is sent to as udp packets, empty to disable
+    std::string getUdpAudioDestination();
+    // percent of sent packets dropped or reordered on purpose, for testing the receiving end
+    float getUdpAudioLoss();
+    float getUdpAudioReorder();
+    // plays audio received from another instance instead of the local recording device, port 0 disables it
+    int getUdpAudioReceivePort();
+    std::string getUdpAudioReceiveAddress();
+    // how much received audio is buffered against network jitter
+    int getUdpAudioLatency();
+
+    // --key=value arguments override the settings file for this run only, they are never saved
+    void setOverrides(int argc, char** argv);
+
     static Settings* get();
     static void close();
 
@@ -39,6 +147,7 @@ protected:
 private:
     std::string getSettingsPath();
     std::unordered_map<std::string, std::string> m_cache;
+    std::unordered_map<std::string, std::string> m_overrides;
 
     Settings();
 };
@@ -0,0 +1,66 @@
+#ifndef __SHM_EXPORTER_HPP__
+#define __SHM_EXPORTER_HPP__
+
+#include <condition_variable>
+#include <deque>
+#include <frame.hpp>
+#include <mutex>
+#include <shm_ring.hpp>
+#include <string>
+#include <thread>
+
+// publishes every frame of the primary camera into a ShmRing so other local processes can read it while we keep
+// displaying it. the capture thread only queues a reference, a writer thread does the copy into shared memory
+class ShmExporter : public FrameSink {
+public:
+    struct Stats {
+        Uint64 framesExported;
+        // dropped because the writer fell behind, readers see a gap in frameSequence
+        Uint64 framesDropped;
+        Uint64 bytesExported;
+        // rings replaced because a frame didnt fit the slots anymore
+        Uint64 resizes;
+
+        size_t slotCount;
+        size_t slotSize;
+    };
+
+    ShmExporter(size_t maxQueuedFrames = 4);
+    ~ShmExporter();
+
+    bool start(const std::string& name, Uint32 slotCount);
+    void stop();
+
+    bool isRunning() const;
+    const std::string& getName() const;
+
+    void onFrame(const FramePtr& frame) override;
+
+    Stats getStats();
+
+private:
+    void writerThread();
+
+private:
+    std::string m_name;
+    Uint32 m_slotCount = 0;
+
+    // only touched by the writer thread while it runs
+    ShmRing m_ring;
+
+    std::mutex m_queueMutex;
+    std::condition_variable m_queueCondition;
+    std::deque<FramePtr> m_queue;
+    size_t m_maxQueuedFrames;
+
+    Uint64 m_framesExported = 0;
+    Uint64 m_framesDropped  = 0;
+    Uint64 m_bytesExported  = 0;
+    Uint64 m_resizes        = 0;
+    size_t m_slotSize       = 0;
+
+    bool m_running = false;
+    std::thread m_thread;
+};
+
+#endif
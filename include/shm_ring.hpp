@@ -0,0 +1,100 @@
+#ifndef __SHM_RING_HPP__
+#define __SHM_RING_HPP__
+
+#include <SDL3/SDL.h>
+
+#include <atomic>
+#include <string>
+
+// shared memory layout, native endianness since both sides are on the same machine:
+//   [0, 4096)   ShmRingHeader
+//   [4096, ...) slotCount slots of slotSize bytes, each a ShmSlotHeader padded to slotHeaderSize followed by the frame
+struct ShmRingHeader {
+    char magic[4];  // "CCRS"
+    Uint32 version;
+    Uint32 slotCount;
+    Uint32 slotHeaderSize;
+    Uint64 slotSize;
+
+    // set once the writer is gone or has replaced the ring with a bigger one under the same name, readers should reopen
+    std::atomic<Uint32> closed;
+    // bumped after every frame, readers wait on it with a futex
+    std::atomic<Uint32> notify;
+    // frames published so far, the newest one is in slot (published - 1) % slotCount
+    std::atomic<Uint64> published;
+};
+
+struct ShmSlotHeader {
+    // seqlock, odd while the writer fills the slot and 2 * (frame index + 1) once it's done
+    std::atomic<Uint64> sequence;
+
+    Uint32 format;
+    Uint32 width;
+    Uint32 height;
+    Uint32 pitch;
+    Uint64 size;
+    Uint64 timestampNS;
+    // the cameras own frame sequence, gaps mean the capture thread skipped frames
+    Uint64 frameSequence;
+};
+
+static_assert(std::atomic<Uint64>::is_always_lock_free && std::atomic<Uint32>::is_always_lock_free, "shared atomics have to be lock free");
+
+// a ring of frame slots in POSIX shared memory with one writer and any number of readers in other processes.
+// readers look at the slots in place, the seqlock tells them afterwards whether the writer lapped them meanwhile
+class ShmRing {
+public:
+    struct View {
+        const ShmSlotHeader* header;
+        const Uint8* data;
+        Uint64 sequence;
+    };
+
+    static constexpr Uint32 version        = 1;
+    static constexpr size_t headerSize     = 4096;
+    static constexpr size_t slotHeaderSize = 64;
+
+    ShmRing() = default;
+    ~ShmRing();
+
+    ShmRing(const ShmRing&)            = delete;
+    ShmRing& operator=(const ShmRing&) = delete;
+
+    // writer side, name is a shm_open name like "/capturecardrelay"
+    bool create(const std::string& name, Uint32 slotCount, size_t slotDataSize);
+    // reader side, maps the ring read only
+    bool open(const std::string& name);
+    // the writer marks the ring closed and unlinks it, readers just unmap
+    void close();
+
+    bool isOpen() const;
+    bool isClosed() const;
+    size_t getSlotDataSize() const;
+    const ShmRingHeader* getHeader() const;
+
+    // writer only, data has to fit getSlotDataSize()
+    void write(const ShmSlotHeader& info, const Uint8* data);
+
+    // blocks until more than seen frames are published, the ring is closed or timeoutMS passes. returns the published count
+    Uint64 wait(Uint64 seen, int timeoutMS) const;
+
+    // frame index is published - 1 for the newest, false if it was overwritten or isnt written yet
+    bool acquire(Uint64 index, View* view) const;
+    // whether the frame behind view is still intact, check after reading it
+    bool validate(const View& view) const;
+
+private:
+    Uint8* getSlot(Uint64 index) const;
+
+private:
+    std::string m_name;
+    bool m_writer = false;
+
+    int m_fd        = -1;
+    Uint8* m_memory = nullptr;
+    size_t m_size   = 0;
+
+    ShmRingHeader* m_header = nullptr;
+};
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef __TEXTURE_POOL_HPP__
+#define __TEXTURE_POOL_HPP__
+
+#include <SDL3/SDL.h>
+
+#include <list>
+
+// keeps streaming textures around after a camera closes or changes mode, so the next stream with the same format and
+// size gets one straight away instead of waiting on the driver. idle textures are evicted least recently used first
+// once everything the pool created goes over its capacity. render thread only
+class TexturePool {
+public:
+    struct Stats {
+        size_t textures;
+        size_t idleTextures;
+
+        size_t bytes;
+        size_t idleBytes;
+        size_t capacity;
+
+        Uint64 hits;
+        Uint64 misses;
+        Uint64 evictions;
+    };
+
+    // 0 means idle textures are never kept
+    TexturePool(size_t capacityBytes = 0);
+    ~TexturePool();
+
+    void setRenderer(SDL_Renderer* renderer);
+    void setCapacity(size_t capacityBytes);
+
+    SDL_Texture* acquire(SDL_PixelFormat format, int width, int height);
+    // the texture keeps its contents, whoever gets it next has to upload a whole frame
+    void release(SDL_Texture* texture);
+
+    // makes sure count idle textures of this kind exist, as far as the capacity allows
+    void preallocate(SDL_PixelFormat format, int width, int height, size_t count = 1);
+
+    // destroys every idle texture, has to happen before the renderer goes away
+    void clear();
+
+    Stats getStats() const;
+
+    // rough video memory use, the driver may pad rows
+    static size_t getTextureBytes(SDL_PixelFormat format, int width, int height);
+
+private:
+    // evicts idle textures until another extraBytes fit
+    void trim(size_t extraBytes);
+
+private:
+    SDL_Renderer* m_renderer = nullptr;
+    size_t m_capacity;
+
+    // most recently released at the front
+    std::list<SDL_Texture*> m_idle;
+
+    size_t m_textures  = 0;
+    size_t m_bytes     = 0;
+    size_t m_idleBytes = 0;
+
+    Uint64 m_hits      = 0;
+    Uint64 m_misses    = 0;
+    Uint64 m_evictions = 0;
+};
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef __TILE_DIFF_HPP__
+#define __TILE_DIFF_HPP__
+
+#include <frame.hpp>
+
+// frames are compared in tiles of tileWidth x tileHeight pixels so only the parts that changed get uploaded again.
+// the chroma plane of NV12/NV21 belongs to the same tiles as the luma it covers, a tile can always be sent on its own
+static constexpr int tileWidth  = 64;
+static constexpr int tileHeight = 32;
+
+// whether the changed tiles of this format can be told apart, everything else is only compared as a whole
+bool isTileDiffSupported(SDL_PixelFormat format);
+
+int getTileColumns(const Frame& frame);
+int getTileRows(const Frame& frame);
+
+// sets dirty[row * columns + column] for every tile of frame that differs from previous and returns how many were set,
+// tiles that are already dirty arent looked at. both frames need the same format, size and pitch
+size_t compareTiles(const Frame& frame, const Frame& previous, Uint8* dirty);
+
+// byte exact compare of the whole payload
+bool isSameFrame(const Frame& frame, const Frame& previous);
+
+// bytes of frame data covered by one tile, including its chroma
+size_t getTileBytes(const Frame& frame);
+
+#endif
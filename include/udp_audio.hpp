@@ -0,0 +1,163 @@
+#ifndef __UDP_AUDIO_HPP__
+#define __UDP_AUDIO_HPP__
+
+#include <atomic>
+#include <audio_sink.hpp>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// every datagram is this header followed by udpAudioPacketSize bytes of S16LE 2 channel 48kHz PCM, in host byte order
+// since both ends are this program on the same kind of machine
+struct UdpAudioHeader {
+    char magic[4];
+    // one per packet, consecutive, wraps around
+    Uint32 sequence;
+    // when the first sample was recorded on the senders SDL_GetTicksNS clock, only comparable between packets
+    Uint64 timestampNS;
+};
+
+static constexpr char udpAudioMagic[4]         = { 'C', 'C', 'R', 'A' };
+static constexpr Uint64 udpAudioPacketMS       = 5;
+static constexpr size_t udpAudioBytesPerSecond = 48000 * 2 * sizeof(Sint16);
+static constexpr size_t udpAudioPacketSize     = udpAudioBytesPerSecond * udpAudioPacketMS / 1000;
+
+// sends the relayed audio to another host as small sequenced datagrams, straight from the audio callback since a
+// nonblocking send never waits
+class UdpAudioSender : public AudioSink {
+public:
+    struct Stats {
+        Uint64 packetsSent;
+        // the socket refused them, usually because nothing is listening on the other end yet
+        Uint64 packetsFailed;
+        // thrown away or swapped on purpose by setImpairment
+        Uint64 packetsLost;
+        Uint64 packetsReordered;
+    };
+
+    UdpAudioSender();
+    ~UdpAudioSender();
+
+    // host can be a name or an address
+    bool start(const std::string& host, Uint16 port);
+    void stop();
+
+    bool isRunning() const;
+    const std::string& getDestination() const;
+
+    // for testing the receiver, fractions of packets that are dropped or sent after the one following them
+    void setImpairment(float loss, float reorder);
+
+    void onAudio(const Uint8* data, size_t size, Uint64 timestampNS) override;
+
+    Stats getStats() const;
+
+private:
+    void sendPacket();
+    bool roll(float chance);
+
+private:
+    std::string m_destination;
+    int m_fd = -1;
+
+    // only touched from the audio callback
+    std::vector<Uint8> m_packet;
+    size_t m_packetFill = 0;
+    Uint32 m_sequence   = 0;
+    // a packet held back by the reorder impairment
+    std::vector<Uint8> m_held;
+    bool m_holding  = false;
+    Uint32 m_random = 0x12345678;
+
+    std::atomic<float> m_loss;
+    std::atomic<float> m_reorder;
+
+    std::atomic<Uint64> m_packetsSent;
+    std::atomic<Uint64> m_packetsFailed;
+    std::atomic<Uint64> m_packetsLost;
+    std::atomic<Uint64> m_packetsReordered;
+
+    std::atomic<bool> m_running;
+};
+
+// receives what a UdpAudioSender sends and hands it to the playback callback through a jitter buffer. packets are put
+// into slots by sequence, so reordered ones just land in the right place, and playback only starts once the target
+// latency worth of them is buffered. a packet that hasnt arrived by the time it's needed is played as silence
+class UdpAudioReceiver {
+public:
+    struct Stats {
+        bool receiving;
+        Uint64 packetsReceived;
+        // never arrived in time to be played
+        Uint64 packetsLost;
+        // arrived after their turn, or twice
+        Uint64 packetsLate;
+        // skipped to get back to the target latency after the buffer grew, the senders clock runs a bit fast
+        Uint64 packetsSkipped;
+        Uint64 underruns;
+
+        // interarrival jitter as in RFC 3550
+        double jitterMS;
+        double bufferedMS;
+        // every slot of the jitter buffer, allocated up front
+        size_t bufferBytes;
+    };
+
+    UdpAudioReceiver(Uint64 targetLatencyMS);
+    ~UdpAudioReceiver();
+
+    bool start(const std::string& address, Uint16 port);
+    void stop();
+
+    bool isRunning() const;
+    Uint16 getPort() const;
+
+    // called from the playback callback, always fills size bytes
+    void read(Uint8* out, size_t size);
+
+    Stats getStats();
+
+private:
+    struct Slot {
+        bool filled = false;
+        Uint32 sequence;
+        std::vector<Uint8> data;
+    };
+
+    void receiveThread();
+    void insert(const UdpAudioHeader& header, const Uint8* data);
+    // packets from the one being played to the newest received
+    size_t getBufferedPackets() const;
+
+private:
+    static constexpr size_t slotCount = 64;
+
+    Uint16 m_port = 0;
+    int m_fd      = -1;
+    size_t m_targetPackets;
+
+    std::mutex m_mutex;
+    std::vector<Slot> m_slots;
+    bool m_started         = false;
+    bool m_playing         = false;
+    Uint32 m_nextSequence  = 0;
+    Uint32 m_lastSequence  = 0;
+    size_t m_readOffset    = 0;
+    // the packet being played never arrived, it's silence instead
+    bool m_concealing      = false;
+    Uint64 m_lastArrivalNS = 0;
+    Uint64 m_lastSentNS    = 0;
+    double m_jitterNS      = 0.0;
+
+    Uint64 m_packetsReceived = 0;
+    Uint64 m_packetsLost     = 0;
+    Uint64 m_packetsLate     = 0;
+    Uint64 m_packetsSkipped  = 0;
+    Uint64 m_underruns       = 0;
+
+    std::atomic<bool> m_running;
+    std::thread m_thread;
+};
+
+#endif
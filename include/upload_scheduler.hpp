@@ -0,0 +1,33 @@
+#ifndef __UPLOAD_SCHEDULER_HPP__
+#define __UPLOAD_SCHEDULER_HPP__
+
+#include <camera_stream.hpp>
+#include <memory>
+#include <vector>
+
+// shares a per-frame texture upload budget between camera streams, the first (primary) stream is always uploaded
+// and the others split whatever it left over, visited round robin so a stream that missed out goes first next frame
+class UploadScheduler {
+public:
+    UploadScheduler(size_t budgetBytes = 0);
+
+    // 0 means unlimited
+    void setBudget(size_t budgetBytes);
+    size_t getBudget() const;
+
+    void run(const std::vector<std::unique_ptr<CameraStream>>& streams);
+
+    size_t getUploadedBytes() const;
+    size_t getDeferredUploads() const;
+
+private:
+    size_t m_budget;
+    size_t m_nextSecondary = 0;
+    bool m_starved         = false;
+
+    // stats for the last run
+    size_t m_uploadedBytes   = 0;
+    size_t m_deferredUploads = 0;
+};
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef __WORKER_POOL_HPP__
+#define __WORKER_POOL_HPP__
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// fixed set of threads draining a bounded job queue
+class WorkerPool {
+public:
+    using Job = std::function<void()>;
+
+    WorkerPool(size_t threadCount, size_t maxQueuedJobs);
+    // finishes everything already queued before returning
+    ~WorkerPool();
+
+    // returns false instead of waiting when the queue is full
+    bool trySubmit(Job job);
+    // waits for room in the queue
+    void submit(Job job);
+
+    // waits until every queued job has finished
+    void wait();
+
+    size_t getQueuedJobs();
+    size_t getThreadCount() const;
+
+private:
+    void workerThread();
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_jobAvailable;
+    std::condition_variable m_jobFinished;
+
+    std::deque<Job> m_jobs;
+    size_t m_maxQueuedJobs;
+    size_t m_runningJobs = 0;
+
+    bool m_stopping = false;
+    std::vector<std::thread> m_threads;
+};
+
+#endif
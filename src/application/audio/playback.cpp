@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <application.hpp>
 
 // https://stackoverflow.com/a/57796299
@@ -22,6 +23,35 @@ void Application::playbackCallbackHandler(SDL_AudioStream* stream, int additiona
     const static auto emptyBuffer = make_array<Uint16, audioBufferSize>(0);
 
     m_audioMutex.lock();
+    if(m_udpAudioReceiver != nullptr) {
+        // the local recording keeps going to the sinks, only the speakers get the network audio
+        m_audioBuffers.clear();
+
+        std::array<Uint8, 1920> buffer;
+        for(int remaining = additional_amount; remaining > 0; remaining -= buffer.size()) {
+            const size_t size = std::min<size_t>(remaining, buffer.size()) & ~(size_t)3;
+            if(size == 0) {
+                break;
+            }
+
+            m_udpAudioReceiver->read(buffer.data(), size);
+            SDL_PutAudioStreamData(stream, buffer.data(), size);
+        }
+
+        m_audioMutex.unlock();
+        return;
+    }
+
+    if(m_timeShift.active) {
+        // live audio still goes into the replay buffer, only whats being replayed is heard
+        m_audioBuffers.clear();
+
+        playTimeShiftAudio(stream, additional_amount);
+
+        m_audioMutex.unlock();
+        return;
+    }
+
     for(int i = 0; i <= totalBuffers; i++) {
         if(m_audioBuffers.empty()) {
             SDL_PutAudioStreamData(stream, emptyBuffer.data(), audioBufferSize * sizeof(Uint16));
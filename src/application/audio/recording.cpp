@@ -1,13 +1,24 @@
+#include <algorithm>
 #include <application.hpp>
 #include <settings.hpp>
 
 void Application::onRecordingCallback(void* userdata, SDL_AudioStream* stream, int additional_amount, int total_amount) { ((Application*)userdata)->recordingCallbackHandler(stream, additional_amount, total_amount); }
 void Application::recordingCallbackHandler(SDL_AudioStream* stream, int additional_amount, int total_amount) {
     m_audioMutex.lock();
+
+    // everything still queued in the stream was recorded before now, which dates its first sample
+    const Uint64 bytesPerSecond = m_audioSpec.freq * m_audioSpec.channels * sizeof(Uint16);
+    Uint64 timestampNS          = SDL_GetTicksNS() - SDL_GetAudioStreamAvailable(stream) * 1000000000ull / bytesPerSecond;
+
     while(SDL_GetAudioStreamAvailable(stream) >= (int)(audioBufferSize * sizeof(Uint16))) {
         std::array<Uint16, audioBufferSize> buffer;
         SDL_GetAudioStreamData(stream, buffer.data(), buffer.size() * sizeof(Uint16));
 
+        for(AudioSink* sink : m_audioSinks) {
+            sink->onAudio((const Uint8*)buffer.data(), buffer.size() * sizeof(Uint16), timestampNS);
+        }
+
+        timestampNS += buffer.size() * sizeof(Uint16) * 1000000000ull / bytesPerSecond;
         m_audioBuffers.push_back(buffer);
 
         while(m_audioBuffers.size() > maxAudioBuffers) {
@@ -18,6 +29,16 @@ void Application::recordingCallbackHandler(SDL_AudioStream* stream, int addition
     m_audioMutex.unlock();
 }
 
+void Application::addAudioSink(AudioSink* sink) {
+    std::lock_guard lock(m_audioMutex);
+    m_audioSinks.push_back(sink);
+}
+
+void Application::removeAudioSink(AudioSink* sink) {
+    std::lock_guard lock(m_audioMutex);
+    m_audioSinks.erase(std::remove(m_audioSinks.begin(), m_audioSinks.end(), sink), m_audioSinks.end());
+}
+
 void Application::initAudioRecordingDevices() {
     int recordingDeviceCount            = 0;
     SDL_AudioDeviceID* recordingDevices = SDL_GetAudioRecordingDevices(&recordingDeviceCount);
@@ -1,8 +1,10 @@
 #include <SDL3/SDL_camera.h>
 #include <SDL3/SDL_pixels.h>
 
+#include <algorithm>
 #include <application.hpp>
-#include <set>
+#include <cmath>
+#include <crop.hpp>
 #include <settings.hpp>
 #include <unordered_map>
 
@@ -163,57 +165,326 @@ static std::unordered_map<SDL_PixelFormat, uint16_t> formatScores = {
     { SDL_PIXELFORMAT_P010,          64 },
 };
 
-void Application::openCamera() {
-    if(m_cameraData->camera.device != nullptr) {
-        closeCamera();
+static int framerate(const SDL_CameraSpec* spec) {
+    return spec->framerate_denominator == 0 ? 0 : spec->framerate_numerator / spec->framerate_denominator;
+}
+
+// highest scoring format, then biggest resolution, then highest framerate
+static bool isBetterSpec(const SDL_CameraSpec* a, const SDL_CameraSpec* b) {
+    if(formatScores[a->format] != formatScores[b->format]) {
+        return formatScores[a->format] > formatScores[b->format];
     }
 
-    SDL_CameraID camID = Settings::get()->getSelectedCamera();
-    if(camID == 0) {
-        camID = m_cameras[0];
+    if(a->width != b->width) {
+        return a->width > b->width;
+    }
+
+    if(a->height != b->height) {
+        return a->height > b->height;
+    }
+
+    return framerate(a) > framerate(b);
+}
+
+// highest scoring format still wins since anything we cant upload directly costs a conversion, then smallest area, then lowest framerate
+static bool isCheaperSpec(const SDL_CameraSpec* a, const SDL_CameraSpec* b) {
+    if(formatScores[a->format] != formatScores[b->format]) {
+        return formatScores[a->format] > formatScores[b->format];
+    }
+
+    if(a->width * a->height != b->width * b->height) {
+        return a->width * a->height < b->width * b->height;
     }
 
+    return framerate(a) < framerate(b);
+}
+
+// cameras are aspect fit, so a spec fills the target without being scaled up as soon as one side reaches it
+static bool fillsTarget(const SDL_CameraSpec* spec, const SDL_Point& target) { return spec->width >= target.x || spec->height >= target.y; }
+
+// anything that fills the target beats what doesnt, then highest framerate, highest scoring format and smallest area.
+// if nothing fills it the biggest spec gets closest
+static bool isBetterFit(const SDL_CameraSpec* a, const SDL_CameraSpec* b, const SDL_Point& target) {
+    const bool aFills = fillsTarget(a, target);
+    const bool bFills = fillsTarget(b, target);
+    if(aFills != bFills) {
+        return aFills;
+    }
+
+    if(!aFills) {
+        return isBetterSpec(a, b);
+    }
+
+    if(framerate(a) != framerate(b)) {
+        return framerate(a) > framerate(b);
+    }
+
+    if(formatScores[a->format] != formatScores[b->format]) {
+        return formatScores[a->format] > formatScores[b->format];
+    }
+
+    return a->width * a->height < b->width * b->height;
+}
+
+static bool isSameSpec(const SDL_CameraSpec& a, const SDL_CameraSpec& b) {
+    return a.format == b.format && a.width == b.width && a.height == b.height && a.framerate_numerator == b.framerate_numerator && a.framerate_denominator == b.framerate_denominator;
+}
+
+bool Application::pickCameraSpec(SDL_CameraID camID, CameraSpecPreference preference, const SDL_Point& target, SDL_CameraSpec* out) {
     int numFormats           = 0;
     SDL_CameraSpec** formats = SDL_GetCameraSupportedFormats(camID, &numFormats);
     if(numFormats <= 0 || formats == nullptr) {
+        return false;
+    }
+
+    SDL_CameraSpec** spec;
+    if(preference == CameraSpecPreference::FIT_WINDOW && target.x > 0 && target.y > 0) {
+        spec = std::min_element(formats, formats + numFormats, [&target](const SDL_CameraSpec* a, const SDL_CameraSpec* b) {
+            return isBetterFit(a, b, target);
+        });
+    }
+    else {
+        spec = std::min_element(formats, formats + numFormats, preference == CameraSpecPreference::CHEAPEST ? isCheaperSpec : isBetterSpec);
+    }
+
+    *out = **spec;
+    SDL_free(formats);
+
+    return true;
+}
+
+std::unique_ptr<CameraStream> Application::openCameraStream(SDL_CameraID camID, CameraSpecPreference preference, const SDL_Point& target) {
+    SDL_CameraSpec spec;
+    if(!pickCameraSpec(camID, preference, target, &spec)) {
+        return nullptr;
+    }
+
+    std::unique_ptr<CameraStream> stream = std::make_unique<CameraStream>(camID, spec, &m_texturePool);
+    if(!stream->isOpen()) {
+        return nullptr;
+    }
+
+    // the texture is ready before the first frame arrives, a cropped one only gets its size from the frame
+    stream->setCrop(Settings::get()->getCameraCrop(camID));
+    if(!stream->getCrop().has_value()) {
+        m_texturePool.preallocate(spec.format, spec.width, spec.height);
+    }
+
+    // thumbnails arent worth the extra work
+    if(preference != CameraSpecPreference::CHEAPEST) {
+        stream->getDeinterlacer().setMode(Settings::get()->getDeinterlaceMode());
+        stream->getDeinterlacer().setTopFieldFirst(Settings::get()->isTopFieldFirst());
+    }
+
+    return stream;
+}
+
+void Application::openCameras() {
+    if(m_lowPower.camerasPaused) {
         return;
     }
 
-    auto cmp = [](SDL_CameraSpec* a, SDL_CameraSpec* b) {
-        if(formatScores[a->format] != formatScores[b->format]) {
-            return formatScores[a->format] > formatScores[b->format];
+    SDL_CameraID camID = Settings::get()->getSelectedCamera();
+    if(camID == 0) {
+        camID = m_cameras[0];
+    }
+
+    std::vector<SDL_CameraID> wanted = { camID };
+    if(Settings::get()->getCameraLayout() != CameraLayout::SINGLE) {
+        const size_t maxCameras = Settings::get()->getMaxCameras();
+
+        for(SDL_CameraID id : m_cameras) {
+            if(wanted.size() >= maxCameras) {
+                break;
+            }
+
+            if(id != camID) {
+                wanted.push_back(id);
+            }
         }
+    }
+
+    // streams that are still wanted keep running, e.g. the primary when switching layouts
+    std::vector<std::unique_ptr<CameraStream>> previous = std::move(m_streams);
+    m_streams.clear();
+
+    for(size_t i = 0; i < wanted.size(); i++) {
+        const SDL_CameraID id = wanted[i];
+
+        auto it = std::find_if(previous.begin(), previous.end(), [id](const std::unique_ptr<CameraStream>& stream) {
+            return stream != nullptr && stream->getID() == id;
+        });
 
-        if(a->width != b->width) {
-            return a->width > b->width;
+        std::unique_ptr<CameraStream> stream = it != previous.end() ? std::move(*it) : openCameraStream(id, m_cameraPreference, getCameraTargetSize(i, wanted.size()));
+        if(stream != nullptr) {
+            m_streams.push_back(std::move(stream));
         }
+        else if(id == camID) {
+            // without a primary there is nothing to show
+            break;
+        }
+    }
+
+    attachFrameSinks();
+}
+
+void Application::closeCameras() {
+    m_streams.clear();
+}
+
+Application::CameraSpecPreference Application::getDefaultCameraPreference() {
+    return Settings::get()->isFitCameraToWindow() ? CameraSpecPreference::FIT_WINDOW : CameraSpecPreference::BEST;
+}
+
+SDL_Point Application::getCameraTargetSize(size_t index, size_t count) {
+    SDL_Point size = { m_width, m_height };
+    if(m_window != nullptr) {
+        SDL_GetWindowSizeInPixels(m_window, &size.x, &size.y);
+    }
+
+    switch(Settings::get()->getCameraLayout()) {
+    case CameraLayout::GRID: {
+        const int columns = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(count))));
+        const int rows    = static_cast<int>((count + columns - 1) / columns);
+
+        return { size.x / columns, size.y / rows };
+    }
+    case CameraLayout::PICTURE_IN_PICTURE:
+        // the inset is a quarter of the window wide, assume 16:9 for its height
+        return index == 0 ? size : SDL_Point{ size.x / 4, size.x / 4 * 9 / 16 };
+    default:
+        return size;
+    }
+}
+
+void Application::refitCameras() {
+    // long enough for a window drag to finish, reopening a camera takes a while and drops a few frames
+    constexpr Uint64 settleNS   = 500 * SDL_NS_PER_MS;
+    constexpr Uint64 intervalNS = 3 * SDL_NS_PER_SECOND;
+
+    const Uint64 nowNS = SDL_GetTicksNS();
+    if(m_cameraFit.changedNS == 0 || nowNS - m_cameraFit.changedNS < settleNS || nowNS - m_cameraFit.lastRefitNS < intervalNS) {
+        return;
+    }
 
-        if(a->height != b->height) {
-            return a->height > b->height;
+    // recordings keep their resolution, the picker and time-shift have their own streams or frames.
+    // whatever changed meanwhile is picked up once they're done
+    if(m_cameraPreference != CameraSpecPreference::FIT_WINDOW || m_picker.open || m_timeShift.active || m_recorder != nullptr || m_mjpegRecorder != nullptr) {
+        return;
+    }
+
+    m_cameraFit.changedNS = 0;
+
+    bool changed = false;
+    for(size_t i = 0; i < m_streams.size(); i++) {
+        const SDL_Point target = getCameraTargetSize(i, m_streams.size());
+
+        SDL_CameraSpec spec;
+        if(!pickCameraSpec(m_streams[i]->getID(), CameraSpecPreference::FIT_WINDOW, target, &spec) || isSameSpec(spec, m_streams[i]->getSpec())) {
+            continue;
         }
 
-        if(a->framerate_numerator / a->framerate_denominator != b->framerate_numerator / b->framerate_denominator) {
-            return a->framerate_numerator / a->framerate_denominator > b->framerate_numerator / b->framerate_denominator;
+        // a camera being scaled up is fixed right away, one that is bigger than needed only once it's well over,
+        // so resizing back and forth by a few pixels doesnt keep reopening it
+        const SDL_CameraSpec& current = m_streams[i]->getSpec();
+        if(fillsTarget(&current, target) && !fillsTarget(&current, SDL_Point{ target.x * 3 / 2, target.y * 3 / 2 })) {
+            continue;
         }
 
-        return false;
-    };
+        SDL_Log("Refitting %s from %dx%d to %dx%d for a %dx%d target", SDL_GetCameraName(m_streams[i]->getID()), current.width, current.height, spec.width, spec.height, target.x, target.y);
 
-    std::set<SDL_CameraSpec*, decltype(cmp)> specs;
-    for(int i = 0; i < numFormats; i++) {
-        specs.emplace(formats[i]);
+        // openCameras opens it again with the new target
+        m_streams[i].reset();
+        changed = true;
     }
 
-    SDL_CameraSpec* spec        = *specs.begin();
-    m_cameraData->camera.device = SDL_OpenCamera(camID, spec);
+    if(!changed) {
+        return;
+    }
+
+    m_cameraFit.lastRefitNS = nowNS;
+
+    std::erase(m_streams, nullptr);
+    openCameras();
 }
 
-void Application::closeCamera() {
-    if(m_cameraData->camera.device != nullptr) {
-        SDL_CloseCamera(m_cameraData->camera.device);
+void Application::selectPrimaryCamera(SDL_CameraID id) {
+    Settings::get()->setSelectedCamera(id);
+
+    auto it = std::find_if(m_streams.begin(), m_streams.end(), [id](const std::unique_ptr<CameraStream>& stream) {
+        return stream->getID() == id;
+    });
+
+    if(it == m_streams.end()) {
+        openCameras();
+        return;
     }
 
-    if(m_cameraData->camera.texture != nullptr) {
-        SDL_DestroyTexture(m_cameraData->camera.texture);
+    // already open as a secondary, just swap it into the primary slot, refitting will get it a bigger spec
+    std::iter_swap(m_streams.begin(), it);
+    attachFrameSinks();
+
+    m_cameraFit.changedNS = SDL_GetTicksNS();
+}
+
+void Application::toggleCrop() {
+    if(m_streams.empty()) {
+        return;
+    }
+
+    CameraStream* stream = m_streams[0].get();
+    if(stream->getCrop().has_value()) {
+        stream->setCrop(std::nullopt);
+        Settings::get()->setCameraCrop(stream->getID(), std::nullopt);
+
+        changeStatus("Crop: Off", std::chrono::milliseconds(1500));
+        return;
+    }
+
+    FramePtr frame = stream->getLatestFrame();
+    if(frame == nullptr || !isCropSupported(frame->format)) {
+        changeStatus("Crop: Not supported for this format", std::chrono::milliseconds(1500));
+        return;
+    }
+
+    SDL_FRect crop;
+    if(!detectCrop(*frame, &crop)) {
+        changeStatus("Crop: No borders found", std::chrono::milliseconds(1500));
+        return;
+    }
+
+    stream->setCrop(crop);
+    Settings::get()->setCameraCrop(stream->getID(), crop);
+
+    const SDL_Rect region = getCropRect(*frame, crop);
+    changeStatus("Crop: " + std::to_string(region.w) + "x" + std::to_string(region.h), std::chrono::milliseconds(1500));
+}
+
+void Application::addFrameSink(FrameSink* sink) {
+    m_frameSinks.push_back(sink);
+    attachFrameSinks();
+}
+
+void Application::removeFrameSink(FrameSink* sink) {
+    for(auto& stream : m_streams) {
+        stream->removeSink(sink);
     }
-}
\ No newline at end of file
+
+    m_frameSinks.erase(std::remove(m_frameSinks.begin(), m_frameSinks.end(), sink), m_frameSinks.end());
+}
+
+void Application::attachFrameSinks() {
+    for(auto& stream : m_streams) {
+        for(FrameSink* sink : m_frameSinks) {
+            stream->removeSink(sink);
+        }
+    }
+
+    if(m_streams.empty()) {
+        return;
+    }
+
+    for(FrameSink* sink : m_frameSinks) {
+        m_streams[0]->addSink(sink);
+    }
+}
@@ -16,20 +16,7 @@
 #include "settings.hpp"
 
 void Application::handleEvent(SDL_Event* event) {
-    auto it = m_eventHandlers.find((SDL_EventType)event->type);
-    if(it != m_eventHandlers.end()) {
-        std::vector<std::pair<EventHandler, void*>> handlers = it->second;
-
-        for(auto it = handlers.begin(); it != handlers.end();) {
-            std::pair<EventHandler, void*> handler = *it;
-            if(!(handler.first(event, handler.second))) {
-                it = handlers.erase(it);
-                continue;
-            }
-
-            it++;
-        }
-    }
+    m_eventHandlers.dispatch(event);
 
     switch(event->type) {
     case SDL_EVENT_QUIT:
@@ -44,6 +31,22 @@ void Application::handleEvent(SDL_Event* event) {
             static_cast<float>(m_height),
         });
 
+        m_cameraFit.changedNS = SDL_GetTicksNS();
+        break;
+    case SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED:
+        m_cameraFit.changedNS = SDL_GetTicksNS();
+        break;
+    case SDL_EVENT_WINDOW_HIDDEN:
+    case SDL_EVENT_WINDOW_MINIMIZED:
+    case SDL_EVENT_WINDOW_OCCLUDED:
+        enterLowPower();
+
+        break;
+    case SDL_EVENT_WINDOW_SHOWN:
+    case SDL_EVENT_WINDOW_RESTORED:
+    case SDL_EVENT_WINDOW_EXPOSED:
+        leaveLowPower();
+
         break;
     case SDL_EVENT_MOUSE_MOTION:
         Clay_SetPointerState(
@@ -57,6 +60,8 @@ void Application::handleEvent(SDL_Event* event) {
         m_showCursorExpire = std::chrono::system_clock::now() + std::chrono::milliseconds(1000);
         SDL_ShowCursor();
 
+        // clay tracks hover state, so pointer moves need a new layout
+        m_overlay.dirty = true;
         break;
     case SDL_EVENT_MOUSE_BUTTON_DOWN:
         Clay_SetPointerState(
@@ -67,13 +72,28 @@ void Application::handleEvent(SDL_Event* event) {
             event->button.button == SDL_BUTTON_LEFT
         );
 
+        m_overlay.dirty = true;
         break;
     case SDL_EVENT_MOUSE_WHEEL:
         Clay_UpdateScrollContainers(true, Clay_Vector2{ event->wheel.x, event->wheel.y }, 0.01f);
 
+        m_overlay.dirty = true;
+        break;
+    // target textures lose what was drawn into them
+    case SDL_EVENT_RENDER_TARGETS_RESET:
+    case SDL_EVENT_RENDER_DEVICE_RESET:
+        m_overlay.stale = true;
         break;
     case SDL_EVENT_CAMERA_DEVICE_REMOVED:
-        openCamera();
+        if(m_picker.open) {
+            closeCameraPicker(false);
+            openCameraPicker();
+
+            break;
+        }
+
+        closeCameras();
+        openCameras();
 
         break;
     case SDL_EVENT_AUDIO_DEVICE_REMOVED:
@@ -88,11 +108,15 @@ void Application::handleEvent(SDL_Event* event) {
 
         break;
     case SDL_EVENT_KEY_DOWN:
+        if(handleCameraPickerKey(event->key.key)) {
+            break;
+        }
+
         switch(event->key.key) {
         case SDLK_LEFT: {
             size_t idx = 0;
-            if(m_cameraData->camera.device != nullptr) {
-                auto it = std::find(m_cameras.begin(), m_cameras.end(), SDL_GetCameraID(m_cameraData->camera.device));
+            if(!m_streams.empty()) {
+                auto it = std::find(m_cameras.begin(), m_cameras.end(), m_streams[0]->getID());
                 if(it != m_cameras.end()) {
                     idx = std::distance(m_cameras.begin(), it);
                 }
@@ -102,8 +126,7 @@ void Application::handleEvent(SDL_Event* event) {
             }
 
             idx = (idx + 1) % m_cameras.size();
-            Settings::get()->setSelectedCamera(m_cameras[idx]);
-            openCamera();
+            selectPrimaryCamera(m_cameras[idx]);
 
             changeStatus(std::string("Camera: ") + SDL_GetCameraName(m_cameras[idx]), std::chrono::milliseconds(1500));
 
@@ -146,6 +169,116 @@ void Application::handleEvent(SDL_Event* event) {
             changeStatus(std::string("Volume: ") + std::to_string(Settings::get()->getVolume()) + "%", std::chrono::milliseconds(1500));
             updateVolume();
 
+            break;
+        case SDLK_TAB:
+            openCameraPicker();
+
+            break;
+        case SDLK_L: {
+            CameraLayout layout;
+            std::string name;
+
+            switch(Settings::get()->getCameraLayout()) {
+            case CameraLayout::SINGLE:
+                layout = CameraLayout::GRID;
+                name   = "Grid";
+                break;
+            case CameraLayout::GRID:
+                layout = CameraLayout::PICTURE_IN_PICTURE;
+                name   = "Picture in Picture";
+                break;
+            default:
+                layout = CameraLayout::SINGLE;
+                name   = "Single";
+                break;
+            }
+
+            Settings::get()->setCameraLayout(layout);
+            openCameras();
+
+            m_cameraFit.changedNS = SDL_GetTicksNS();
+
+            changeStatus(std::string("Layout: ") + name, std::chrono::milliseconds(1500));
+
+            break;
+        }
+        case SDLK_C:
+            toggleCrop();
+            break;
+        case SDLK_D: {
+            DeinterlaceMode mode;
+            std::string name;
+
+            switch(Settings::get()->getDeinterlaceMode()) {
+            case DeinterlaceMode::OFF:
+                mode = DeinterlaceMode::BOB;
+                name = "Bob";
+                break;
+            case DeinterlaceMode::BOB:
+                mode = DeinterlaceMode::ADAPTIVE;
+                name = "Motion Adaptive";
+                break;
+            case DeinterlaceMode::ADAPTIVE:
+                mode = DeinterlaceMode::WEAVE;
+                name = "Weave";
+                break;
+            default:
+                mode = DeinterlaceMode::OFF;
+                name = "Off";
+                break;
+            }
+
+            Settings::get()->setDeinterlaceMode(mode);
+            for(auto& stream : m_streams) {
+                stream->getDeinterlacer().setMode(mode);
+            }
+
+            changeStatus(std::string("Deinterlace: ") + name, std::chrono::milliseconds(1500));
+
+            break;
+        }
+        case SDLK_R:
+            if(m_recorder != nullptr || m_mjpegRecorder != nullptr) {
+                stopRecording();
+            }
+            else {
+                startRecording();
+            }
+
+            break;
+        case SDLK_SPACE:
+            toggleTimeShift();
+
+            break;
+        case SDLK_COMMA:
+            seekTimeShift(-5 * (Sint64)SDL_NS_PER_SECOND);
+
+            break;
+        case SDLK_PERIOD:
+            seekTimeShift(5 * (Sint64)SDL_NS_PER_SECOND);
+
+            break;
+        case SDLK_END:
+            catchUpTimeShift();
+
+            break;
+        case SDLK_F2:
+            // key repeat only kicks in once its been held for a moment
+            if(!event->key.repeat) {
+                takeScreenshot();
+            }
+            else {
+                startScreenshotBurst();
+            }
+
+            break;
+        case SDLK_F3:
+            m_showStats = !m_showStats;
+
+            break;
+        case SDLK_F9:
+            saveReplay();
+
             break;
         case SDLK_F11: {
             bool fullscreen = !Settings::get()->isFullscreen();
@@ -157,18 +290,22 @@ void Application::handleEvent(SDL_Event* event) {
         }
         case SDLK_F12:
             Clay_SetDebugModeEnabled(!Clay_IsDebugModeEnabled());
+            // the debug view is part of the overlay layout, so it has to be laid out again to show or hide it
+            m_overlay.dirty = true;
 
             break;
         default: break;
         }
+        break;
+    case SDL_EVENT_KEY_UP:
+        if(event->key.key == SDLK_F2) {
+            stopScreenshotBurst();
+        }
+
         break;
     }
 }
 
 void Application::registerEventHandler(SDL_EventType type, const Application::EventHandler& handler, void* extraData) {
-    if(m_eventHandlers.find(type) == m_eventHandlers.end()) {
-        m_eventHandlers[type] = {};
-    }
-
-    m_eventHandlers[type].push_back(std::make_pair(handler, extraData));
+    m_eventHandlers.add(type, handler, extraData);
 }
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include <application.hpp>
+#include <cstdlib>
+#include <settings.hpp>
+
+void Application::startExports() {
+    const std::string shmName = Settings::get()->getShmExportName();
+    if(!shmName.empty()) {
+        m_shmExporter = std::make_unique<ShmExporter>();
+        if(m_shmExporter->start(shmName, Settings::get()->getShmExportSlots())) {
+            addFrameSink(m_shmExporter.get());
+        }
+        else {
+            m_shmExporter.reset();
+        }
+    }
+
+    const std::string audioSocketPath = Settings::get()->getAudioSocketPath();
+    if(!audioSocketPath.empty()) {
+        m_audioSocket = std::make_unique<AudioSocketServer>();
+        if(m_audioSocket->start(audioSocketPath)) {
+            updateVolume();
+            addAudioSink(m_audioSocket.get());
+        }
+        else {
+            m_audioSocket.reset();
+        }
+    }
+
+    const std::string pipeVideoPath = Settings::get()->getPipeVideoPath();
+    const std::string pipeAudioPath = Settings::get()->getPipeAudioPath();
+    if(!pipeVideoPath.empty() || !pipeAudioPath.empty()) {
+        m_pipeOutput = std::make_unique<PipeOutput>(Settings::get()->getPipeFullPolicy());
+        if(m_pipeOutput->start(pipeVideoPath, pipeAudioPath)) {
+            addFrameSink(m_pipeOutput.get());
+            addAudioSink(m_pipeOutput.get());
+        }
+        else {
+            m_pipeOutput.reset();
+        }
+    }
+
+    const int httpPreviewPort = Settings::get()->getHttpPreviewPort();
+    if(httpPreviewPort != 0) {
+        m_httpPreview = std::make_unique<MjpegHttpServer>();
+        if(m_httpPreview->start(Settings::get()->getHttpPreviewAddress(), httpPreviewPort, Settings::get()->getHttpPreviewFPS(), Settings::get()->getHttpPreviewQuality())) {
+            addFrameSink(m_httpPreview.get());
+        }
+        else {
+            m_httpPreview.reset();
+        }
+    }
+
+    const std::string udpAudioDestination = Settings::get()->getUdpAudioDestination();
+    const size_t portSeparator            = udpAudioDestination.rfind(':');
+    if(!udpAudioDestination.empty() && portSeparator == std::string::npos) {
+        SDL_Log("udpAudioSend needs to be host:port, got %s", udpAudioDestination.c_str());
+    }
+    else if(!udpAudioDestination.empty()) {
+        m_udpAudioSender = std::make_unique<UdpAudioSender>();
+        if(m_udpAudioSender->start(udpAudioDestination.substr(0, portSeparator), std::atoi(udpAudioDestination.c_str() + portSeparator + 1))) {
+            m_udpAudioSender->setImpairment(Settings::get()->getUdpAudioLoss(), Settings::get()->getUdpAudioReorder());
+            addAudioSink(m_udpAudioSender.get());
+        }
+        else {
+            m_udpAudioSender.reset();
+        }
+    }
+
+    const int udpAudioReceivePort = Settings::get()->getUdpAudioReceivePort();
+    if(udpAudioReceivePort != 0) {
+        std::unique_ptr<UdpAudioReceiver> receiver = std::make_unique<UdpAudioReceiver>(Settings::get()->getUdpAudioLatency());
+        if(receiver->start(Settings::get()->getUdpAudioReceiveAddress(), udpAudioReceivePort)) {
+            std::lock_guard lock(m_audioMutex);
+            m_udpAudioReceiver = std::move(receiver);
+        }
+    }
+}
+
+void Application::stopExports() {
+    if(m_shmExporter != nullptr) {
+        removeFrameSink(m_shmExporter.get());
+        m_shmExporter.reset();
+    }
+
+    if(m_audioSocket != nullptr) {
+        removeAudioSink(m_audioSocket.get());
+        m_audioSocket.reset();
+    }
+
+    if(m_pipeOutput != nullptr) {
+        removeFrameSink(m_pipeOutput.get());
+        removeAudioSink(m_pipeOutput.get());
+        m_pipeOutput.reset();
+    }
+
+    if(m_httpPreview != nullptr) {
+        removeFrameSink(m_httpPreview.get());
+        m_httpPreview.reset();
+    }
+
+    if(m_udpAudioSender != nullptr) {
+        removeAudioSink(m_udpAudioSender.get());
+        m_udpAudioSender.reset();
+    }
+
+    // destroyed outside the lock, the playback callback only looks at it while holding it
+    std::unique_ptr<UdpAudioReceiver> receiver;
+    {
+        std::lock_guard lock(m_audioMutex);
+        receiver = std::move(m_udpAudioReceiver);
+    }
+}
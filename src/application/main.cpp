@@ -13,18 +13,17 @@
 #define CLAY_IMPLEMENTATION
 #include <clay.h>
 
-void HandleClayErrors(Clay_ErrorData errorData) {
-    printf("%s", errorData.errorText.chars);
-}
+// the stats and picker are drawn at 16, the status and time-shift at 24
+static constexpr Uint16 overlayFontSizes[] = { 16, 24 };
+// printable ascii, anything else is rare enough to be rasterized when it shows up
+static constexpr char overlayGlyphs[] = " !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~";
 
 Application::Application()
     : m_shouldQuit(false)
     , m_width(800)
     , m_height(600)
-    , m_cameraData(new CustomElementData{
-          .type   = CUSTOM_ELEMENT_TYPE_CAMERA,
-          .camera = { nullptr, nullptr }
-}) {
+    , m_texturePool(Settings::get()->getTexturePoolSize())
+    , m_uploadScheduler(Settings::get()->getUploadBudget()) {
     if(!SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO | SDL_INIT_CAMERA)) {
         SDL_Log("Couldn't initialize SDL: %s", SDL_GetError());
         setShouldQuit();
@@ -46,6 +45,16 @@ Application::Application()
         return;
     }
 
+    m_texturePool.setRenderer(m_renderData.renderer);
+
+    // screenshots are written on the writers threads, the result comes back as an event so the status is set here
+    if((m_screenshotEvent = SDL_RegisterEvents(1)) != 0) {
+        registerEventHandler((SDL_EventType)m_screenshotEvent, [this](SDL_Event* event, void*) {
+            changeStatus(event->user.code != 0 ? "Screenshot saved" : "Couldn't save screenshot", std::chrono::milliseconds(1500));
+            return true;
+        });
+    }
+
     if(!TTF_Init()) {
         SDL_Log("Couldn't initialise SDL_ttf: %s\n", SDL_GetError());
         setShouldQuit();
@@ -68,6 +77,11 @@ Application::Application()
         return;
     }
 
+    // every size the overlay uses, so the first status or stats shown doesnt stall on rasterizing the font
+    for(Uint16 size : overlayFontSizes) {
+        SDL_Clay_PrewarmFont(&m_renderData, 0, size, overlayGlyphs);
+    }
+
     initCameras();
     initAudioPlaybackDevices();
     initAudioRecordingDevices();
@@ -75,21 +89,30 @@ Application::Application()
         return;
     }
 
-    openCamera();
+    openCameras();
     openAudioPlaybackDevice();
     openAudioRecordingDevice();
     if(getShouldQuit()) {
         return;
     }
 
-    uint64_t totalMemorySize = Clay_MinMemorySize();
-    Clay_Arena clayMemory    = Clay_Arena{
-           .capacity = totalMemorySize,
-           .memory   = (char*)malloc(totalMemorySize)
+    startReplayBuffer();
+    startExports();
+
+    // the element count also resets the word count, so it goes first
+    Clay_SetMaxElementCount(Settings::get()->getClayMaxElements());
+    Clay_SetMaxMeasureTextCacheWordCount(Settings::get()->getClayMaxMeasuredWords());
+
+    m_clay.size   = Clay_MinMemorySize();
+    m_clay.memory = malloc(m_clay.size);
+
+    Clay_Arena clayMemory = Clay_Arena{
+        .capacity = m_clay.size,
+        .memory   = (char*)m_clay.memory
     };
 
-    Clay_Initialize(clayMemory, Clay_Dimensions(m_width, m_height), Clay_ErrorHandler(HandleClayErrors));
-    Clay_SetMeasureTextFunction(SDL_MeasureText, &m_renderData.fonts);
+    Clay_Initialize(clayMemory, Clay_Dimensions(m_width, m_height), Clay_ErrorHandler{ onClayError, this });
+    Clay_SetMeasureTextFunction(SDL_MeasureText, &m_renderData);
 
     if(Settings::get()->isFullscreen()) {
         SDL_SetWindowFullscreen(m_window, true);
@@ -99,10 +122,21 @@ Application::Application()
 Application::~Application() {
     setShouldQuit(true);
 
-    closeCamera();
+    stopRecording();
+    stopScreenshotBurst();
+    stopReplayBuffer();
+    stopExports();
+    closeCameras();
+    m_picker.streams.clear();
+    m_texturePool.clear();
     closeAudioRecordingDevice();
     closeAudioPlaybackDevice();
 
+    if(m_overlay.texture != nullptr) {
+        SDL_DestroyTexture(m_overlay.texture);
+    }
+
+    SDL_Clay_ClearTextCache(&m_renderData);
     for(auto font : m_renderData.fonts) {
         if(font == nullptr) {
             continue;
@@ -115,6 +149,9 @@ Application::~Application() {
     SDL_DestroyWindow(m_window);
 
     SDL_Quit();
+
+    Clay_SetCurrentContext(nullptr);
+    free(m_clay.memory);
 }
 
 bool Application::loop() {
@@ -122,13 +159,20 @@ bool Application::loop() {
         return false;
     }
 
+    // nothing to draw, so sleep until something happens instead of spinning
+    if(m_lowPower.active) {
+        SDL_WaitEventTimeout(nullptr, 100);
+    }
+
     SDL_Event event;
     while(SDL_PollEvent(&event)) {
         handleEvent(&event);
     }
 
     update();
-    render();
+    if(!m_lowPower.active) {
+        render();
+    }
 
     return !getShouldQuit();
 }
@@ -137,6 +181,11 @@ void Application::update() {
     if(SDL_CursorVisible() && std::chrono::system_clock::now() >= m_showCursorExpire) {
         SDL_HideCursor();
     }
+
+    if(!m_lowPower.active) {
+        updateTimeShift();
+        refitCameras();
+    }
 }
 
 Uint32 Application::statusStep() {
@@ -172,6 +221,25 @@ Uint32 Application::onStatusStepCallback(void* userdata, SDL_TimerID timerID, Ui
     return 1;
 }
 
+void Application::onClayError(Clay_ErrorData errorData) {
+    Application* app = reinterpret_cast<Application*>(errorData.userData);
+
+    // text that changes every frame, like the stats, piles up in clays measure cache since it only frees stale words
+    // it happens to walk past. render() starts the cache over and lays out again, which is expected every so often
+    if(errorData.errorType == CLAY_ERROR_TYPE_TEXT_MEASUREMENT_CAPACITY_EXCEEDED) {
+        app->m_clay.measureCacheFull = true;
+        return;
+    }
+
+    // the measured texts count against the elements too, so this may be the same thing
+    if(errorData.errorType == CLAY_ERROR_TYPE_ELEMENTS_CAPACITY_EXCEEDED) {
+        app->m_clay.measureCacheFull = true;
+    }
+
+    // stdout may be carrying piped video
+    SDL_Log("%.*s", (int)errorData.errorText.length, errorData.errorText.chars);
+}
+
 void Application::changeStatus(std::string text, std::chrono::milliseconds timeToExpire) {
     m_status.text   = text;
     m_status.expire = std::chrono::system_clock::now() + timeToExpire;
@@ -189,6 +257,11 @@ void Application::updateVolume() {
     float adjustedVolume = std::powf(volume, 3.0f);
 
     SDL_SetAudioStreamGain(m_audioPlayback.stream, adjustedVolume);
+
+    // socket clients get what the speakers get
+    if(m_audioSocket != nullptr) {
+        m_audioSocket->setGain(adjustedVolume);
+    }
 }
 
 bool Application::getShouldQuit() const { return m_shouldQuit; }
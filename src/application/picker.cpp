@@ -0,0 +1,173 @@
+#include <application.hpp>
+#include <cmath>
+#include <cstring>
+#include <settings.hpp>
+
+void Application::openCameraPicker() {
+    if(m_picker.open) {
+        return;
+    }
+
+    // the picker streams dont feed any sinks, recordings, exports and the replay buffer would stall until it closes
+    if(!m_frameSinks.empty()) {
+        changeStatus("Can't pick a camera while recording, exporting or buffering replays", std::chrono::milliseconds(1500));
+        return;
+    }
+
+    // a camera can only be opened once, so the full spec streams have to go while browsing
+    closeCameras();
+
+    m_picker.open     = true;
+    m_picker.selected = 0;
+
+    SDL_CameraID current = Settings::get()->getSelectedCamera();
+    for(SDL_CameraID id : m_cameras) {
+        std::unique_ptr<CameraStream> stream = openCameraStream(id, CameraSpecPreference::CHEAPEST);
+        if(stream == nullptr) {
+            continue;
+        }
+
+        if(id == current) {
+            m_picker.selected = m_picker.streams.size();
+        }
+
+        m_picker.streams.push_back(std::move(stream));
+    }
+}
+
+void Application::closeCameraPicker(bool apply) {
+    if(!m_picker.open) {
+        return;
+    }
+
+    SDL_CameraID chosen = 0;
+    if(apply && m_picker.selected < m_picker.streams.size()) {
+        chosen = m_picker.streams[m_picker.selected]->getID();
+    }
+
+    m_picker.streams.clear();
+    m_picker.open = false;
+
+    if(chosen != 0) {
+        Settings::get()->setSelectedCamera(chosen);
+        changeStatus(std::string("Camera: ") + SDL_GetCameraName(chosen), std::chrono::milliseconds(1500));
+    }
+
+    openCameras();
+}
+
+bool Application::handleCameraPickerKey(SDL_Keycode key) {
+    if(!m_picker.open) {
+        return false;
+    }
+
+    const size_t count   = m_picker.streams.size();
+    const size_t columns = std::max<size_t>(1, (size_t)std::ceil(std::sqrt((float)count)));
+
+    switch(key) {
+    case SDLK_LEFT:
+        m_picker.selected = count == 0 ? 0 : (m_picker.selected + count - 1) % count;
+        break;
+    case SDLK_RIGHT:
+        m_picker.selected = count == 0 ? 0 : (m_picker.selected + 1) % count;
+        break;
+    case SDLK_UP:
+        if(m_picker.selected >= columns) {
+            m_picker.selected -= columns;
+        }
+
+        break;
+    case SDLK_DOWN:
+        if(m_picker.selected + columns < count) {
+            m_picker.selected += columns;
+        }
+
+        break;
+    case SDLK_RETURN:
+        closeCameraPicker(true);
+        break;
+    case SDLK_ESCAPE:
+    case SDLK_TAB:
+        closeCameraPicker(false);
+        break;
+    // everything else that would touch the cameras has to wait until the picker is closed
+    default:
+        return key != SDLK_F11 && key != SDLK_F12;
+    }
+
+    return true;
+}
+
+void Application::layoutCameraPicker() {
+    const int count   = static_cast<int>(m_picker.streams.size());
+    const int columns = std::max(1, static_cast<int>(std::ceil(std::sqrt(static_cast<float>(count)))));
+
+    // clang-format off
+    for(int row = 0; row * columns < count; row++) {
+        CLAY(
+            CLAY_IDI("PickerRow", row),
+            {
+                .layout = {
+                    .sizing = {
+                        CLAY_SIZING_GROW(0),
+                        CLAY_SIZING_GROW(0)
+                    },
+                    .childGap = 16
+                }
+            }
+        ) {
+            for(int i = row * columns; i < std::min(count, (row + 1) * columns); i++) {
+                const char* name    = SDL_GetCameraName(m_picker.streams[i]->getID());
+                const bool selected = static_cast<size_t>(i) == m_picker.selected;
+
+                CLAY(
+                    CLAY_IDI("PickerEntry", i),
+                    {
+                        .layout = {
+                            .sizing = {
+                                CLAY_SIZING_GROW(0),
+                                CLAY_SIZING_GROW(0)
+                            },
+                            .padding = CLAY_PADDING_ALL(8),
+                            .childGap = 8,
+                            .layoutDirection = CLAY_TOP_TO_BOTTOM
+                        },
+                        .backgroundColor = { 0x20, 0x20, 0x20, 255 },
+                        .cornerRadius = CLAY_CORNER_RADIUS(6),
+                        .border = {
+                            .color = selected ? Clay_Color{ 255, 255, 255, 255 } : Clay_Color{ 0x50, 0x50, 0x50, 255 },
+                            .width = CLAY_BORDER_OUTSIDE(2)
+                        }
+                    }
+                ) {
+                    CLAY(
+                        CLAY_IDI("PickerThumbnail", i),
+                        {
+                            .layout = {
+                                .sizing = {
+                                    CLAY_SIZING_GROW(0),
+                                    CLAY_SIZING_GROW(0)
+                                }
+                            },
+                            .backgroundColor = { 0, 0, 0, 255 },
+                            .custom = { .customData = m_picker.streams[i]->getElementData() }
+                        }
+                    ) {}
+
+                    Clay__OpenTextElement(
+                        {
+                            .isStaticallyAllocated = false,
+                            .length = static_cast<int32_t>(name != nullptr ? strlen(name) : 0),
+                            .chars = name != nullptr ? name : ""
+                        },
+                        CLAY_TEXT_CONFIG({
+                            .textColor = { 255, 255, 255, 255 },
+                            .fontSize = 16
+                        })
+                    );
+                }
+            }
+        }
+    }
+    // clang-format on
+}
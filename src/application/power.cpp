@@ -0,0 +1,49 @@
+#include <application.hpp>
+#include <settings.hpp>
+
+void Application::enterLowPower() {
+    if(m_lowPower.active) {
+        return;
+    }
+
+    m_lowPower.active = true;
+
+    // anything fed by the cameras (recordings, exports, screenshot bursts, the replay buffer) keeps its source as is,
+    // only the view is given up
+    if(!m_frameSinks.empty() || m_picker.open) {
+        return;
+    }
+
+    switch(Settings::get()->getHiddenCameraMode()) {
+    case HiddenCameraMode::LOWEST:
+        m_cameraPreference        = CameraSpecPreference::CHEAPEST;
+        m_lowPower.camerasReduced = true;
+
+        closeCameras();
+        openCameras();
+        break;
+    case HiddenCameraMode::PAUSE:
+        m_lowPower.camerasPaused = true;
+
+        closeCameras();
+        break;
+    default: break;
+    }
+}
+
+void Application::leaveLowPower() {
+    if(!m_lowPower.active) {
+        return;
+    }
+
+    m_lowPower.active = false;
+
+    if(m_lowPower.camerasReduced || m_lowPower.camerasPaused) {
+        m_cameraPreference        = getDefaultCameraPreference();
+        m_lowPower.camerasReduced = false;
+        m_lowPower.camerasPaused  = false;
+
+        closeCameras();
+        openCameras();
+    }
+}
@@ -0,0 +1,160 @@
+#include <application.hpp>
+#include <cstdio>
+#include <ctime>
+#include <settings.hpp>
+
+static std::string makeOutputPath(std::string directory, const char* extension) {
+    std::time_t now = std::time(nullptr);
+    char name[64];
+
+    std::strftime(name, sizeof(name), "CaptureCardRelay-%Y%m%d-%H%M%S", std::localtime(&now));
+
+    if(!directory.empty() && directory.back() != '/') {
+        directory += '/';
+    }
+
+    return directory + name + extension;
+}
+
+static std::string makeRecordingPath(const char* extension) { return makeOutputPath(Settings::get()->getRecordingDirectory(), extension); }
+
+static ScreenshotWriter::Format getScreenshotFormat() {
+    const std::string format = Settings::get()->getScreenshotFormat();
+    if(format == "qoi") {
+        return ScreenshotWriter::Format::QOI;
+    }
+    else if(format == "bmp") {
+        return ScreenshotWriter::Format::BMP;
+    }
+
+    return ScreenshotWriter::Format::PNG;
+}
+
+void Application::startRecording() {
+    if(m_recorder != nullptr || m_mjpegRecorder != nullptr) {
+        return;
+    }
+
+    if(!m_streams.empty() && m_streams[0]->getSpec().format == SDL_PIXELFORMAT_MJPG) {
+        const SDL_CameraSpec& spec = m_streams[0]->getSpec();
+
+        std::unique_ptr<MjpegRecorder> recorder = std::make_unique<MjpegRecorder>();
+        if(!recorder->start(makeRecordingPath(".mkv"), spec.width, spec.height)) {
+            changeStatus("Couldn't start recording", std::chrono::milliseconds(1500));
+            return;
+        }
+
+        m_mjpegRecorder = std::move(recorder);
+        addFrameSink(m_mjpegRecorder.get());
+        addAudioSink(m_mjpegRecorder.get());
+
+        changeStatus("Recording: " + m_mjpegRecorder->getPath(), std::chrono::milliseconds(1500));
+        return;
+    }
+
+    std::unique_ptr<RawRecorder> recorder = std::make_unique<RawRecorder>();
+    if(!recorder->start(makeRecordingPath(".ccrv"))) {
+        changeStatus("Couldn't start recording", std::chrono::milliseconds(1500));
+        return;
+    }
+
+    m_recorder = std::move(recorder);
+    addFrameSink(m_recorder.get());
+
+    changeStatus("Recording: " + m_recorder->getPath(), std::chrono::milliseconds(1500));
+}
+
+void Application::takeScreenshot() {
+    FramePtr frame = m_timeShift.active ? m_timeShift.frame : m_streams.empty() ? nullptr : m_streams[0]->getLatestFrame();
+    if(frame == nullptr) {
+        return;
+    }
+
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), "-%06llu", (unsigned long long)frame->sequence);
+
+    // the status waits for the writer, it's only known to be saved once the file is written
+    ScreenshotWriter::Done done = nullptr;
+    if(m_screenshotEvent != 0) {
+        done = [doneEvent = m_screenshotEvent](bool saved) {
+            SDL_Event event = {};
+            event.type      = doneEvent;
+            event.user.code = saved ? 1 : 0;
+            SDL_PushEvent(&event);
+        };
+    }
+
+    m_screenshots.setFormat(getScreenshotFormat());
+    if(!m_screenshots.capture(frame, makeOutputPath(Settings::get()->getScreenshotDirectory(), suffix), done)) {
+        changeStatus("Screenshot queue is full", std::chrono::milliseconds(1500));
+    }
+}
+
+void Application::startScreenshotBurst() {
+    if(m_screenshots.isBursting()) {
+        return;
+    }
+
+    m_screenshots.setFormat(getScreenshotFormat());
+    m_screenshots.startBurst(makeOutputPath(Settings::get()->getScreenshotDirectory(), "-burst"));
+    addFrameSink(&m_screenshots);
+
+    changeStatus("Burst capture", std::chrono::milliseconds(1500));
+}
+
+void Application::stopScreenshotBurst() {
+    if(!m_screenshots.isBursting()) {
+        return;
+    }
+
+    removeFrameSink(&m_screenshots);
+    m_screenshots.stopBurst();
+
+    ScreenshotWriter::Stats stats = m_screenshots.getStats();
+    changeStatus("Burst finished, " + std::to_string(stats.dropped) + " frames dropped", std::chrono::milliseconds(1500));
+}
+
+void Application::saveReplay() {
+    if(m_replay == nullptr) {
+        changeStatus("Replay buffer is off, set replayBufferSize to use it", std::chrono::milliseconds(1500));
+        return;
+    }
+
+    if(m_replay->isSaving()) {
+        changeStatus("Still saving the last replay", std::chrono::milliseconds(1500));
+        return;
+    }
+
+    const std::string path = makeRecordingPath(".mkv");
+    if(!m_replay->save(path, (Uint64)Settings::get()->getReplaySaveSeconds() * SDL_NS_PER_SECOND)) {
+        changeStatus("Nothing to save yet", std::chrono::milliseconds(1500));
+        return;
+    }
+
+    changeStatus("Saving replay: " + path, std::chrono::milliseconds(1500));
+}
+
+void Application::stopRecording() {
+    if(m_mjpegRecorder != nullptr) {
+        removeFrameSink(m_mjpegRecorder.get());
+        removeAudioSink(m_mjpegRecorder.get());
+        m_mjpegRecorder->stop();
+
+        MjpegRecorder::Stats stats = m_mjpegRecorder->getStats();
+        changeStatus("Recording saved, " + std::to_string(stats.framesDropped) + " frames dropped", std::chrono::milliseconds(1500));
+
+        m_mjpegRecorder.reset();
+    }
+
+    if(m_recorder == nullptr) {
+        return;
+    }
+
+    removeFrameSink(m_recorder.get());
+    m_recorder->stop();
+
+    RawRecorder::Stats stats = m_recorder->getStats();
+    changeStatus("Recording saved, " + std::to_string(stats.framesDropped) + " frames dropped", std::chrono::milliseconds(1500));
+
+    m_recorder.reset();
+}
@@ -1,11 +1,149 @@
 #include <application.hpp>
+#include <cmath>
+#include <settings.hpp>
 
 void Application::render() {
+    m_uploadScheduler.run(m_picker.open ? m_picker.streams : m_streams);
+
+    // the cameras and the overlay are rendered separately, but they are one frame to the text cache and the stats
+    SDL_Clay_BeginFrame(&m_renderData);
+
     SDL_SetRenderDrawColor(m_renderData.renderer, 0, 0, 0, SDL_ALPHA_OPAQUE);
     SDL_RenderClear(m_renderData.renderer);
 
+    if(updateOverlayInputs() || m_overlay.dirty) {
+        m_overlay.commands = buildLayout();
+
+        // the texts that didnt fit were measured as empty, once more with room for all of them
+        if(m_clay.measureCacheFull) {
+            Clay_ResetMeasureTextCache();
+            m_overlay.commands = buildLayout();
+
+            m_clay.measureCacheFull = false;
+            m_clay.measureCacheResets++;
+        }
+
+        m_overlay.dirty = false;
+        m_overlay.stale = true;
+        m_overlay.layouts++;
+
+        m_overlay.split = 0;
+        for(int32_t i = 0; i < m_overlay.commands.length; i++) {
+            if(Clay_RenderCommandArray_Get(&m_overlay.commands, i)->commandType == CLAY_RENDER_COMMAND_TYPE_CUSTOM) {
+                m_overlay.split = i + 1;
+            }
+        }
+    }
+    else {
+        // nothing but the camera images changed, the commands from last time still place them right
+        m_overlay.reuses++;
+    }
+
+    Clay_RenderCommandArray cameras = { m_overlay.split, m_overlay.split, m_overlay.commands.internalArray };
+    SDL_Clay_RenderClayCommands(&m_renderData, &cameras);
+
+    renderOverlay();
+
+    SDL_RenderPresent(m_renderData.renderer);
+}
+
+bool Application::updateOverlayInputs() {
+    OverlayInputs& next = m_overlay.next;
+
+    next.width           = m_width;
+    next.height          = m_height;
+    next.layout          = Settings::get()->getCameraLayout();
+    next.pickerOpen      = m_picker.open;
+    next.pickerSelected  = m_picker.selected;
+    next.timeShiftActive = m_timeShift.active;
+    next.showStats       = m_showStats;
+    next.statusText      = m_status.text;
+    next.statusProgress  = m_status.animationProgress;
+    next.statusHeight    = Clay_GetElementData(CLAY_ID("Status")).boundingBox.height;
+
+    if(m_showStats) {
+        next.statsText = collectStats();
+    }
+    else {
+        next.statsText.clear();
+    }
+
+    if(m_timeShift.active && m_replay != nullptr) {
+        next.timeShiftText = getTimeShiftText();
+    }
+    else {
+        next.timeShiftText.clear();
+    }
+
+    next.cameras.clear();
+    for(const std::unique_ptr<CameraStream>& stream : m_picker.open ? m_picker.streams : m_streams) {
+        const CustomElementData* data = stream->getElementData();
+        const SDL_Texture* tex        = data->camera.texture;
+
+        next.cameras.emplace_back(data, tex != nullptr ? tex->w : 0, tex != nullptr ? tex->h : 0);
+    }
+
+    if(next == m_overlay.inputs) {
+        return false;
+    }
+
+    std::swap(m_overlay.inputs, m_overlay.next);
+    return true;
+}
+
+void Application::renderOverlay() {
+    Clay_RenderCommandArray overlay = {
+        m_overlay.commands.length - m_overlay.split,
+        m_overlay.commands.length - m_overlay.split,
+        m_overlay.commands.internalArray + m_overlay.split
+    };
+
+    if(overlay.length == 0) {
+        return;
+    }
+
+    if(m_overlay.stale) {
+        if(m_overlay.texture != nullptr && (m_overlay.texture->w != m_width || m_overlay.texture->h != m_height)) {
+            SDL_DestroyTexture(m_overlay.texture);
+            m_overlay.texture = nullptr;
+        }
+
+        if(m_overlay.texture == nullptr) {
+            m_overlay.texture = SDL_CreateTexture(m_renderData.renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, m_width, m_height);
+            if(m_overlay.texture == nullptr) {
+                // still works, just without the caching
+                SDL_Clay_RenderClayCommands(&m_renderData, &overlay);
+                return;
+            }
+
+            // blending straight colors into a transparent target leaves them premultiplied
+            SDL_SetTextureBlendMode(m_overlay.texture, SDL_BLENDMODE_BLEND_PREMULTIPLIED);
+        }
+
+        SDL_SetRenderTarget(m_renderData.renderer, m_overlay.texture);
+        SDL_SetRenderDrawColor(m_renderData.renderer, 0, 0, 0, SDL_ALPHA_TRANSPARENT);
+        SDL_RenderClear(m_renderData.renderer);
+
+        SDL_Clay_RenderClayCommands(&m_renderData, &overlay);
+
+        SDL_SetRenderTarget(m_renderData.renderer, nullptr);
+        m_overlay.stale = false;
+    }
+
+    const SDL_FRect dest = { 0.0f, 0.0f, (float)m_width, (float)m_height };
+    SDL_RenderTexture(m_renderData.renderer, m_overlay.texture, nullptr, &dest);
+}
+
+Clay_RenderCommandArray Application::buildLayout() {
     Clay_BeginLayout();
 
+    // time-shifting shows the replayed primary camera on its own
+    const CameraLayout layout      = m_timeShift.active ? CameraLayout::SINGLE : m_overlay.inputs.layout;
+    CustomElementData* primaryData = m_streams.empty() || m_picker.open || layout == CameraLayout::GRID ? nullptr : m_streams[0]->getElementData();
+    if(m_timeShift.active && !m_picker.open) {
+        primaryData = &m_timeShift.elementData;
+    }
+
     // clang-format off
     CLAY(
         CLAY_ID("Body"),
@@ -16,12 +154,31 @@ void Application::render() {
                     CLAY_SIZING_PERCENT(1.0)
                 },
                 .padding = CLAY_PADDING_ALL(16),
-                .childGap = 16
+                .childGap = 16,
+                .layoutDirection = CLAY_TOP_TO_BOTTOM
             },
             .backgroundColor = { 0, 0, 0,255 },
-            .custom = { .customData = m_cameraData.get() }
+            .custom = { .customData = primaryData }
         }
     ) {
+        if(m_picker.open) {
+            layoutCameraPicker();
+        }
+        else if(layout == CameraLayout::GRID) {
+            layoutCameraGrid();
+        }
+        else if(layout == CameraLayout::PICTURE_IN_PICTURE) {
+            layoutPictureInPicture();
+        }
+
+        if(m_timeShift.active && !m_picker.open) {
+            layoutTimeShift();
+        }
+
+        if(m_showStats) {
+            layoutStats();
+        }
+
         if(!m_status.text.empty()) {
             // 0 on start
             const float height = Clay_GetElementData(CLAY_ID("Status")).boundingBox.height;
@@ -42,7 +199,7 @@ void Application::render() {
                         },
                         .parentId = CLAY_ID("Body").id,
                         // if height isnt set yet then hide
-                        .zIndex = static_cast<int16_t>(height <= 0.0f ? -1 : 1),
+                        .zIndex = static_cast<int16_t>(height <= 0.0f ? -1 : 2),
                         .attachPoints = {
                             .element = CLAY_ATTACH_POINT_RIGHT_BOTTOM,
                             .parent = CLAY_ATTACH_POINT_RIGHT_BOTTOM
@@ -67,8 +224,83 @@ void Application::render() {
     }
     // clang-format on
 
-    Clay_RenderCommandArray renderCommands = Clay_EndLayout();
-    SDL_Clay_RenderClayCommands(&m_renderData, &renderCommands);
+    return Clay_EndLayout();
+}
 
-    SDL_RenderPresent(m_renderData.renderer);
-}
\ No newline at end of file
+void Application::layoutCameraGrid() {
+    const int count   = static_cast<int>(m_streams.size());
+    const int columns = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(count))));
+
+    // clang-format off
+    for(int row = 0; row * columns < count; row++) {
+        CLAY(
+            CLAY_IDI("CameraRow", row),
+            {
+                .layout = {
+                    .sizing = {
+                        CLAY_SIZING_GROW(0),
+                        CLAY_SIZING_GROW(0)
+                    },
+                    .childGap = 16
+                }
+            }
+        ) {
+            for(int i = row * columns; i < std::min(count, (row + 1) * columns); i++) {
+                CLAY(
+                    CLAY_IDI("Camera", i),
+                    {
+                        .layout = {
+                            .sizing = {
+                                CLAY_SIZING_GROW(0),
+                                CLAY_SIZING_GROW(0)
+                            }
+                        },
+                        .backgroundColor = { 0, 0, 0, 255 },
+                        .custom = { .customData = m_streams[i]->getElementData() }
+                    }
+                ) {}
+            }
+        }
+    }
+    // clang-format on
+}
+
+void Application::layoutPictureInPicture() {
+    const float width = m_width / 4.0f;
+    float offsetY     = 16.0f;
+
+    // clang-format off
+    for(size_t i = 1; i < m_streams.size(); i++) {
+        CustomElementData* data = m_streams[i]->getElementData();
+
+        const SDL_Texture* tex = data->camera.texture;
+        const float height     = tex != nullptr && tex->w > 0 ? width * tex->h / tex->w : width * 9.0f / 16.0f;
+
+        CLAY(
+            CLAY_IDI("Camera", i),
+            {
+                .layout = {
+                    .sizing = {
+                        CLAY_SIZING_FIXED(width),
+                        CLAY_SIZING_FIXED(height)
+                    }
+                },
+                .backgroundColor = { 0, 0, 0, 255 },
+                .floating = {
+                    .offset = { -16.0f, offsetY },
+                    .parentId = CLAY_ID("Body").id,
+                    .zIndex = 1,
+                    .attachPoints = {
+                        .element = CLAY_ATTACH_POINT_RIGHT_TOP,
+                        .parent = CLAY_ATTACH_POINT_RIGHT_TOP
+                    },
+                    .attachTo = CLAY_ATTACH_TO_ELEMENT_WITH_ID
+                },
+                .custom = { .customData = data }
+            }
+        ) {}
+
+        offsetY += height + 16.0f;
+    }
+    // clang-format on
+}
@@ -0,0 +1,248 @@
+#include <algorithm>
+#include <application.hpp>
+#include <crop.hpp>
+#include <cstdio>
+#include <settings.hpp>
+
+// how fast playback runs when catching back up with live, audio is muted meanwhile
+static constexpr float catchUpSpeed = 2.0f;
+
+void Application::startReplayBuffer() {
+    const size_t size = Settings::get()->getReplayBufferSize();
+    if(size == 0) {
+        return;
+    }
+
+    const Uint64 durationNS = (Uint64)Settings::get()->getReplaySeconds() * SDL_NS_PER_SECOND;
+
+    auto replay = std::make_unique<ReplayBuffer>(size, durationNS, Settings::get()->isReplayCompressionEnabled());
+    if(!replay->isValid()) {
+        return;
+    }
+
+    {
+        std::lock_guard lock(m_audioMutex);
+        m_replay = std::move(replay);
+    }
+
+    addFrameSink(m_replay.get());
+    addAudioSink(m_replay.get());
+}
+
+void Application::stopReplayBuffer() {
+    exitTimeShift();
+
+    m_texturePool.release(m_timeShift.elementData.camera.texture);
+    m_timeShift.elementData.camera.texture = nullptr;
+
+    if(m_replay == nullptr) {
+        return;
+    }
+
+    removeFrameSink(m_replay.get());
+    removeAudioSink(m_replay.get());
+
+    // the playback callback could be reading from it, so it is only freed once the callback is done with it
+    std::unique_ptr<ReplayBuffer> replay;
+    {
+        std::lock_guard lock(m_audioMutex);
+        replay = std::move(m_replay);
+    }
+}
+
+void Application::toggleTimeShift() {
+    if(m_replay == nullptr) {
+        changeStatus("Replay buffer is off, set replayBufferSize to use it", std::chrono::milliseconds(1500));
+        return;
+    }
+
+    if(!m_timeShift.active) {
+        const Uint64 newestNS = m_replay->getNewestTimestamp();
+        if(newestNS == 0) {
+            return;
+        }
+
+        m_timeShift.positionNS   = newestNS;
+        m_timeShift.lastUpdateNS = SDL_GetTicksNS();
+        m_timeShift.playing      = false;
+        m_timeShift.catchingUp   = false;
+        m_timeShift.active       = true;
+
+        return;
+    }
+
+    m_timeShift.catchingUp = false;
+    m_timeShift.playing    = !m_timeShift.playing;
+}
+
+void Application::seekTimeShift(Sint64 offsetNS) {
+    if(m_replay == nullptr) {
+        changeStatus("Replay buffer is off, set replayBufferSize to use it", std::chrono::milliseconds(1500));
+        return;
+    }
+
+    const Uint64 oldestNS = m_replay->getOldestTimestamp();
+    const Uint64 newestNS = m_replay->getNewestTimestamp();
+    if(newestNS == 0) {
+        return;
+    }
+
+    // seeking back from live starts playing right away
+    if(!m_timeShift.active) {
+        m_timeShift.positionNS   = newestNS;
+        m_timeShift.lastUpdateNS = SDL_GetTicksNS();
+        m_timeShift.playing      = true;
+        m_timeShift.catchingUp   = false;
+        m_timeShift.active       = true;
+    }
+
+    const Sint64 positionNS = (Sint64)m_timeShift.positionNS.load() + offsetNS;
+    if(positionNS >= (Sint64)newestNS) {
+        exitTimeShift();
+        return;
+    }
+
+    m_timeShift.positionNS = (Uint64)std::max(positionNS, (Sint64)oldestNS);
+}
+
+void Application::catchUpTimeShift() {
+    if(!m_timeShift.active) {
+        return;
+    }
+
+    m_timeShift.playing    = true;
+    m_timeShift.catchingUp = true;
+}
+
+void Application::exitTimeShift() {
+    if(!m_timeShift.active) {
+        return;
+    }
+
+    m_timeShift.active     = false;
+    m_timeShift.playing    = false;
+    m_timeShift.catchingUp = false;
+    m_timeShift.frame.reset();
+}
+
+void Application::updateTimeShift() {
+    if(!m_timeShift.active || m_replay == nullptr) {
+        return;
+    }
+
+    const Uint64 nowNS       = SDL_GetTicksNS();
+    const Uint64 elapsedNS   = nowNS - m_timeShift.lastUpdateNS;
+    m_timeShift.lastUpdateNS = nowNS;
+
+    const Uint64 oldestNS = m_replay->getOldestTimestamp();
+    const Uint64 newestNS = m_replay->getNewestTimestamp();
+
+    Uint64 positionNS = m_timeShift.positionNS;
+    if(m_timeShift.playing && m_timeShift.catchingUp) {
+        positionNS             += (Uint64)(elapsedNS * catchUpSpeed);
+        m_timeShift.positionNS  = positionNS;
+    }
+
+    if(m_timeShift.catchingUp && positionNS >= newestNS) {
+        exitTimeShift();
+        return;
+    }
+
+    // paused for longer than the buffer reaches back
+    if(positionNS < oldestNS) {
+        positionNS             = oldestNS;
+        m_timeShift.positionNS = positionNS;
+    }
+
+    FramePtr frame = m_replay->getFrame(positionNS, m_timeShift.frame);
+    if(frame == nullptr || frame == m_timeShift.frame) {
+        return;
+    }
+
+    m_timeShift.frame = frame;
+
+    // cropped the same way as the live view it stands in for
+    const SDL_Rect region = getCropRect(*frame, m_streams.empty() ? std::nullopt : m_streams[0]->getCrop());
+
+    SDL_Texture*& tex = m_timeShift.elementData.camera.texture;
+    if(tex == nullptr || tex->format != frame->format || tex->w != region.w || tex->h != region.h) {
+        m_texturePool.release(tex);
+        tex = m_texturePool.acquire(frame->format, region.w, region.h);
+
+        if(tex == nullptr) {
+            return;
+        }
+    }
+
+    updateTextureRegion(tex, *frame, region, nullptr);
+}
+
+void Application::playTimeShiftAudio(SDL_AudioStream* stream, int amount) {
+    std::array<Uint16, audioBufferSize> buffer;
+
+    for(int i = 0; i < amount; i += buffer.size() * sizeof(Uint16)) {
+        if(!m_timeShift.playing || m_timeShift.catchingUp || m_replay == nullptr) {
+            buffer.fill(0);
+        }
+        else {
+            // 1x playback follows the audio device so the two stay in sync
+            const Uint64 positionNS = m_timeShift.positionNS;
+            m_replay->readAudio(positionNS, (Uint8*)buffer.data(), buffer.size() * sizeof(Uint16));
+
+            m_timeShift.positionNS = positionNS + buffer.size() * sizeof(Uint16) * SDL_NS_PER_SECOND / (m_audioSpec.freq * m_audioSpec.channels * sizeof(Uint16));
+        }
+
+        SDL_PutAudioStreamData(stream, buffer.data(), buffer.size() * sizeof(Uint16));
+    }
+}
+
+std::string Application::getTimeShiftText() {
+    const Uint64 newestNS   = m_replay->getNewestTimestamp();
+    const Uint64 positionNS = m_timeShift.positionNS;
+    const float behind      = newestNS > positionNS ? (float)(newestNS - positionNS) / SDL_NS_PER_SECOND : 0.0f;
+
+    const char* state = !m_timeShift.playing ? "Paused" : m_timeShift.catchingUp ? "Catching up" : "Replay";
+
+    char text[64];
+    snprintf(text, sizeof(text), "%s  -%.1fs", state, behind);
+    return text;
+}
+
+void Application::layoutTimeShift() {
+    const std::string& text = m_overlay.inputs.timeShiftText;
+
+    // clang-format off
+    CLAY(
+        CLAY_ID("TimeShift"),
+        {
+            .layout = {
+                .padding = CLAY_PADDING_ALL(8)
+            },
+            .backgroundColor = { 0, 0, 0, 0xAF },
+            .cornerRadius = CLAY_CORNER_RADIUS(6),
+            .floating = {
+                .offset = { 8.0f, -8.0f },
+                .parentId = CLAY_ID("Body").id,
+                .zIndex = 2,
+                .attachPoints = {
+                    .element = CLAY_ATTACH_POINT_LEFT_BOTTOM,
+                    .parent = CLAY_ATTACH_POINT_LEFT_BOTTOM
+                },
+                .attachTo = CLAY_ATTACH_TO_ELEMENT_WITH_ID
+            }
+        }
+    ) {
+        Clay__OpenTextElement(
+            {
+                .isStaticallyAllocated = false,
+                .length = static_cast<int32_t>(text.size()),
+                .chars = text.c_str()
+            },
+            CLAY_TEXT_CONFIG({
+                .textColor = { 255, 255, 255, 255 },
+                .fontSize = 24
+            })
+        );
+    }
+    // clang-format on
+}
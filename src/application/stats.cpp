@@ -0,0 +1,366 @@
+#include <algorithm>
+#include <application.hpp>
+#include <cstdio>
+
+static std::string formatBytes(Uint64 bytes) {
+    const char* units[] = { "B", "KiB", "MiB", "GiB", "TiB" };
+
+    double value = (double)bytes;
+    size_t unit  = 0;
+    while(value >= 1024.0 && unit + 1 < SDL_arraysize(units)) {
+        value /= 1024.0;
+        unit++;
+    }
+
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.1f %s", value, units[unit]);
+
+    return buffer;
+}
+
+std::string Application::collectStats() {
+    std::string stats;
+    char line[256];
+
+    snprintf(line, sizeof(line), "Uploaded %s last frame, %zu deferred\n", formatBytes(m_uploadScheduler.getUploadedBytes()).c_str(), m_uploadScheduler.getDeferredUploads());
+    stats += line;
+
+    TexturePool::Stats textures = m_texturePool.getStats();
+    snprintf(
+        line,
+        sizeof(line),
+        "Textures: %zu (%zu idle), %s of %s, %llu reused, %llu created, %llu evicted\n",
+        textures.textures,
+        textures.idleTextures,
+        formatBytes(textures.bytes).c_str(),
+        formatBytes(textures.capacity).c_str(),
+        (unsigned long long)textures.hits,
+        (unsigned long long)textures.misses,
+        (unsigned long long)textures.evictions
+    );
+
+    stats += line;
+
+    Clay_SDL3TextCacheStats texts = SDL_Clay_GetTextCacheStats(&m_renderData);
+    snprintf(
+        line,
+        sizeof(line),
+        "Texts: %zu cached in %zu font sizes, %llu reused, %llu created, %llu evicted, %llu measured from %llu glyphs\n",
+        texts.texts,
+        texts.fonts,
+        (unsigned long long)texts.hits,
+        (unsigned long long)texts.misses,
+        (unsigned long long)texts.evictions,
+        (unsigned long long)texts.measurements,
+        (unsigned long long)texts.glyphsLoaded
+    );
+
+    stats += line;
+
+    snprintf(line, sizeof(line), "Overlay: %llu layouts, %llu frames reused\n", (unsigned long long)m_overlay.layouts, (unsigned long long)m_overlay.reuses);
+    stats += line;
+
+    Clay_SDL3GeometryStats geometry = SDL_Clay_GetGeometryStats(&m_renderData);
+    snprintf(
+        line,
+        sizeof(line),
+        "Geometry: %llu shapes in %llu draw calls, %llu vertices, %llu texts and %llu textures drawn\n",
+        (unsigned long long)geometry.primitives,
+        (unsigned long long)geometry.drawCalls,
+        (unsigned long long)geometry.vertices,
+        (unsigned long long)geometry.textDraws,
+        (unsigned long long)geometry.textureDraws
+    );
+
+    stats += line;
+
+    // what the relay holds on to besides camera frames in flight, to keep an eye on the footprint of small boxes
+    size_t audioBytes = (size_t)std::max(0, m_audioPlayback.bufferSize) + (size_t)std::max(0, m_audioRecording.bufferSize);
+    {
+        std::lock_guard lock(m_audioMutex);
+        audioBytes += m_audioBuffers.size() * sizeof(m_audioBuffers.front());
+    }
+
+    if(m_audioSocket != nullptr) {
+        audioBytes += m_audioSocket->getStats().ringBytes;
+    }
+
+    if(m_pipeOutput != nullptr) {
+        audioBytes += m_pipeOutput->getStats().audioRingBytes;
+    }
+
+    if(m_udpAudioReceiver != nullptr) {
+        audioBytes += m_udpAudioReceiver->getStats().bufferBytes;
+    }
+
+    snprintf(
+        line,
+        sizeof(line),
+        "Memory: clay %s (%llu cache resets), textures %s, audio %s, fonts %s, replay %s\n",
+        formatBytes(m_clay.size).c_str(),
+        (unsigned long long)m_clay.measureCacheResets,
+        formatBytes(textures.bytes).c_str(),
+        formatBytes(audioBytes).c_str(),
+        formatBytes(texts.bytes).c_str(),
+        formatBytes(m_replay != nullptr ? m_replay->getStats().capacity : 0).c_str()
+    );
+
+    stats += line;
+
+    const std::vector<std::unique_ptr<CameraStream>>& streams = m_picker.open ? m_picker.streams : m_streams;
+    for(size_t i = 0; i < streams.size(); i++) {
+        const SDL_CameraSpec& spec = streams[i]->getSpec();
+
+        snprintf(line, sizeof(line), "Camera %zu: %dx%d %s, %.1f fps\n", i, spec.width, spec.height, SDL_GetPixelFormatName(spec.format), streams[i]->getFrameRate());
+        stats += line;
+
+        CameraStream::UploadStats uploads = streams[i]->getUploadStats();
+        if(uploads.uploadedBytes + uploads.skippedBytes > 0) {
+            const double saved = 100.0 * uploads.skippedBytes / (uploads.uploadedBytes + uploads.skippedBytes);
+
+            snprintf(line, sizeof(line), "  Uploads: %s sent, %s skipped (%.0f%% saved)\n", formatBytes(uploads.uploadedBytes).c_str(), formatBytes(uploads.skippedBytes).c_str(), saved);
+            stats += line;
+        }
+
+        Deinterlacer::Stats deinterlace = streams[i]->getDeinterlacer().getStats();
+        if(deinterlace.frames > 0) {
+            const char* mode = deinterlace.mode == DeinterlaceMode::ADAPTIVE ? "adaptive" : "bob";
+
+            snprintf(line, sizeof(line), "  Deinterlace %s: %.2f ms last, %.2f ms avg, %.2f ms max\n", mode, deinterlace.lastMS, deinterlace.averageMS, deinterlace.maxMS);
+            stats += line;
+        }
+    }
+
+    if(m_recorder != nullptr) {
+        RawRecorder::Stats recording = m_recorder->getStats();
+
+        snprintf(
+            line,
+            sizeof(line),
+            "Recording: %llu frames, %s, %llu dropped, %llu errors, queue %zu (peak %zu), %zu in flight, %s %s\n",
+            (unsigned long long)recording.framesWritten,
+            formatBytes(recording.bytesWritten).c_str(),
+            (unsigned long long)recording.framesDropped,
+            (unsigned long long)recording.writeErrors,
+            recording.queuedFrames,
+            recording.maxQueuedFrames,
+            recording.inFlightWrites,
+            recording.uring ? "io_uring" : "pwrite",
+            recording.direct ? "O_DIRECT" : "buffered"
+        );
+
+        stats += line;
+    }
+
+    if(m_mjpegRecorder != nullptr) {
+        MjpegRecorder::Stats recording = m_mjpegRecorder->getStats();
+
+        snprintf(
+            line,
+            sizeof(line),
+            "Recording MJPEG: %llu frames, %s, %llu dropped, audio %llu packets, %llu dropped, queue %zu/%zu\n",
+            (unsigned long long)recording.framesWritten,
+            formatBytes(recording.bytesWritten).c_str(),
+            (unsigned long long)recording.framesDropped,
+            (unsigned long long)recording.audioPacketsWritten,
+            (unsigned long long)recording.audioPacketsDropped,
+            recording.queuedFrames,
+            recording.queuedAudioPackets
+        );
+
+        stats += line;
+    }
+
+    ScreenshotWriter::Stats screenshots = m_screenshots.getStats();
+    if(screenshots.saved > 0 || screenshots.queued > 0) {
+        snprintf(
+            line,
+            sizeof(line),
+            "Screenshots: %llu saved, %llu dropped, %llu failed, queue %zu, %.1f ms each\n",
+            (unsigned long long)screenshots.saved,
+            (unsigned long long)screenshots.dropped,
+            (unsigned long long)screenshots.failed,
+            screenshots.queued,
+            screenshots.averageEncodeMS
+        );
+
+        stats += line;
+    }
+
+    if(m_replay != nullptr) {
+        ReplayBuffer::Stats replay = m_replay->getStats();
+
+        snprintf(
+            line,
+            sizeof(line),
+            "Replay: %.1fs, %zu frames, %s of %s (%.1fx), %llu dropped\n",
+            (double)replay.durationNS / SDL_NS_PER_SECOND,
+            replay.storedFrames,
+            formatBytes(replay.usedBytes).c_str(),
+            formatBytes(replay.capacity).c_str(),
+            replay.usedBytes > 0 ? (double)replay.rawBytes / replay.usedBytes : 1.0,
+            (unsigned long long)replay.framesDropped
+        );
+
+        stats += line;
+    }
+
+    if(m_shmExporter != nullptr) {
+        ShmExporter::Stats shm = m_shmExporter->getStats();
+
+        snprintf(
+            line,
+            sizeof(line),
+            "Shared memory %s: %llu frames, %s, %llu dropped, %zu slots of %s\n",
+            m_shmExporter->getName().c_str(),
+            (unsigned long long)shm.framesExported,
+            formatBytes(shm.bytesExported).c_str(),
+            (unsigned long long)shm.framesDropped,
+            shm.slotCount,
+            formatBytes(shm.slotSize).c_str()
+        );
+
+        stats += line;
+    }
+
+    if(m_audioSocket != nullptr) {
+        AudioSocketServer::Stats audio = m_audioSocket->getStats();
+
+        snprintf(
+            line,
+            sizeof(line),
+            "Audio socket: %zu clients, %s sent, %llu chunks dropped, %s overrun\n",
+            audio.clients,
+            formatBytes(audio.bytesSent).c_str(),
+            (unsigned long long)audio.chunksDropped,
+            formatBytes(audio.bytesOverrun).c_str()
+        );
+
+        stats += line;
+    }
+
+    if(m_pipeOutput != nullptr) {
+        PipeOutput::Stats pipe = m_pipeOutput->getStats();
+
+        snprintf(
+            line,
+            sizeof(line),
+            "Pipes: video %s, %llu frames, %s, %llu dropped, %llu skipped; audio %s, %s, %s dropped\n",
+            pipe.videoConnected ? "connected" : "waiting",
+            (unsigned long long)pipe.framesWritten,
+            formatBytes(pipe.videoBytesWritten).c_str(),
+            (unsigned long long)pipe.framesDropped,
+            (unsigned long long)pipe.framesSkipped,
+            pipe.audioConnected ? "connected" : "waiting",
+            formatBytes(pipe.audioBytesWritten).c_str(),
+            formatBytes(pipe.audioBytesDropped).c_str()
+        );
+
+        stats += line;
+    }
+
+    if(m_httpPreview != nullptr) {
+        MjpegHttpServer::Stats http = m_httpPreview->getStats();
+
+        snprintf(
+            line,
+            sizeof(line),
+            "HTTP preview :%u: %zu clients, %llu frames, %s, %llu dropped, %llu passed through, %llu encoded (%.1fms), %llu skipped\n",
+            m_httpPreview->getPort(),
+            http.clients,
+            (unsigned long long)http.framesSent,
+            formatBytes(http.bytesSent).c_str(),
+            (unsigned long long)http.framesDropped,
+            (unsigned long long)http.framesPassedThrough,
+            (unsigned long long)http.framesEncoded,
+            http.averageEncodeMS,
+            (unsigned long long)http.framesSkipped
+        );
+
+        stats += line;
+    }
+
+    if(m_udpAudioSender != nullptr) {
+        UdpAudioSender::Stats udp = m_udpAudioSender->getStats();
+
+        snprintf(
+            line,
+            sizeof(line),
+            "UDP audio to %s: %llu packets, %llu failed, %llu lost and %llu reordered on purpose\n",
+            m_udpAudioSender->getDestination().c_str(),
+            (unsigned long long)udp.packetsSent,
+            (unsigned long long)udp.packetsFailed,
+            (unsigned long long)udp.packetsLost,
+            (unsigned long long)udp.packetsReordered
+        );
+
+        stats += line;
+    }
+
+    if(m_udpAudioReceiver != nullptr) {
+        UdpAudioReceiver::Stats udp = m_udpAudioReceiver->getStats();
+
+        snprintf(
+            line,
+            sizeof(line),
+            "UDP audio on :%u: %s, %llu packets, %llu lost, %llu late, %llu skipped, %llu underruns, %.1fms jitter, %.0fms buffered\n",
+            m_udpAudioReceiver->getPort(),
+            udp.receiving ? "receiving" : "waiting",
+            (unsigned long long)udp.packetsReceived,
+            (unsigned long long)udp.packetsLost,
+            (unsigned long long)udp.packetsLate,
+            (unsigned long long)udp.packetsSkipped,
+            (unsigned long long)udp.underruns,
+            udp.jitterMS,
+            udp.bufferedMS
+        );
+
+        stats += line;
+    }
+
+    // clay would give the trailing newline its own empty line
+    if(!stats.empty()) {
+        stats.pop_back();
+    }
+
+    return stats;
+}
+
+void Application::layoutStats() {
+    const std::string& text = m_overlay.inputs.statsText;
+
+    // clang-format off
+    CLAY(
+        CLAY_ID("Stats"),
+        {
+            .layout = {
+                .padding = CLAY_PADDING_ALL(8)
+            },
+            .backgroundColor = { 0, 0, 0, 0xAF },
+            .cornerRadius = CLAY_CORNER_RADIUS(6),
+            .floating = {
+                .offset = { 8.0f, 8.0f },
+                .parentId = CLAY_ID("Body").id,
+                .zIndex = 2,
+                .attachPoints = {
+                    .element = CLAY_ATTACH_POINT_LEFT_TOP,
+                    .parent = CLAY_ATTACH_POINT_LEFT_TOP
+                },
+                .attachTo = CLAY_ATTACH_TO_ELEMENT_WITH_ID
+            }
+        }
+    ) {
+        Clay__OpenTextElement(
+            {
+                .isStaticallyAllocated = false,
+                .length = static_cast<int32_t>(text.size()),
+                .chars = text.c_str()
+            },
+            CLAY_TEXT_CONFIG({
+                .textColor = { 255, 255, 255, 255 },
+                .fontSize = 16
+            })
+        );
+    }
+    // clang-format on
+}
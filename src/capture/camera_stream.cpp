@@ -0,0 +1,331 @@
+#include <SDL3/SDL_camera.h>
+
+#include <algorithm>
+#include <camera_stream.hpp>
+#include <crop.hpp>
+#include <cstring>
+#include <tile_diff.hpp>
+
+CameraStream::CameraStream(SDL_CameraID id, const SDL_CameraSpec& spec, TexturePool* texturePool)
+    : m_id(id)
+    , m_spec(spec)
+    , m_texturePool(texturePool)
+    , m_framePool(FramePool::create())
+    , m_running(false)
+    , m_frameRate(0.0f)
+    , m_elementData({
+          .type   = CUSTOM_ELEMENT_TYPE_CAMERA,
+          .camera = { nullptr }
+}) {
+    m_device = SDL_OpenCamera(id, &spec);
+    if(m_device == nullptr) {
+        SDL_Log("Couldn't open camera %s: %s", SDL_GetCameraName(id), SDL_GetError());
+        return;
+    }
+
+    m_running = true;
+    m_thread  = std::thread(&CameraStream::captureThread, this);
+}
+
+CameraStream::~CameraStream() {
+    m_running = false;
+    if(m_thread.joinable()) {
+        m_thread.join();
+    }
+
+    if(m_device != nullptr) {
+        SDL_CloseCamera(m_device);
+    }
+
+    m_texturePool->release(m_elementData.camera.texture);
+}
+
+bool CameraStream::isOpen() const { return m_device != nullptr; }
+
+SDL_CameraID CameraStream::getID() const { return m_id; }
+SDL_Camera* CameraStream::getDevice() const { return m_device; }
+const SDL_CameraSpec& CameraStream::getSpec() const { return m_spec; }
+
+void CameraStream::addSink(FrameSink* sink) {
+    std::lock_guard lock(m_sinkMutex);
+    m_sinks.push_back(sink);
+}
+
+void CameraStream::removeSink(FrameSink* sink) {
+    std::lock_guard lock(m_sinkMutex);
+    m_sinks.erase(std::remove(m_sinks.begin(), m_sinks.end(), sink), m_sinks.end());
+}
+
+FramePtr CameraStream::getLatestFrame() {
+    std::lock_guard lock(m_frameMutex);
+    return m_latestFrame;
+}
+
+float CameraStream::getFrameRate() const { return m_frameRate; }
+
+size_t CameraStream::getPendingBytes() {
+    std::lock_guard lock(m_frameMutex);
+
+    if(m_pendingFrame == nullptr) {
+        return 0;
+    }
+
+    const SDL_Rect region = getCropRect(*m_pendingFrame, m_crop);
+    const size_t bytes    = region.w == m_pendingFrame->width && region.h == m_pendingFrame->height ? m_pendingFrame->size : TexturePool::getTextureBytes(m_pendingFrame->format, region.w, region.h);
+
+    if(m_pendingFull) {
+        return bytes;
+    }
+
+    return std::min(bytes, m_pendingDirtyTiles * getTileBytes(*m_pendingFrame));
+}
+
+size_t CameraStream::upload() {
+    m_frameMutex.lock();
+    FramePtr frame = std::move(m_pendingFrame);
+    bool full      = m_pendingFull;
+
+    if(frame != nullptr) {
+        m_uploadTiles.swap(m_pendingTiles);
+        m_pendingTiles.assign(m_uploadTiles.size(), 0);
+        m_pendingDirtyTiles = 0;
+        m_pendingFull       = false;
+    }
+    m_frameMutex.unlock();
+
+    if(frame == nullptr) {
+        return 0;
+    }
+
+    // the texture only holds the cropped region, so everything outside it is never converted or uploaded
+    const SDL_Rect region = getCropRect(*frame, m_crop);
+
+    SDL_Texture*& tex = m_elementData.camera.texture;
+    if(tex == nullptr || tex->format != frame->format || tex->w != region.w || tex->h != region.h) {
+        // a capture card switching modes and back gets its old texture again
+        m_texturePool->release(tex);
+        tex = m_texturePool->acquire(frame->format, region.w, region.h);
+
+        if(tex == nullptr) {
+            // whatever comes next has to be sent whole
+            std::lock_guard lock(m_frameMutex);
+            m_pendingFull = true;
+            return 0;
+        }
+
+        full = true;
+    }
+
+    size_t sent = 0;
+    if(full) {
+        sent = updateTextureRegion(tex, *frame, region, nullptr);
+    }
+    else if(isTileDiffSupported(frame->format)) {
+        sent = uploadTiles(tex, *frame, region);
+    }
+
+    m_uploadedBytes += sent;
+    m_skippedBytes  += frame->size - std::min(sent, frame->size);
+    return sent;
+}
+
+void CameraStream::setCrop(const std::optional<SDL_FRect>& crop) {
+    m_crop = crop;
+
+    // the texture changes size, so the newest frame has to go up again in full
+    std::lock_guard lock(m_frameMutex);
+    m_pendingFrame = m_latestFrame;
+    m_pendingFull  = true;
+}
+
+const std::optional<SDL_FRect>& CameraStream::getCrop() const { return m_crop; }
+
+CameraStream::UploadStats CameraStream::getUploadStats() const {
+    return UploadStats{
+        .uploadedBytes = m_uploadedBytes,
+        .skippedBytes  = m_skippedBytes
+    };
+}
+
+CustomElementData* CameraStream::getElementData() { return &m_elementData; }
+
+Deinterlacer& CameraStream::getDeinterlacer() { return m_deinterlacer; }
+
+void CameraStream::captureThread() {
+    // how long to sleep when the camera has nothing new, short enough to not add visible latency at 60fps
+    constexpr Uint64 idleWaitNS = SDL_NS_PER_MS;
+
+    Uint64 rateStartNS  = SDL_GetTicksNS();
+    Uint64 rateSequence = m_sequence;
+
+    Uint64 lastTimestampNS = 0;
+
+    while(m_running) {
+        if(SDL_GetCameraPermissionState(m_device) != 1) {
+            SDL_DelayNS(idleWaitNS * 10);
+            continue;
+        }
+
+        Uint64 timestampNS   = 0;
+        SDL_Surface* surface = SDL_AcquireCameraFrame(m_device, &timestampNS);
+        if(surface == nullptr) {
+            if(m_deferredFrame != nullptr && SDL_GetTicksNS() >= m_deferredDueNS) {
+                showFrame(m_deferredFrame);
+                m_deferredFrame.reset();
+            }
+
+            SDL_DelayNS(idleWaitNS);
+            continue;
+        }
+
+        FramePtr frame = m_framePool->acquire(getFrameSize(surface->format, surface->h, surface->pitch));
+
+        frame->format      = surface->format;
+        frame->width       = surface->w;
+        frame->height      = surface->h;
+        frame->pitch       = surface->pitch;
+        frame->timestampNS = timestampNS != 0 ? timestampNS : SDL_GetTicksNS();
+        frame->sequence    = m_sequence++;
+
+        memcpy(frame->pixels, surface->pixels, frame->size);
+        SDL_ReleaseCameraFrame(m_device, surface);
+
+        // a late second field still goes out before the next frame
+        if(m_deferredFrame != nullptr) {
+            showFrame(m_deferredFrame);
+            m_deferredFrame.reset();
+        }
+
+        // half the time between woven frames, assume 30 frames per second until there are two timestamps
+        const Uint64 fieldNS = lastTimestampNS != 0 && frame->timestampNS > lastTimestampNS ? std::min<Uint64>((frame->timestampNS - lastTimestampNS) / 2, 50 * SDL_NS_PER_MS) : SDL_NS_PER_SECOND / 60;
+        lastTimestampNS      = frame->timestampNS;
+
+        FramePtr fields[2];
+        if(m_deinterlacer.process(frame, *m_framePool, fields) == 0) {
+            showFrame(frame);
+        }
+        else {
+            fields[0]->sequence     = frame->sequence;
+            fields[1]->sequence     = frame->sequence;
+            fields[1]->timestampNS += fieldNS;
+
+            showFrame(fields[0]);
+
+            m_deferredFrame = std::move(fields[1]);
+            m_deferredDueNS = SDL_GetTicksNS() + fieldNS;
+        }
+
+        // recordings and exports get the frame as captured, deinterlacing is only for the screen
+        {
+            std::lock_guard lock(m_sinkMutex);
+            for(FrameSink* sink : m_sinks) {
+                sink->onFrame(frame);
+            }
+        }
+
+        const Uint64 nowNS = SDL_GetTicksNS();
+        if(nowNS - rateStartNS >= SDL_NS_PER_SECOND) {
+            m_frameRate = (float)(m_sequence - rateSequence) * SDL_NS_PER_SECOND / (nowNS - rateStartNS);
+
+            rateStartNS  = nowNS;
+            rateSequence = m_sequence;
+        }
+    }
+}
+
+size_t CameraStream::uploadTiles(SDL_Texture* texture, const Frame& frame, const SDL_Rect& region) {
+    const int columns = getTileColumns(frame);
+    const int rows    = getTileRows(frame);
+    if(m_uploadTiles.size() != (size_t)columns * rows) {
+        return 0;
+    }
+
+    size_t sent = 0;
+
+    for(int row = 0; row < rows;) {
+        const Uint8* dirty = &m_uploadTiles[(size_t)row * columns];
+
+        int first = 0;
+        while(first < columns && dirty[first] == 0) {
+            first++;
+        }
+
+        if(first == columns) {
+            row++;
+            continue;
+        }
+
+        int last = columns - 1;
+        while(dirty[last] == 0) {
+            last--;
+        }
+
+        // following tile rows that changed in exactly the same columns go out with the same update
+        int end = row + 1;
+        while(end < rows) {
+            const Uint8* next = &m_uploadTiles[(size_t)end * columns];
+            if(std::find(next, next + first, 1) != next + first || std::find(next + last + 1, next + columns, 1) != next + columns || next[first] == 0 || next[last] == 0) {
+                break;
+            }
+
+            end++;
+        }
+
+        SDL_Rect tiles;
+        tiles.x = first * tileWidth;
+        tiles.y = row * tileHeight;
+        tiles.w = std::min((last + 1) * tileWidth, frame.width) - tiles.x;
+        tiles.h = std::min(end * tileHeight, frame.height) - tiles.y;
+
+        row = end;
+
+        // tiles and crop are both aligned to whole chroma samples, so the overlap is too
+        SDL_Rect source;
+        if(!SDL_GetRectIntersection(&tiles, &region, &source)) {
+            continue;
+        }
+
+        const SDL_Rect destination = { source.x - region.x, source.y - region.y, source.w, source.h };
+        sent += updateTextureRegion(texture, frame, source, &destination);
+    }
+
+    return sent;
+}
+
+void CameraStream::showFrame(const FramePtr& frame) {
+    // m_latestFrame only changes on this thread so it can be read without the lock
+    const Frame* previous = m_latestFrame.get();
+
+    bool full      = previous == nullptr || previous->format != frame->format || previous->width != frame->width || previous->height != frame->height || previous->pitch != frame->pitch;
+    size_t changed = 0;
+
+    if(!full) {
+        if(isTileDiffSupported(frame->format)) {
+            m_frameTiles.assign((size_t)getTileColumns(*frame) * getTileRows(*frame), 0);
+            changed = compareTiles(*frame, *previous, m_frameTiles.data());
+        }
+        else {
+            full = !isSameFrame(*frame, *previous);
+        }
+    }
+
+    m_frameMutex.lock();
+    if(full) {
+        m_pendingFull = true;
+    }
+    else if(changed > 0 && !m_pendingFull) {
+        if(m_pendingTiles.size() != m_frameTiles.size()) {
+            m_pendingTiles.assign(m_frameTiles.size(), 0);
+            m_pendingDirtyTiles = 0;
+        }
+
+        for(size_t i = 0; i < m_frameTiles.size(); i++) {
+            m_pendingDirtyTiles += m_frameTiles[i] & ~m_pendingTiles[i];
+            m_pendingTiles[i]   |= m_frameTiles[i];
+        }
+    }
+
+    m_latestFrame  = frame;
+    m_pendingFrame = frame;
+    m_frameMutex.unlock();
+}
@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <cmath>
+#include <crop.hpp>
+#include <cstring>
+#include <texture_pool.hpp>
+#include <tile_diff.hpp>
+
+// limited range black is 16, leave some room for noise and compression
+static constexpr Uint8 blackThreshold = 32;
+
+bool isCropSupported(SDL_PixelFormat format) { return isTileDiffSupported(format); }
+
+SDL_Rect getCropRect(const Frame& frame, const std::optional<SDL_FRect>& crop) {
+    if(!crop.has_value() || !isCropSupported(frame.format)) {
+        return { 0, 0, frame.width, frame.height };
+    }
+
+    int left   = (int)std::lround(std::clamp(crop->x, 0.0f, 1.0f) * frame.width);
+    int top    = (int)std::lround(std::clamp(crop->y, 0.0f, 1.0f) * frame.height);
+    int right  = (int)std::lround(std::clamp(crop->x + crop->w, 0.0f, 1.0f) * frame.width);
+    int bottom = (int)std::lround(std::clamp(crop->y + crop->h, 0.0f, 1.0f) * frame.height);
+
+    // 4:2:2 shares chroma between pixel pairs, 4:2:0 also between row pairs
+    const bool nv    = frame.format == SDL_PIXELFORMAT_NV12 || frame.format == SDL_PIXELFORMAT_NV21;
+    const bool evenX = nv || frame.format == SDL_PIXELFORMAT_YUY2 || frame.format == SDL_PIXELFORMAT_UYVY || frame.format == SDL_PIXELFORMAT_YVYU;
+    const bool evenY = nv;
+
+    if(evenX) {
+        left  &= ~1;
+        right  = std::min(right + 1, frame.width) & ~1;
+    }
+
+    if(evenY) {
+        top    &= ~1;
+        bottom  = std::min(bottom + 1, frame.height) & ~1;
+    }
+
+    if(right - left < 16 || bottom - top < 16) {
+        return { 0, 0, frame.width, frame.height };
+    }
+
+    return { left, top, right - left, bottom - top };
+}
+
+size_t updateTextureRegion(SDL_Texture* texture, const Frame& frame, const SDL_Rect& source, const SDL_Rect* destination) {
+    const Uint8* pixels = frame.pixels + (size_t)source.y * frame.pitch + (size_t)source.x * SDL_BYTESPERPIXEL(frame.format);
+
+    if(frame.format == SDL_PIXELFORMAT_NV12 || frame.format == SDL_PIXELFORMAT_NV21) {
+        const Uint8* chroma = frame.pixels + (size_t)frame.pitch * frame.height + (size_t)(source.y / 2) * frame.pitch + source.x;
+        SDL_UpdateNVTexture(texture, destination, pixels, frame.pitch, chroma, frame.pitch);
+    }
+    else {
+        SDL_UpdateTexture(texture, destination, pixels, frame.pitch);
+    }
+
+    if(source.w == frame.width && source.h == frame.height) {
+        return frame.size;
+    }
+
+    return TexturePool::getTextureBytes(frame.format, source.w, source.h);
+}
+
+// brightness of one pixel, only needs to tell black from not black
+static Uint8 getLuma(const Frame& frame, const SDL_PixelFormatDetails* details, int x, int y) {
+    const Uint8* row = frame.pixels + (size_t)y * frame.pitch;
+
+    switch(frame.format) {
+    case SDL_PIXELFORMAT_YUY2:
+    case SDL_PIXELFORMAT_YVYU:
+        return row[x * 2];
+    case SDL_PIXELFORMAT_UYVY:
+        return row[x * 2 + 1];
+    case SDL_PIXELFORMAT_NV12:
+    case SDL_PIXELFORMAT_NV21:
+        return row[x];
+    default: {
+        Uint32 pixel = 0;
+        memcpy(&pixel, row + (size_t)x * details->bytes_per_pixel, std::min<size_t>(details->bytes_per_pixel, sizeof(pixel)));
+
+        Uint8 r, g, b;
+        SDL_GetRGB(pixel, details, nullptr, &r, &g, &b);
+
+        return (Uint8)((r * 77 + g * 150 + b * 29) >> 8);
+    }
+    }
+}
+
+bool detectCrop(const Frame& frame, SDL_FRect* out) {
+    if(!isCropSupported(frame.format) || frame.width < 16 || frame.height < 16) {
+        return false;
+    }
+
+    const SDL_PixelFormatDetails* details = SDL_GetPixelFormatDetails(frame.format);
+    if(details == nullptr) {
+        return false;
+    }
+
+    // a line counts as border when at most 1 in 100 of its pixels is brighter than black, so a logo or
+    // a few hot pixels dont stop it. every other pixel along the line is enough
+    auto isBlackRow = [&](int y, int left, int right) {
+        int bright = 0;
+        for(int x = left; x < right; x += 2) {
+            bright += getLuma(frame, details, x, y) > blackThreshold;
+        }
+
+        return bright * 2 * 100 <= right - left;
+    };
+
+    auto isBlackColumn = [&](int x, int top, int bottom) {
+        int bright = 0;
+        for(int y = top; y < bottom; y += 2) {
+            bright += getLuma(frame, details, x, y) > blackThreshold;
+        }
+
+        return bright * 2 * 100 <= bottom - top;
+    };
+
+    int top    = 0;
+    int bottom = frame.height;
+    while(top < bottom && isBlackRow(top, 0, frame.width)) {
+        top++;
+    }
+
+    while(bottom > top && isBlackRow(bottom - 1, 0, frame.width)) {
+        bottom--;
+    }
+
+    int left  = 0;
+    int right = frame.width;
+    while(left < right && isBlackColumn(left, top, bottom)) {
+        left++;
+    }
+
+    while(right > left && isBlackColumn(right - 1, top, bottom)) {
+        right--;
+    }
+
+    // nothing to cut, or so little picture left that its more likely a dark scene than borders
+    const bool whole = left == 0 && top == 0 && right == frame.width && bottom == frame.height;
+    if(whole || (right - left) * 4 < frame.width || (bottom - top) * 4 < frame.height) {
+        return false;
+    }
+
+    *out = {
+        (float)left / frame.width,
+        (float)top / frame.height,
+        (float)(right - left) / frame.width,
+        (float)(bottom - top) / frame.height
+    };
+
+    return true;
+}
@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <cstring>
+#include <deinterlacer.hpp>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// per byte difference from the previous frame above which a pixel counts as moving
+static constexpr Uint8 motionThreshold = 12;
+
+// missing line as the rounded average of the lines above and below it
+static void interpolateRow(const Uint8* above, const Uint8* below, Uint8* out, size_t size) {
+    size_t i = 0;
+
+#if defined(__SSE2__)
+    for(; i + 16 <= size; i += 16) {
+        const __m128i a = _mm_loadu_si128((const __m128i*)(above + i));
+        const __m128i b = _mm_loadu_si128((const __m128i*)(below + i));
+        _mm_storeu_si128((__m128i*)(out + i), _mm_avg_epu8(a, b));
+    }
+#elif defined(__ARM_NEON)
+    for(; i + 16 <= size; i += 16) {
+        vst1q_u8(out + i, vrhaddq_u8(vld1q_u8(above + i), vld1q_u8(below + i)));
+    }
+#endif
+
+    for(; i < size; i++) {
+        out[i] = (Uint8)((above[i] + below[i] + 1) >> 1);
+    }
+}
+
+// takes the other fields line where nothing moved since the previous frame, interpolates where it did
+static void adaptiveRow(const Uint8* above, const Uint8* below, const Uint8* woven, const Uint8* previous, Uint8* out, size_t size) {
+    size_t i = 0;
+
+#if defined(__SSE2__)
+    const __m128i threshold = _mm_set1_epi8((char)motionThreshold);
+    const __m128i zero      = _mm_setzero_si128();
+
+    for(; i + 16 <= size; i += 16) {
+        const __m128i a = _mm_loadu_si128((const __m128i*)(above + i));
+        const __m128i b = _mm_loadu_si128((const __m128i*)(below + i));
+        const __m128i w = _mm_loadu_si128((const __m128i*)(woven + i));
+        const __m128i p = _mm_loadu_si128((const __m128i*)(previous + i));
+
+        // |w - p| > threshold, saturating subtraction both ways since there is no unsigned compare
+        const __m128i difference = _mm_or_si128(_mm_subs_epu8(w, p), _mm_subs_epu8(p, w));
+        const __m128i still      = _mm_cmpeq_epi8(_mm_subs_epu8(difference, threshold), zero);
+
+        const __m128i result = _mm_or_si128(_mm_and_si128(still, w), _mm_andnot_si128(still, _mm_avg_epu8(a, b)));
+        _mm_storeu_si128((__m128i*)(out + i), result);
+    }
+#elif defined(__ARM_NEON)
+    const uint8x16_t threshold = vdupq_n_u8(motionThreshold);
+
+    for(; i + 16 <= size; i += 16) {
+        const uint8x16_t w     = vld1q_u8(woven + i);
+        const uint8x16_t still = vcleq_u8(vabdq_u8(w, vld1q_u8(previous + i)), threshold);
+        const uint8x16_t bob   = vrhaddq_u8(vld1q_u8(above + i), vld1q_u8(below + i));
+
+        vst1q_u8(out + i, vbslq_u8(still, w, bob));
+    }
+#endif
+
+    for(; i < size; i++) {
+        const int difference = std::abs(woven[i] - previous[i]);
+        out[i]               = difference <= motionThreshold ? woven[i] : (Uint8)((above[i] + below[i] + 1) >> 1);
+    }
+}
+
+Deinterlacer::Deinterlacer()
+    : m_mode(DeinterlaceMode::OFF)
+    , m_topFieldFirst(true)
+    , m_frames(0)
+    , m_lastNS(0)
+    , m_totalNS(0)
+    , m_maxNS(0) {}
+
+void Deinterlacer::setMode(DeinterlaceMode mode) {
+    if(m_mode.exchange(mode) == mode) {
+        return;
+    }
+
+    m_frames  = 0;
+    m_lastNS  = 0;
+    m_totalNS = 0;
+    m_maxNS   = 0;
+}
+
+DeinterlaceMode Deinterlacer::getMode() const { return m_mode; }
+
+void Deinterlacer::setTopFieldFirst(bool topFieldFirst) { m_topFieldFirst = topFieldFirst; }
+
+bool Deinterlacer::isSupported(SDL_PixelFormat format) {
+    switch(format) {
+    case SDL_PIXELFORMAT_YUY2:
+    case SDL_PIXELFORMAT_UYVY:
+    case SDL_PIXELFORMAT_YVYU:
+    case SDL_PIXELFORMAT_NV12:
+    case SDL_PIXELFORMAT_NV21:
+        return true;
+    default:
+        return false;
+    }
+}
+
+int Deinterlacer::process(const FramePtr& frame, FramePool& pool, FramePtr out[2]) {
+    const DeinterlaceMode mode = m_mode;
+    if(mode == DeinterlaceMode::OFF || mode == DeinterlaceMode::WEAVE || !isSupported(frame->format) || frame->height < 4) {
+        m_previous.reset();
+        return 0;
+    }
+
+    const Uint64 startNS = SDL_GetTicksNS();
+
+    if(m_previous != nullptr && (m_previous->format != frame->format || m_previous->width != frame->width || m_previous->height != frame->height || m_previous->pitch != frame->pitch)) {
+        m_previous.reset();
+    }
+
+    // without a previous frame there is nothing to detect motion against, so the first one is plain bob
+    const Frame* previous = mode == DeinterlaceMode::ADAPTIVE ? m_previous.get() : nullptr;
+    const int firstParity = m_topFieldFirst ? 0 : 1;
+
+    for(int field = 0; field < 2; field++) {
+        out[field] = pool.acquire(frame->size);
+
+        out[field]->format      = frame->format;
+        out[field]->width       = frame->width;
+        out[field]->height      = frame->height;
+        out[field]->pitch       = frame->pitch;
+        out[field]->timestampNS = frame->timestampNS;
+
+        buildField(*frame, previous, firstParity ^ field, *out[field]);
+    }
+
+    m_previous = frame;
+
+    const Uint64 elapsedNS = SDL_GetTicksNS() - startNS;
+    m_frames++;
+    m_lastNS   = elapsedNS;
+    m_totalNS += elapsedNS;
+    m_maxNS    = std::max(m_maxNS.load(), elapsedNS);
+
+    return 2;
+}
+
+void Deinterlacer::buildField(const Frame& frame, const Frame* previous, int parity, Frame& out) {
+    struct Plane {
+        size_t offset;
+        int rows;
+    };
+
+    Plane planes[2] = {
+        { 0, frame.height }
+    };
+
+    int planeCount = 1;
+
+    // chroma rows of interlaced 4:2:0 alternate between the fields just like luma
+    if(frame.format == SDL_PIXELFORMAT_NV12 || frame.format == SDL_PIXELFORMAT_NV21) {
+        planes[1]  = { (size_t)frame.pitch * frame.height, (frame.height + 1) / 2 };
+        planeCount = 2;
+    }
+
+    const size_t pitch = frame.pitch;
+
+    for(int i = 0; i < planeCount; i++) {
+        const Uint8* source = frame.pixels + planes[i].offset;
+        const Uint8* last   = previous != nullptr ? previous->pixels + planes[i].offset : nullptr;
+        Uint8* destination  = out.pixels + planes[i].offset;
+        const int rows      = planes[i].rows;
+
+        for(int y = 0; y < rows; y++) {
+            Uint8* row = destination + y * pitch;
+
+            if((y & 1) == parity) {
+                memcpy(row, source + y * pitch, pitch);
+                continue;
+            }
+
+            // nearest lines of this field, the edges just repeat the one line they have
+            const int above = y - 1 >= 0 ? y - 1 : y + 1;
+            const int below = y + 1 < rows ? y + 1 : y - 1;
+
+            if(last != nullptr) {
+                adaptiveRow(source + above * pitch, source + below * pitch, source + y * pitch, last + y * pitch, row, pitch);
+            }
+            else {
+                interpolateRow(source + above * pitch, source + below * pitch, row, pitch);
+            }
+        }
+    }
+}
+
+Deinterlacer::Stats Deinterlacer::getStats() const {
+    const Uint64 frames = m_frames;
+
+    return Stats{
+        .mode      = m_mode,
+        .frames    = frames,
+        .lastMS    = (double)m_lastNS / SDL_NS_PER_MS,
+        .averageMS = frames > 0 ? (double)m_totalNS / frames / SDL_NS_PER_MS : 0.0,
+        .maxMS     = (double)m_maxNS / SDL_NS_PER_MS
+    };
+}
@@ -0,0 +1,90 @@
+#include <frame.hpp>
+
+size_t getFrameSize(SDL_PixelFormat format, int height, int pitch) {
+    switch(format) {
+    case SDL_PIXELFORMAT_NV12:
+    case SDL_PIXELFORMAT_NV21:
+    case SDL_PIXELFORMAT_P010:
+        return (size_t)pitch * height + (size_t)pitch * ((height + 1) / 2);
+    case SDL_PIXELFORMAT_YV12:
+    case SDL_PIXELFORMAT_IYUV:
+        return (size_t)pitch * height + 2 * (size_t)((pitch + 1) / 2) * ((height + 1) / 2);
+    case SDL_PIXELFORMAT_MJPG:
+        return (size_t)pitch;
+    default:
+        return (size_t)pitch * height;
+    }
+}
+
+std::shared_ptr<FramePool> FramePool::create(size_t maxFreeFrames) {
+    return std::shared_ptr<FramePool>(new FramePool(maxFreeFrames));
+}
+
+FramePool::FramePool(size_t maxFreeFrames)
+    : m_maxFreeFrames(maxFreeFrames) {}
+
+FramePool::~FramePool() {
+    for(Frame* frame : m_freeFrames) {
+        destroyFrame(frame);
+    }
+}
+
+FramePtr FramePool::acquire(size_t size) {
+    Frame* frame = nullptr;
+
+    m_mutex.lock();
+    for(auto it = m_freeFrames.rbegin(); it != m_freeFrames.rend(); it++) {
+        if((*it)->capacity >= size) {
+            frame = *it;
+            m_freeFrames.erase(std::next(it).base());
+
+            break;
+        }
+    }
+
+    if(frame == nullptr) {
+        const size_t capacity = (size + frameAlignment - 1) & ~(frameAlignment - 1);
+
+        frame           = new Frame{};
+        frame->capacity = capacity;
+        frame->pixels   = (Uint8*)SDL_aligned_alloc(frameAlignment, capacity);
+
+        m_allocatedBytes += capacity;
+    }
+
+    m_mutex.unlock();
+
+    frame->size = size;
+
+    std::weak_ptr<FramePool> pool = weak_from_this();
+    return FramePtr(frame, [pool](Frame* frame) {
+        if(std::shared_ptr<FramePool> owner = pool.lock()) {
+            owner->release(frame);
+            return;
+        }
+
+        destroyFrame(frame);
+    });
+}
+
+void FramePool::release(Frame* frame) {
+    std::lock_guard lock(m_mutex);
+    if(m_freeFrames.size() >= m_maxFreeFrames) {
+        m_allocatedBytes -= frame->capacity;
+        destroyFrame(frame);
+
+        return;
+    }
+
+    m_freeFrames.push_back(frame);
+}
+
+void FramePool::destroyFrame(Frame* frame) {
+    SDL_aligned_free(frame->pixels);
+    delete frame;
+}
+
+size_t FramePool::getAllocatedBytes() {
+    std::lock_guard lock(m_mutex);
+    return m_allocatedBytes;
+}
@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <texture_pool.hpp>
+
+TexturePool::TexturePool(size_t capacityBytes)
+    : m_capacity(capacityBytes) {}
+
+TexturePool::~TexturePool() { clear(); }
+
+void TexturePool::setRenderer(SDL_Renderer* renderer) { m_renderer = renderer; }
+
+void TexturePool::setCapacity(size_t capacityBytes) {
+    m_capacity = capacityBytes;
+    trim(0);
+}
+
+SDL_Texture* TexturePool::acquire(SDL_PixelFormat format, int width, int height) {
+    auto it = std::find_if(m_idle.begin(), m_idle.end(), [=](SDL_Texture* texture) {
+        return texture->format == format && texture->w == width && texture->h == height;
+    });
+
+    if(it != m_idle.end()) {
+        SDL_Texture* texture = *it;
+        m_idle.erase(it);
+
+        m_idleBytes -= getTextureBytes(format, width, height);
+        m_hits++;
+
+        return texture;
+    }
+
+    m_misses++;
+
+    const size_t bytes = getTextureBytes(format, width, height);
+    trim(bytes);
+
+    SDL_Texture* texture = SDL_CreateTexture(m_renderer, format, SDL_TEXTUREACCESS_STREAMING, width, height);
+    if(texture == nullptr) {
+        SDL_Log("Couldn't create %dx%d %s texture: %s", width, height, SDL_GetPixelFormatName(format), SDL_GetError());
+        return nullptr;
+    }
+
+    m_textures++;
+    m_bytes += bytes;
+
+    return texture;
+}
+
+void TexturePool::release(SDL_Texture* texture) {
+    if(texture == nullptr) {
+        return;
+    }
+
+    const size_t bytes = getTextureBytes(texture->format, texture->w, texture->h);
+
+    m_idle.push_front(texture);
+    m_idleBytes += bytes;
+
+    trim(0);
+}
+
+void TexturePool::preallocate(SDL_PixelFormat format, int width, int height, size_t count) {
+    const size_t bytes = getTextureBytes(format, width, height);
+
+    size_t existing = std::count_if(m_idle.begin(), m_idle.end(), [=](SDL_Texture* texture) {
+        return texture->format == format && texture->w == width && texture->h == height;
+    });
+
+    // preallocating never pushes anything else out
+    for(; existing < count && m_bytes + bytes <= m_capacity; existing++) {
+        SDL_Texture* texture = SDL_CreateTexture(m_renderer, format, SDL_TEXTUREACCESS_STREAMING, width, height);
+        if(texture == nullptr) {
+            SDL_Log("Couldn't create %dx%d %s texture: %s", width, height, SDL_GetPixelFormatName(format), SDL_GetError());
+            return;
+        }
+
+        m_textures++;
+        m_bytes += bytes;
+
+        // at the back so it doesnt look more recently used than textures that actually were
+        m_idle.push_back(texture);
+        m_idleBytes += bytes;
+    }
+}
+
+void TexturePool::clear() {
+    for(SDL_Texture* texture : m_idle) {
+        SDL_DestroyTexture(texture);
+    }
+
+    m_textures -= m_idle.size();
+    m_bytes    -= m_idleBytes;
+    m_idleBytes = 0;
+
+    m_idle.clear();
+}
+
+TexturePool::Stats TexturePool::getStats() const {
+    return Stats{
+        .textures     = m_textures,
+        .idleTextures = m_idle.size(),
+        .bytes        = m_bytes,
+        .idleBytes    = m_idleBytes,
+        .capacity     = m_capacity,
+        .hits         = m_hits,
+        .misses       = m_misses,
+        .evictions    = m_evictions
+    };
+}
+
+size_t TexturePool::getTextureBytes(SDL_PixelFormat format, int width, int height) {
+    const size_t pixels = (size_t)width * height;
+
+    switch(format) {
+    case SDL_PIXELFORMAT_NV12:
+    case SDL_PIXELFORMAT_NV21:
+    case SDL_PIXELFORMAT_YV12:
+    case SDL_PIXELFORMAT_IYUV:
+        return pixels * 3 / 2;
+    case SDL_PIXELFORMAT_P010:
+        return pixels * 3;
+    default:
+        return pixels * std::max(1, (int)SDL_BYTESPERPIXEL(format));
+    }
+}
+
+void TexturePool::trim(size_t extraBytes) {
+    while(!m_idle.empty() && m_bytes + extraBytes > m_capacity) {
+        SDL_Texture* texture = m_idle.back();
+        m_idle.pop_back();
+
+        const size_t bytes = getTextureBytes(texture->format, texture->w, texture->h);
+        SDL_DestroyTexture(texture);
+
+        m_textures--;
+        m_bytes     -= bytes;
+        m_idleBytes -= bytes;
+        m_evictions++;
+    }
+}
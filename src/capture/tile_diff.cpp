@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <cstring>
+#include <tile_diff.hpp>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+static bool isSameSpan(const Uint8* a, const Uint8* b, size_t size) {
+    size_t i = 0;
+
+#if defined(__SSE2__)
+    for(; i + 64 <= size; i += 64) {
+        __m128i equal = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(a + i)), _mm_loadu_si128((const __m128i*)(b + i)));
+        equal         = _mm_and_si128(equal, _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(a + i + 16)), _mm_loadu_si128((const __m128i*)(b + i + 16))));
+        equal         = _mm_and_si128(equal, _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(a + i + 32)), _mm_loadu_si128((const __m128i*)(b + i + 32))));
+        equal         = _mm_and_si128(equal, _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(a + i + 48)), _mm_loadu_si128((const __m128i*)(b + i + 48))));
+
+        if(_mm_movemask_epi8(equal) != 0xFFFF) {
+            return false;
+        }
+    }
+#elif defined(__ARM_NEON)
+    for(; i + 64 <= size; i += 64) {
+        uint8x16_t difference = veorq_u8(vld1q_u8(a + i), vld1q_u8(b + i));
+        difference            = vorrq_u8(difference, veorq_u8(vld1q_u8(a + i + 16), vld1q_u8(b + i + 16)));
+        difference            = vorrq_u8(difference, veorq_u8(vld1q_u8(a + i + 32), vld1q_u8(b + i + 32)));
+        difference            = vorrq_u8(difference, veorq_u8(vld1q_u8(a + i + 48), vld1q_u8(b + i + 48)));
+
+        if(vmaxvq_u8(difference) != 0) {
+            return false;
+        }
+    }
+#endif
+
+    return memcmp(a + i, b + i, size - i) == 0;
+}
+
+bool isTileDiffSupported(SDL_PixelFormat format) {
+    switch(format) {
+    case SDL_PIXELFORMAT_YUY2:
+    case SDL_PIXELFORMAT_UYVY:
+    case SDL_PIXELFORMAT_YVYU:
+    case SDL_PIXELFORMAT_NV12:
+    case SDL_PIXELFORMAT_NV21:
+        return true;
+    default:
+        // packed rgb, the remaining fourcc formats are either planar or compressed
+        return format != SDL_PIXELFORMAT_UNKNOWN && !SDL_ISPIXELFORMAT_FOURCC(format);
+    }
+}
+
+int getTileColumns(const Frame& frame) { return (frame.width + tileWidth - 1) / tileWidth; }
+int getTileRows(const Frame& frame) { return (frame.height + tileHeight - 1) / tileHeight; }
+
+size_t compareTiles(const Frame& frame, const Frame& previous, Uint8* dirty) {
+    struct Plane {
+        size_t offset;
+        int rows;
+        int rowsPerTile;
+    };
+
+    Plane planes[2] = {
+        { 0, frame.height, tileHeight }
+    };
+
+    int planeCount = 1;
+
+    if(frame.format == SDL_PIXELFORMAT_NV12 || frame.format == SDL_PIXELFORMAT_NV21) {
+        planes[1]  = { (size_t)frame.pitch * frame.height, (frame.height + 1) / 2, tileHeight / 2 };
+        planeCount = 2;
+    }
+
+    const int columns       = getTileColumns(frame);
+    const size_t tileStride = (size_t)tileWidth * SDL_BYTESPERPIXEL(frame.format);
+    const size_t rowBytes   = std::min((size_t)frame.width * SDL_BYTESPERPIXEL(frame.format), (size_t)frame.pitch);
+
+    size_t changed = 0;
+
+    for(int i = 0; i < planeCount; i++) {
+        for(int y = 0; y < planes[i].rows; y++) {
+            const Uint8* row  = frame.pixels + planes[i].offset + (size_t)y * frame.pitch;
+            const Uint8* last = previous.pixels + planes[i].offset + (size_t)y * frame.pitch;
+            Uint8* rowDirty   = dirty + (y / planes[i].rowsPerTile) * columns;
+
+            for(int column = 0; column < columns; column++) {
+                if(rowDirty[column] != 0) {
+                    continue;
+                }
+
+                const size_t x = column * tileStride;
+                if(!isSameSpan(row + x, last + x, std::min(tileStride, rowBytes - x))) {
+                    rowDirty[column] = 1;
+                    changed++;
+                }
+            }
+        }
+    }
+
+    return changed;
+}
+
+bool isSameFrame(const Frame& frame, const Frame& previous) { return frame.size == previous.size && isSameSpan(frame.pixels, previous.pixels, frame.size); }
+
+size_t getTileBytes(const Frame& frame) {
+    const size_t bytes = (size_t)tileWidth * tileHeight * SDL_BYTESPERPIXEL(frame.format);
+    return frame.format == SDL_PIXELFORMAT_NV12 || frame.format == SDL_PIXELFORMAT_NV21 ? bytes * 3 / 2 : bytes;
+}
@@ -0,0 +1,64 @@
+#include <upload_scheduler.hpp>
+
+UploadScheduler::UploadScheduler(size_t budgetBytes)
+    : m_budget(budgetBytes) {}
+
+void UploadScheduler::setBudget(size_t budgetBytes) { m_budget = budgetBytes; }
+size_t UploadScheduler::getBudget() const { return m_budget; }
+
+void UploadScheduler::run(const std::vector<std::unique_ptr<CameraStream>>& streams) {
+    m_uploadedBytes   = 0;
+    m_deferredUploads = 0;
+
+    if(streams.empty()) {
+        return;
+    }
+
+    // the primary always goes through, whatever it used is taken out of the budget for the rest
+    size_t spent = streams[0]->upload();
+
+    const size_t secondaries = streams.size() - 1;
+    if(secondaries == 0) {
+        m_uploadedBytes = spent;
+        return;
+    }
+
+    const size_t first = m_nextSecondary % secondaries;
+    size_t uploaded    = 0;
+    bool rotated       = false;
+
+    for(size_t i = 0; i < secondaries; i++) {
+        const size_t idx         = (first + i) % secondaries;
+        CameraStream* stream     = streams[idx + 1].get();
+        const size_t pendingSize = stream->getPendingBytes();
+
+        if(pendingSize == 0) {
+            continue;
+        }
+
+        // a stream that was starved last frame is let through once so one oversized stream can't stall forever
+        const bool overBudget = m_budget != 0 && spent + pendingSize > m_budget;
+        if(overBudget && !(m_starved && uploaded == 0)) {
+            if(!rotated) {
+                m_nextSecondary = idx;
+                rotated         = true;
+            }
+
+            m_deferredUploads++;
+            continue;
+        }
+
+        spent += stream->upload();
+        uploaded++;
+    }
+
+    if(!rotated) {
+        m_nextSecondary = first + 1;
+    }
+
+    m_starved       = uploaded == 0 && m_deferredUploads != 0;
+    m_uploadedBytes = spent;
+}
+
+size_t UploadScheduler::getUploadedBytes() const { return m_uploadedBytes; }
+size_t UploadScheduler::getDeferredUploads() const { return m_deferredUploads; }
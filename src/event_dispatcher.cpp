@@ -0,0 +1,118 @@
+#include <event_dispatcher.hpp>
+
+EventDispatcher::EventDispatcher() {
+    m_pageIndices.fill(0);
+}
+
+void EventDispatcher::add(Uint32 type, const Handler& handler, void* extraData) {
+    if(type > 0xFFFF) {
+        SDL_Log("Invalid event type %u", type);
+        return;
+    }
+
+    Entry entry = { .handler = handler, .extraData = extraData, .slot = 0, .removed = false };
+
+    // the entries cant move while a dispatch is walking them
+    if(m_depth > 0) {
+        m_pending.emplace_back(type, std::move(entry));
+        return;
+    }
+
+    insert(type, std::move(entry));
+}
+
+void EventDispatcher::dispatch(SDL_Event* event) {
+    const Uint8 slot = getSlot(event->type);
+    if(slot == 0) {
+        return;
+    }
+
+    m_depth++;
+
+    // the range is taken once, anything added by the handlers is pending until the flush below
+    const Slot range = m_slots[slot - 1];
+    for(Uint32 i = range.first; i < range.first + range.count; i++) {
+        Entry& entry = m_entries[i];
+        if(!entry.removed && !entry.handler(event, entry.extraData)) {
+            entry.removed = true;
+            m_removed     = true;
+        }
+    }
+
+    m_depth--;
+
+    if(m_depth == 0 && (m_removed || !m_pending.empty())) {
+        flush();
+    }
+}
+
+Uint8 EventDispatcher::getSlot(Uint32 type) const {
+    if(type > 0xFFFF) {
+        return 0;
+    }
+
+    const Uint8 page = m_pageIndices[type >> 8];
+    return page == 0 ? 0 : m_pages[page - 1][type & 0xFF];
+}
+
+void EventDispatcher::insert(Uint32 type, Entry&& entry) {
+    Uint8 slot = getSlot(type);
+    if(slot == 0) {
+        if(m_slots.size() == maxSlots) {
+            SDL_Log("Too many event types with handlers, ignoring %u", type);
+            return;
+        }
+
+        // every page comes with a new slot, so there are never more pages than slots
+        Uint8& page = m_pageIndices[type >> 8];
+        if(page == 0) {
+            m_pages.push_back({});
+            page = (Uint8)m_pages.size();
+        }
+
+        m_slots.push_back({ .first = (Uint32)m_entries.size(), .count = 0 });
+
+        slot                           = (Uint8)m_slots.size();
+        m_pages[page - 1][type & 0xFF] = slot;
+    }
+
+    Slot& range           = m_slots[slot - 1];
+    const Uint32 position = range.first + range.count;
+
+    entry.slot = slot;
+    m_entries.insert(m_entries.begin() + position, std::move(entry));
+
+    // the slots stored after it moved up by one
+    for(Slot& other : m_slots) {
+        if(&other != &range && other.first >= position) {
+            other.first++;
+        }
+    }
+
+    range.count++;
+}
+
+void EventDispatcher::flush() {
+    if(m_removed) {
+        m_removed = false;
+
+        std::erase_if(m_entries, [](const Entry& entry) { return entry.removed; });
+
+        // the entries stay grouped by slot, only the ranges need counting again
+        for(Slot& slot : m_slots) {
+            slot = { .first = (Uint32)m_entries.size(), .count = 0 };
+        }
+
+        for(Uint32 i = (Uint32)m_entries.size(); i-- > 0;) {
+            Slot& slot = m_slots[m_entries[i].slot - 1];
+            slot.first = i;
+            slot.count++;
+        }
+    }
+
+    for(auto& [type, entry] : m_pending) {
+        insert(type, std::move(entry));
+    }
+
+    m_pending.clear();
+}
@@ -0,0 +1,243 @@
+#include <algorithm>
+#include <audio_socket_server.hpp>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// a quarter second between the audio callback and the server thread, which wakes every few milliseconds anyway
+static constexpr size_t ringSize = 48000 * 2 * sizeof(Sint16) / 4;
+
+AudioSocketServer::AudioSocketServer()
+    : m_ring(ringSize)
+    , m_gain(1.0f)
+    , m_bytesOverrun(0)
+    , m_running(false) {}
+
+AudioSocketServer::~AudioSocketServer() {
+    stop();
+}
+
+bool AudioSocketServer::start(const std::string& path) {
+    stop();
+
+    sockaddr_un address = {};
+    address.sun_family  = AF_UNIX;
+    if(path.size() >= sizeof(address.sun_path)) {
+        SDL_Log("Audio socket path is too long: %s", path.c_str());
+        return false;
+    }
+
+    memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    m_listenFD = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if(m_listenFD < 0) {
+        SDL_Log("Couldn't create audio socket: %s", strerror(errno));
+        return false;
+    }
+
+    // left over from a previous run that didnt shut down cleanly
+    unlink(path.c_str());
+
+    if(bind(m_listenFD, (sockaddr*)&address, sizeof(address)) != 0 || listen(m_listenFD, 8) != 0) {
+        SDL_Log("Couldn't listen on audio socket %s: %s", path.c_str(), strerror(errno));
+
+        close(m_listenFD);
+        m_listenFD = -1;
+        return false;
+    }
+
+    m_path          = path;
+    m_bytesSent     = 0;
+    m_bytesOverrun  = 0;
+    m_chunksDropped = 0;
+
+    m_running = true;
+    m_thread  = std::thread(&AudioSocketServer::serverThread, this);
+
+    SDL_Log("Serving audio on %s", path.c_str());
+    return true;
+}
+
+void AudioSocketServer::stop() {
+    if(!m_running) {
+        return;
+    }
+
+    m_running = false;
+    m_thread.join();
+
+    for(Client& client : m_clients) {
+        close(client.fd);
+    }
+
+    m_clients.clear();
+
+    close(m_listenFD);
+    m_listenFD = -1;
+    unlink(m_path.c_str());
+}
+
+bool AudioSocketServer::isRunning() const { return m_running; }
+const std::string& AudioSocketServer::getPath() const { return m_path; }
+
+void AudioSocketServer::setGain(float gain) { m_gain = gain; }
+
+void AudioSocketServer::onAudio(const Uint8* data, size_t size, Uint64 timestampNS) {
+    if(!m_running) {
+        return;
+    }
+
+    if(!m_ring.write(data, size)) {
+        m_bytesOverrun += size;
+    }
+}
+
+AudioSocketServer::Stats AudioSocketServer::getStats() {
+    std::lock_guard lock(m_statsMutex);
+
+    return Stats{
+        .clients       = m_clients.size(),
+        .bytesSent     = m_bytesSent,
+        .chunksDropped = m_chunksDropped,
+        .bytesOverrun  = m_bytesOverrun,
+        .ringBytes     = m_ring.getCapacity()
+    };
+}
+
+void AudioSocketServer::serverThread() {
+    std::vector<pollfd> fds;
+    Chunk pending;
+    pending.reserve(chunkSize);
+
+    while(m_running) {
+        fds.clear();
+        fds.push_back({ m_listenFD, POLLIN, 0 });
+        for(const Client& client : m_clients) {
+            fds.push_back({ client.fd, (short)(POLLIN | (client.queue.empty() ? 0 : POLLOUT)), 0 });
+        }
+
+        // half a chunk, so a new chunk never waits long for the next wakeup
+        poll(fds.data(), fds.size(), chunkDurationMS / 2);
+
+        if(fds[0].revents & POLLIN) {
+            acceptClients();
+        }
+
+        // clients never send anything, readable means they hung up
+        for(size_t i = 1; i < fds.size(); i++) {
+            if((fds[i].revents & (POLLIN | POLLHUP | POLLERR)) == 0) {
+                continue;
+            }
+
+            char discard[256];
+            const ssize_t received = recv(fds[i].fd, discard, sizeof(discard), MSG_DONTWAIT);
+            if(received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK) || (fds[i].revents & (POLLHUP | POLLERR))) {
+                auto it = std::find_if(m_clients.begin(), m_clients.end(), [fd = fds[i].fd](const Client& client) { return client.fd == fd; });
+                if(it != m_clients.end()) {
+                    close(it->fd);
+
+                    std::lock_guard lock(m_statsMutex);
+                    m_clients.erase(it);
+                }
+            }
+        }
+
+        // whole chunks only, gain applied once for every client
+        while(true) {
+            const size_t missing = chunkSize - pending.size();
+            const size_t offset  = pending.size();
+
+            pending.resize(chunkSize);
+            pending.resize(offset + m_ring.read(pending.data() + offset, missing));
+
+            if(pending.size() < chunkSize) {
+                break;
+            }
+
+            const float gain = m_gain;
+            if(gain != 1.0f) {
+                Sint16* samples = (Sint16*)pending.data();
+                for(size_t i = 0; i < chunkSize / sizeof(Sint16); i++) {
+                    samples[i] = (Sint16)std::clamp(std::lround(samples[i] * gain), -32768l, 32767l);
+                }
+            }
+
+            std::shared_ptr<Chunk> chunk = std::make_shared<Chunk>(std::move(pending));
+            queueChunk(chunk);
+
+            pending = Chunk();
+            pending.reserve(chunkSize);
+        }
+
+        for(size_t i = 0; i < m_clients.size();) {
+            if(sendQueued(m_clients[i])) {
+                i++;
+                continue;
+            }
+
+            close(m_clients[i].fd);
+
+            std::lock_guard lock(m_statsMutex);
+            m_clients.erase(m_clients.begin() + i);
+        }
+    }
+}
+
+void AudioSocketServer::acceptClients() {
+    while(true) {
+        const int fd = accept4(m_listenFD, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if(fd < 0) {
+            return;
+        }
+
+        std::lock_guard lock(m_statsMutex);
+        m_clients.push_back(Client{ .fd = fd });
+    }
+}
+
+void AudioSocketServer::queueChunk(const std::shared_ptr<const Chunk>& chunk) {
+    for(Client& client : m_clients) {
+        if(client.queue.size() >= maxQueuedChunks) {
+            // the front chunk might be half sent, the one after it is the oldest that can go without a torn frame
+            const size_t drop = client.offset > 0 ? 1 : 0;
+            client.queue.erase(client.queue.begin() + drop);
+
+            std::lock_guard lock(m_statsMutex);
+            m_chunksDropped++;
+        }
+
+        client.queue.push_back(chunk);
+    }
+}
+
+bool AudioSocketServer::sendQueued(Client& client) {
+    while(!client.queue.empty()) {
+        const Chunk& chunk = *client.queue.front();
+
+        const ssize_t sent = send(client.fd, chunk.data() + client.offset, chunk.size() - client.offset, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if(sent < 0) {
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+
+        client.offset += sent;
+
+        {
+            std::lock_guard lock(m_statsMutex);
+            m_bytesSent += sent;
+        }
+
+        if(client.offset < chunk.size()) {
+            return true;
+        }
+
+        client.queue.pop_front();
+        client.offset = 0;
+    }
+
+    return true;
+}
@@ -0,0 +1,479 @@
+#include <SDL3_image/SDL_image.h>
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <mjpeg_http_server.hpp>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+static constexpr char streamHeader[] = "HTTP/1.0 200 OK\r\n"
+                                       "Cache-Control: no-cache, no-store\r\n"
+                                       "Pragma: no-cache\r\n"
+                                       "Connection: close\r\n"
+                                       "Content-Type: multipart/x-mixed-replace; boundary=frame\r\n"
+                                       "\r\n";
+
+static constexpr char notFound[] = "HTTP/1.0 404 Not Found\r\n"
+                                   "Connection: close\r\n"
+                                   "Content-Type: text/plain\r\n"
+                                   "\r\n"
+                                   "Not found, the stream is at /\n";
+
+static constexpr char partEnd[] = "\r\n";
+
+// nobody sends a request this long, it's junk or an attack
+static constexpr size_t maxRequestSize = 8192;
+
+// the kernel would otherwise buffer megabytes for a slow client, which is exactly the lag the mailbox is there to avoid.
+// linux doubles it, so this is room for a couple of 1080p jpegs
+static constexpr int clientSendBufferSize = 256 * 1024;
+
+MjpegHttpServer::MjpegHttpServer(size_t encodeThreads)
+    : m_clientCount(0)
+    , m_lastEncodeNS(0)
+    , m_framesSent(0)
+    , m_framesDropped(0)
+    , m_bytesSent(0)
+    , m_framesPassedThrough(0)
+    , m_framesEncoded(0)
+    , m_framesSkipped(0)
+    , m_encodeNS(0)
+    , m_running(false)
+    , m_pool(encodeThreads, encodeThreads) {}
+
+MjpegHttpServer::~MjpegHttpServer() {
+    stop();
+}
+
+bool MjpegHttpServer::start(const std::string& address, Uint16 port, int maxEncodeFPS, int quality) {
+    stop();
+
+    sockaddr_in bindAddress = {};
+    bindAddress.sin_family  = AF_INET;
+    bindAddress.sin_port    = htons(port);
+    if(inet_pton(AF_INET, address.c_str(), &bindAddress.sin_addr) != 1) {
+        SDL_Log("Invalid http preview address: %s", address.c_str());
+        return false;
+    }
+
+    m_listenFD = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if(m_listenFD < 0) {
+        SDL_Log("Couldn't create http preview socket: %s", strerror(errno));
+        return false;
+    }
+
+    const int reuse = 1;
+    setsockopt(m_listenFD, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    if(bind(m_listenFD, (sockaddr*)&bindAddress, sizeof(bindAddress)) != 0 || listen(m_listenFD, 16) != 0) {
+        SDL_Log("Couldn't listen on %s:%u: %s", address.c_str(), port, strerror(errno));
+
+        close(m_listenFD);
+        m_listenFD = -1;
+        return false;
+    }
+
+    m_epollFD = epoll_create1(EPOLL_CLOEXEC);
+    m_eventFD = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    epoll_event listenEvent = { .events = EPOLLIN, .data = { .fd = m_listenFD } };
+    epoll_event wakeEvent   = { .events = EPOLLIN, .data = { .fd = m_eventFD } };
+    if(m_epollFD < 0 || m_eventFD < 0 || epoll_ctl(m_epollFD, EPOLL_CTL_ADD, m_listenFD, &listenEvent) != 0 || epoll_ctl(m_epollFD, EPOLL_CTL_ADD, m_eventFD, &wakeEvent) != 0) {
+        SDL_Log("Couldn't set up http preview polling: %s", strerror(errno));
+
+        close(m_listenFD);
+        close(m_epollFD);
+        close(m_eventFD);
+        m_listenFD = -1;
+        m_epollFD  = -1;
+        m_eventFD  = -1;
+        return false;
+    }
+
+    m_address             = address;
+    m_port                = port;
+    m_quality             = std::clamp(quality, 0, 100);
+    m_encodeIntervalNS    = SDL_NS_PER_SECOND / std::max(1, maxEncodeFPS);
+    m_deliveredSequence   = 0;
+    m_lastEncodeNS        = 0;
+    m_framesSent          = 0;
+    m_framesDropped       = 0;
+    m_bytesSent           = 0;
+    m_framesPassedThrough = 0;
+    m_framesEncoded       = 0;
+    m_framesSkipped       = 0;
+    m_encodeNS            = 0;
+
+    m_running = true;
+    m_thread  = std::thread(&MjpegHttpServer::serverThread, this);
+
+    SDL_Log("Serving an mjpeg preview on http://%s:%u/", address.c_str(), port);
+    return true;
+}
+
+void MjpegHttpServer::stop() {
+    if(!m_running) {
+        return;
+    }
+
+    m_running = false;
+
+    const Uint64 wake = 1;
+    write(m_eventFD, &wake, sizeof(wake));
+    m_thread.join();
+
+    // encodes still running would publish into a closed eventfd otherwise
+    m_pool.wait();
+
+    for(auto& [fd, client] : m_clients) {
+        close(fd);
+    }
+
+    m_clients.clear();
+    m_clientCount = 0;
+
+    close(m_listenFD);
+    close(m_epollFD);
+    close(m_eventFD);
+    m_listenFD = -1;
+    m_epollFD  = -1;
+    m_eventFD  = -1;
+
+    std::lock_guard lock(m_latestMutex);
+    m_latest = nullptr;
+}
+
+bool MjpegHttpServer::isRunning() const { return m_running; }
+const std::string& MjpegHttpServer::getAddress() const { return m_address; }
+Uint16 MjpegHttpServer::getPort() const { return m_port; }
+
+void MjpegHttpServer::onFrame(const FramePtr& frame) {
+    if(!m_running || m_clientCount == 0) {
+        return;
+    }
+
+    if(frame->format == SDL_PIXELFORMAT_MJPG) {
+        m_framesPassedThrough++;
+
+        publish(std::make_shared<Jpeg>(Jpeg{
+            .frame    = frame,
+            .encoded  = {},
+            .data     = frame->pixels,
+            .size     = frame->size,
+            .sequence = frame->sequence
+        }));
+
+        return;
+    }
+
+    if(frame->timestampNS < m_lastEncodeNS + m_encodeIntervalNS) {
+        return;
+    }
+
+    m_lastEncodeNS = frame->timestampNS;
+
+    // the job keeps its own reference, the frame goes back to the camera's pool once it's encoded
+    if(!m_pool.trySubmit([this, frame]() { encode(frame); })) {
+        m_framesSkipped++;
+    }
+}
+
+MjpegHttpServer::Stats MjpegHttpServer::getStats() {
+    const Uint64 encoded = m_framesEncoded;
+
+    return Stats{
+        .clients             = m_clientCount,
+        .framesSent          = m_framesSent,
+        .framesDropped       = m_framesDropped,
+        .bytesSent           = m_bytesSent,
+        .framesPassedThrough = m_framesPassedThrough,
+        .framesEncoded       = encoded,
+        .framesSkipped       = m_framesSkipped,
+        .averageEncodeMS     = encoded > 0 ? (double)m_encodeNS / encoded / SDL_NS_PER_MS : 0.0
+    };
+}
+
+void MjpegHttpServer::encode(const FramePtr& frame) {
+    const Uint64 startNS = SDL_GetTicksNS();
+
+    SDL_Surface* surface = SDL_CreateSurface(frame->width, frame->height, SDL_PIXELFORMAT_RGB24);
+    SDL_IOStream* stream = SDL_IOFromDynamicMem();
+
+    bool encoded = surface != nullptr && stream != nullptr;
+    encoded      = encoded && SDL_ConvertPixels(frame->width, frame->height, frame->format, frame->pixels, frame->pitch, SDL_PIXELFORMAT_RGB24, surface->pixels, surface->pitch);
+    encoded      = encoded && IMG_SaveJPG_IO(surface, stream, false, m_quality);
+
+    if(encoded) {
+        const Uint8* data = (const Uint8*)SDL_GetPointerProperty(SDL_GetIOProperties(stream), SDL_PROP_IOSTREAM_DYNAMIC_MEMORY_POINTER, nullptr);
+        const Sint64 size = SDL_TellIO(stream);
+
+        std::shared_ptr<Jpeg> jpeg = std::make_shared<Jpeg>();
+        jpeg->encoded.assign(data, data + size);
+        jpeg->data     = jpeg->encoded.data();
+        jpeg->size     = jpeg->encoded.size();
+        jpeg->sequence = frame->sequence;
+
+        publish(jpeg);
+
+        m_framesEncoded++;
+        m_encodeNS += SDL_GetTicksNS() - startNS;
+    }
+    else {
+        SDL_Log("Couldn't encode preview frame: %s", SDL_GetError());
+    }
+
+    SDL_CloseIO(stream);
+    SDL_DestroySurface(surface);
+}
+
+void MjpegHttpServer::publish(const JpegPtr& jpeg) {
+    {
+        std::lock_guard lock(m_latestMutex);
+
+        // encodes can finish out of order
+        if(m_latest != nullptr && m_latest->sequence >= jpeg->sequence) {
+            return;
+        }
+
+        m_latest = jpeg;
+    }
+
+    const Uint64 wake = 1;
+    write(m_eventFD, &wake, sizeof(wake));
+}
+
+void MjpegHttpServer::serverThread() {
+    epoll_event events[32];
+
+    while(m_running) {
+        const int count = epoll_wait(m_epollFD, events, 32, -1);
+
+        for(int i = 0; i < count; i++) {
+            const int fd = events[i].data.fd;
+
+            if(fd == m_listenFD) {
+                acceptClients();
+                continue;
+            }
+
+            if(fd == m_eventFD) {
+                Uint64 value;
+                read(m_eventFD, &value, sizeof(value));
+
+                JpegPtr latest;
+                {
+                    std::lock_guard lock(m_latestMutex);
+                    latest = m_latest;
+                }
+
+                if(latest != nullptr && latest->sequence != m_deliveredSequence) {
+                    m_deliveredSequence = latest->sequence;
+                    deliver(latest);
+                }
+
+                continue;
+            }
+
+            auto it = m_clients.find(fd);
+            if(it == m_clients.end()) {
+                continue;
+            }
+
+            bool keep = (events[i].events & (EPOLLHUP | EPOLLERR)) == 0;
+            if(keep && (events[i].events & EPOLLIN)) {
+                keep = readRequest(it->second);
+            }
+
+            if(keep && (events[i].events & EPOLLOUT)) {
+                keep = flush(it->second);
+            }
+
+            if(!keep) {
+                closeClient(fd);
+            }
+        }
+    }
+}
+
+void MjpegHttpServer::acceptClients() {
+    while(true) {
+        const int fd = accept4(m_listenFD, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if(fd < 0) {
+            return;
+        }
+
+        setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &clientSendBufferSize, sizeof(clientSendBufferSize));
+
+        // edge triggered, flush runs until the socket is full and gets called again once it drained
+        epoll_event event = { .events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET, .data = { .fd = fd } };
+        if(epoll_ctl(m_epollFD, EPOLL_CTL_ADD, fd, &event) != 0) {
+            close(fd);
+            continue;
+        }
+
+        m_clients[fd] = Client{ .fd = fd };
+        m_clientCount = m_clients.size();
+    }
+}
+
+bool MjpegHttpServer::readRequest(Client& client) {
+    char buffer[1024];
+
+    while(true) {
+        const ssize_t received = recv(client.fd, buffer, sizeof(buffer), 0);
+        if(received == 0) {
+            return false;
+        }
+
+        if(received < 0) {
+            if(errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                return false;
+            }
+
+            break;
+        }
+
+        // anything sent while streaming is ignored
+        if(!client.streaming && !client.closeWhenSent) {
+            client.request.append(buffer, received);
+        }
+    }
+
+    if(client.streaming || client.closeWhenSent) {
+        return true;
+    }
+
+    const size_t end = client.request.find("\r\n\r\n");
+    if(end == std::string::npos) {
+        return client.request.size() < maxRequestSize;
+    }
+
+    // only the request line matters, every path but the root is a 404
+    const size_t lineEnd   = client.request.find("\r\n");
+    const std::string line = client.request.substr(0, lineEnd);
+
+    if(line.rfind("GET / ", 0) == 0 || line.rfind("GET /stream ", 0) == 0) {
+        client.streaming = true;
+        client.header    = streamHeader;
+
+        std::lock_guard lock(m_latestMutex);
+        client.mailbox = m_latest;
+    }
+    else {
+        client.header        = notFound;
+        client.closeWhenSent = true;
+    }
+
+    client.request.clear();
+    client.request.shrink_to_fit();
+
+    return flush(client);
+}
+
+bool MjpegHttpServer::flush(Client& client) {
+    while(true) {
+        if(client.header.empty()) {
+            if(client.closeWhenSent) {
+                return false;
+            }
+
+            if(client.mailbox == nullptr) {
+                return true;
+            }
+
+            // the next part
+            char header[128];
+            snprintf(header, sizeof(header), "--frame\r\nContent-Type: image/jpeg\r\nContent-Length: %zu\r\n\r\n", client.mailbox->size);
+
+            client.header = header;
+            client.body   = std::move(client.mailbox);
+            client.offset = 0;
+        }
+
+        const size_t headerSize = client.header.size();
+        const size_t bodySize   = client.body != nullptr ? client.body->size : 0;
+        const size_t endSize    = client.body != nullptr ? sizeof(partEnd) - 1 : 0;
+
+        iovec parts[3];
+        int partCount = 0;
+        size_t offset = client.offset;
+
+        const std::pair<const void*, size_t> segments[3] = {
+            { client.header.data(), headerSize },
+            { client.body != nullptr ? client.body->data : nullptr, bodySize },
+            { partEnd, endSize }
+        };
+
+        for(const auto& [data, size] : segments) {
+            if(offset >= size) {
+                offset -= size;
+                continue;
+            }
+
+            parts[partCount++] = { (Uint8*)data + offset, size - offset };
+            offset             = 0;
+        }
+
+        msghdr message     = {};
+        message.msg_iov    = parts;
+        message.msg_iovlen = partCount;
+
+        const ssize_t sent = sendmsg(client.fd, &message, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if(sent < 0) {
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+
+        m_bytesSent   += sent;
+        client.offset += sent;
+
+        if(client.offset < headerSize + bodySize + endSize) {
+            continue;
+        }
+
+        if(client.body != nullptr) {
+            m_framesSent++;
+        }
+
+        client.header.clear();
+        client.body   = nullptr;
+        client.offset = 0;
+    }
+}
+
+void MjpegHttpServer::deliver(const JpegPtr& jpeg) {
+    std::vector<int> closed;
+
+    for(auto& [fd, client] : m_clients) {
+        if(!client.streaming) {
+            continue;
+        }
+
+        if(client.mailbox != nullptr) {
+            m_framesDropped++;
+        }
+
+        client.mailbox = jpeg;
+
+        // idle clients start right away, busy ones pick it up when their current part is out
+        if(client.header.empty() && !flush(client)) {
+            closed.push_back(fd);
+        }
+    }
+
+    for(int fd : closed) {
+        closeClient(fd);
+    }
+}
+
+void MjpegHttpServer::closeClient(int fd) {
+    close(fd);
+
+    m_clients.erase(fd);
+    m_clientCount = m_clients.size();
+}
@@ -0,0 +1,48 @@
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <pcm_ring.hpp>
+
+PcmRing::PcmRing(size_t capacity)
+    : m_buffer(std::bit_ceil(std::max<size_t>(capacity, 64)))
+    , m_mask(m_buffer.size() - 1)
+    , m_writePosition(0)
+    , m_readPosition(0) {}
+
+bool PcmRing::write(const Uint8* data, size_t size) {
+    const size_t writePosition = m_writePosition.load(std::memory_order_relaxed);
+    const size_t readPosition  = m_readPosition.load(std::memory_order_acquire);
+
+    if(m_buffer.size() - (writePosition - readPosition) < size) {
+        return false;
+    }
+
+    // positions only ever grow, wrapping is just the mask
+    const size_t offset = writePosition & m_mask;
+    const size_t first  = std::min(size, m_buffer.size() - offset);
+
+    memcpy(m_buffer.data() + offset, data, first);
+    memcpy(m_buffer.data(), data + first, size - first);
+
+    m_writePosition.store(writePosition + size, std::memory_order_release);
+    return true;
+}
+
+size_t PcmRing::read(Uint8* out, size_t size) {
+    const size_t readPosition  = m_readPosition.load(std::memory_order_relaxed);
+    const size_t writePosition = m_writePosition.load(std::memory_order_acquire);
+
+    size = std::min(size, writePosition - readPosition);
+
+    const size_t offset = readPosition & m_mask;
+    const size_t first  = std::min(size, m_buffer.size() - offset);
+
+    memcpy(out, m_buffer.data() + offset, first);
+    memcpy(out + first, m_buffer.data(), size - first);
+
+    m_readPosition.store(readPosition + size, std::memory_order_release);
+    return size;
+}
+
+size_t PcmRing::getAvailable() const { return m_writePosition.load(std::memory_order_acquire) - m_readPosition.load(std::memory_order_acquire); }
+size_t PcmRing::getCapacity() const { return m_buffer.size(); }
@@ -0,0 +1,433 @@
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <pipe_output.hpp>
+#include <poll.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// a second of audio between the callback and the writer thread
+static constexpr size_t audioRingSize  = 48000 * 2 * sizeof(Sint16);
+static constexpr size_t audioChunkSize = 16 * 1024;
+
+// how often blocked writes and opens check whether we are stopping
+static constexpr int pollTimeoutMS = 100;
+
+// linux only, the 64KiB default means a wakeup of the reader for every few rows of a frame
+static constexpr int pipeSize = 1024 * 1024;
+
+// the -pixel_format ffmpeg's rawvideo demuxer needs for a format, nullptr for ones we cant describe to it
+static const char* getFFmpegPixelFormat(SDL_PixelFormat format) {
+    switch(format) {
+    case SDL_PIXELFORMAT_YUY2:
+        return "yuyv422";
+    case SDL_PIXELFORMAT_UYVY:
+        return "uyvy422";
+    case SDL_PIXELFORMAT_YVYU:
+        return "yvyu422";
+    case SDL_PIXELFORMAT_NV12:
+        return "nv12";
+    case SDL_PIXELFORMAT_NV21:
+        return "nv21";
+    case SDL_PIXELFORMAT_IYUV:
+        return "yuv420p";
+    case SDL_PIXELFORMAT_RGB24:
+        return "rgb24";
+    case SDL_PIXELFORMAT_BGR24:
+        return "bgr24";
+    // sdl names packed formats by their order in a 32 bit value, ffmpeg by their order in memory
+    case SDL_PIXELFORMAT_XRGB8888:
+        return "bgr0";
+    case SDL_PIXELFORMAT_ARGB8888:
+        return "bgra";
+    case SDL_PIXELFORMAT_XBGR8888:
+        return "rgb0";
+    case SDL_PIXELFORMAT_ABGR8888:
+        return "rgba";
+    default:
+        return nullptr;
+    }
+}
+
+struct Plane {
+    int rows;
+    int pitch;
+    int rowSize;
+};
+
+// rawvideo readers expect rows without padding and the planes back to back
+static int getPlanes(const Frame& frame, Plane* planes) {
+    const int chromaRows = (frame.height + 1) / 2;
+
+    switch(frame.format) {
+    case SDL_PIXELFORMAT_NV12:
+    case SDL_PIXELFORMAT_NV21:
+        planes[0] = { frame.height, frame.pitch, frame.width };
+        planes[1] = { chromaRows, frame.pitch, (frame.width + 1) / 2 * 2 };
+        return 2;
+    case SDL_PIXELFORMAT_IYUV:
+        planes[0] = { frame.height, frame.pitch, frame.width };
+        planes[1] = { chromaRows, (frame.pitch + 1) / 2, (frame.width + 1) / 2 };
+        planes[2] = planes[1];
+        return 3;
+    default:
+        planes[0] = { frame.height, frame.pitch, frame.width * SDL_BYTESPERPIXEL(frame.format) };
+        return 1;
+    }
+}
+
+PipeOutput::PipeOutput(PipeFullPolicy policy, size_t maxQueuedFrames)
+    : m_policy(policy)
+    , m_queue(maxQueuedFrames)
+    , m_audioRing(audioRingSize)
+    , m_audioBytesWritten(0)
+    , m_audioBytesDropped(0)
+    , m_audioConnected(false)
+    , m_running(false) {}
+
+PipeOutput::~PipeOutput() {
+    stop();
+}
+
+bool PipeOutput::start(const std::string& videoPath, const std::string& audioPath) {
+    stop();
+
+    if(audioPath == "-") {
+        SDL_Log("Only video can be piped to stdout");
+        return false;
+    }
+
+    // a reader going away would kill us otherwise, writes fail with EPIPE instead and we wait for the next one
+    signal(SIGPIPE, SIG_IGN);
+
+    m_videoPath         = videoPath;
+    m_audioPath         = audioPath;
+    m_framesWritten     = 0;
+    m_framesDropped     = 0;
+    m_framesSkipped     = 0;
+    m_videoBytesWritten = 0;
+    m_audioBytesWritten = 0;
+    m_audioBytesDropped = 0;
+
+    m_running = true;
+    if(!videoPath.empty()) {
+        m_videoThread = std::thread(&PipeOutput::videoThread, this);
+    }
+
+    if(!audioPath.empty()) {
+        m_audioThread = std::thread(&PipeOutput::audioThread, this);
+    }
+
+    return true;
+}
+
+void PipeOutput::stop() {
+    m_queueMutex.lock();
+    m_running = false;
+    m_queueMutex.unlock();
+
+    m_queueCondition.notify_all();
+
+    if(m_videoThread.joinable()) {
+        m_videoThread.join();
+    }
+
+    if(m_audioThread.joinable()) {
+        m_audioThread.join();
+    }
+}
+
+bool PipeOutput::isRunning() const { return m_running; }
+
+void PipeOutput::onFrame(const FramePtr& frame) {
+    {
+        std::lock_guard lock(m_queueMutex);
+
+        // nobody reading yet, they should start with a current frame anyway
+        if(!m_running || !m_videoConnected) {
+            return;
+        }
+
+        if(m_queueCount == m_queue.size()) {
+            m_framesDropped++;
+            if(m_policy == PipeFullPolicy::DROP_NEWEST) {
+                return;
+            }
+
+            m_queue[m_queueHead] = nullptr;
+            m_queueHead          = (m_queueHead + 1) % m_queue.size();
+            m_queueCount--;
+        }
+
+        m_queue[(m_queueHead + m_queueCount) % m_queue.size()] = frame;
+        m_queueCount++;
+    }
+
+    m_queueCondition.notify_one();
+}
+
+// the ring only has room for whole callbacks, so audio always loses the newest samples no matter the policy
+void PipeOutput::onAudio(const Uint8* data, size_t size, Uint64 timestampNS) {
+    if(!m_running || !m_audioConnected) {
+        return;
+    }
+
+    if(!m_audioRing.write(data, size)) {
+        m_audioBytesDropped += size;
+    }
+}
+
+PipeOutput::Stats PipeOutput::getStats() {
+    std::lock_guard lock(m_queueMutex);
+
+    return Stats{
+        .videoConnected    = m_videoConnected,
+        .framesWritten     = m_framesWritten,
+        .framesDropped     = m_framesDropped,
+        .framesSkipped     = m_framesSkipped,
+        .videoBytesWritten = m_videoBytesWritten,
+        .audioConnected    = m_audioConnected,
+        .audioBytesWritten = m_audioBytesWritten,
+        .audioBytesDropped = m_audioBytesDropped,
+        .audioRingBytes    = m_audioRing.getCapacity()
+    };
+}
+
+void PipeOutput::videoThread() {
+    // only grows, so after the first frame repacking never allocates
+    std::vector<Uint8> packed;
+
+    while(m_running) {
+        const int fd = openPipe(m_videoPath);
+        if(fd < 0) {
+            break;
+        }
+
+        {
+            std::lock_guard lock(m_queueMutex);
+            m_videoConnected = true;
+        }
+
+        // every reader gets a single format, the one of the first frame it sees
+        SDL_PixelFormat format      = SDL_PIXELFORMAT_UNKNOWN;
+        SDL_PixelFormat unsupported = SDL_PIXELFORMAT_UNKNOWN;
+        int width                   = 0;
+        int height                  = 0;
+
+        while(true) {
+            FramePtr frame;
+            {
+                std::unique_lock lock(m_queueMutex);
+                m_queueCondition.wait(lock, [this] { return !m_running || m_queueCount > 0; });
+                if(!m_running) {
+                    break;
+                }
+
+                frame       = std::move(m_queue[m_queueHead]);
+                m_queueHead = (m_queueHead + 1) % m_queue.size();
+                m_queueCount--;
+            }
+
+            if(format == SDL_PIXELFORMAT_UNKNOWN) {
+                const char* pixelFormat = getFFmpegPixelFormat(frame->format);
+                if(frame->format == SDL_PIXELFORMAT_MJPG) {
+                    SDL_Log("Piping MJPG frames to %s, read them with -f mjpeg", m_videoPath.c_str());
+                }
+                else if(pixelFormat != nullptr) {
+                    SDL_Log("Piping %dx%d frames to %s, read them with -f rawvideo -pixel_format %s -video_size %dx%d", frame->width, frame->height, m_videoPath.c_str(), pixelFormat, frame->width, frame->height);
+                }
+                else {
+                    if(frame->format != unsupported) {
+                        SDL_Log("Can't pipe %s frames", SDL_GetPixelFormatName(frame->format));
+                        unsupported = frame->format;
+                    }
+
+                    std::lock_guard lock(m_queueMutex);
+                    m_framesSkipped++;
+                    continue;
+                }
+
+                format = frame->format;
+                width  = frame->width;
+                height = frame->height;
+            }
+
+            if(frame->format != format || frame->width != width || frame->height != height) {
+                std::lock_guard lock(m_queueMutex);
+                m_framesSkipped++;
+                continue;
+            }
+
+            const Uint8* data = frame->pixels;
+            size_t size       = frame->size;
+
+            Plane planes[3];
+            const int planeCount = format == SDL_PIXELFORMAT_MJPG ? 0 : getPlanes(*frame, planes);
+
+            bool padded       = false;
+            size_t packedSize = 0;
+            for(int i = 0; i < planeCount; i++) {
+                padded     |= planes[i].pitch != planes[i].rowSize;
+                packedSize += (size_t)planes[i].rows * planes[i].rowSize;
+            }
+
+            if(padded) {
+                packed.resize(packedSize);
+
+                const Uint8* source = frame->pixels;
+                Uint8* destination  = packed.data();
+                for(int i = 0; i < planeCount; i++) {
+                    for(int row = 0; row < planes[i].rows; row++) {
+                        memcpy(destination, source, planes[i].rowSize);
+
+                        source      += planes[i].pitch;
+                        destination += planes[i].rowSize;
+                    }
+                }
+
+                data = packed.data();
+                size = packedSize;
+            }
+
+            if(!writeAll(fd, data, size)) {
+                break;
+            }
+
+            std::lock_guard lock(m_queueMutex);
+            m_framesWritten++;
+            m_videoBytesWritten += size;
+        }
+
+        {
+            std::lock_guard lock(m_queueMutex);
+            m_videoConnected = false;
+
+            for(; m_queueCount > 0; m_queueCount--) {
+                m_queue[m_queueHead] = nullptr;
+                m_queueHead          = (m_queueHead + 1) % m_queue.size();
+            }
+        }
+
+        // stdout cant be reopened once its reader is gone
+        if(fd == STDOUT_FILENO) {
+            break;
+        }
+
+        close(fd);
+        if(m_running) {
+            SDL_Log("Reader of %s went away", m_videoPath.c_str());
+        }
+    }
+}
+
+void PipeOutput::audioThread() {
+    std::vector<Uint8> chunk(audioChunkSize);
+
+    while(m_running) {
+        const int fd = openPipe(m_audioPath);
+        if(fd < 0) {
+            break;
+        }
+
+        // left over from the previous reader
+        while(m_audioRing.read(chunk.data(), chunk.size()) > 0);
+        m_audioConnected = true;
+
+        while(m_running) {
+            const size_t size = m_audioRing.read(chunk.data(), chunk.size());
+            if(size == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                continue;
+            }
+
+            if(!writeAll(fd, chunk.data(), size)) {
+                break;
+            }
+
+            m_audioBytesWritten += size;
+        }
+
+        m_audioConnected = false;
+
+        close(fd);
+        if(m_running) {
+            SDL_Log("Reader of %s went away", m_audioPath.c_str());
+        }
+    }
+}
+
+int PipeOutput::openPipe(const std::string& path) {
+    int fd = -1;
+
+    if(path == "-") {
+        fd = STDOUT_FILENO;
+    }
+    else {
+        struct stat info;
+        if(stat(path.c_str(), &info) != 0) {
+            if(mkfifo(path.c_str(), 0600) != 0) {
+                SDL_Log("Couldn't create fifo %s: %s", path.c_str(), strerror(errno));
+                return -1;
+            }
+        }
+        else if(!S_ISFIFO(info.st_mode)) {
+            SDL_Log("%s exists and isn't a fifo", path.c_str());
+            return -1;
+        }
+
+        SDL_Log("Waiting for a reader on %s", path.c_str());
+
+        // opening a fifo for writing without a reader fails with ENXIO instead of blocking when nonblocking
+        while(m_running) {
+            fd = open(path.c_str(), O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+            if(fd >= 0 || errno != ENXIO) {
+                break;
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(pollTimeoutMS));
+        }
+
+        if(fd < 0) {
+            if(m_running) {
+                SDL_Log("Couldn't open %s: %s", path.c_str(), strerror(errno));
+            }
+
+            return -1;
+        }
+    }
+
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+#ifdef F_SETPIPE_SZ
+    fcntl(fd, F_SETPIPE_SZ, pipeSize);
+#endif
+
+    return fd;
+}
+
+bool PipeOutput::writeAll(int fd, const Uint8* data, size_t size) {
+    while(size > 0) {
+        const ssize_t written = write(fd, data, size);
+        if(written > 0) {
+            data += written;
+            size -= written;
+            continue;
+        }
+
+        // EPIPE once the reader closed its end
+        if(written < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            return false;
+        }
+
+        // the reader is behind, this is where it holds us back while the queue in front of us fills up
+        if(!m_running) {
+            return false;
+        }
+
+        pollfd pipe = { fd, POLLOUT, 0 };
+        poll(&pipe, 1, pollTimeoutMS);
+    }
+
+    return true;
+}
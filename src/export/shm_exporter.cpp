@@ -0,0 +1,134 @@
+#include <shm_exporter.hpp>
+
+// room for a 4K YUY2 frame, so the ring rarely has to grow
+static constexpr size_t initialSlotDataSize = 3840 * 2160 * 2;
+
+ShmExporter::ShmExporter(size_t maxQueuedFrames)
+    : m_maxQueuedFrames(maxQueuedFrames) {}
+
+ShmExporter::~ShmExporter() {
+    stop();
+}
+
+bool ShmExporter::start(const std::string& name, Uint32 slotCount) {
+    stop();
+
+    if(!m_ring.create(name, slotCount, initialSlotDataSize)) {
+        return false;
+    }
+
+    m_name           = name;
+    m_slotCount      = slotCount;
+    m_slotSize       = m_ring.getSlotDataSize();
+    m_framesExported = 0;
+    m_framesDropped  = 0;
+    m_bytesExported  = 0;
+    m_resizes        = 0;
+
+    m_running = true;
+    m_thread  = std::thread(&ShmExporter::writerThread, this);
+
+    SDL_Log("Exporting frames to shared memory %s (%u slots of %zu bytes)", name.c_str(), slotCount, m_slotSize);
+    return true;
+}
+
+void ShmExporter::stop() {
+    m_queueMutex.lock();
+    m_running = false;
+    m_queueMutex.unlock();
+
+    // the writer thread also stops on its own when it cant replace the ring
+    if(!m_thread.joinable()) {
+        return;
+    }
+
+    m_queueCondition.notify_all();
+    m_thread.join();
+
+    m_queue.clear();
+    m_ring.close();
+}
+
+bool ShmExporter::isRunning() const { return m_running; }
+const std::string& ShmExporter::getName() const { return m_name; }
+
+void ShmExporter::onFrame(const FramePtr& frame) {
+    {
+        std::lock_guard lock(m_queueMutex);
+        if(!m_running) {
+            return;
+        }
+
+        if(m_queue.size() >= m_maxQueuedFrames) {
+            m_framesDropped++;
+            return;
+        }
+
+        m_queue.push_back(frame);
+    }
+
+    m_queueCondition.notify_one();
+}
+
+ShmExporter::Stats ShmExporter::getStats() {
+    std::lock_guard lock(m_queueMutex);
+
+    return Stats{
+        .framesExported = m_framesExported,
+        .framesDropped  = m_framesDropped,
+        .bytesExported  = m_bytesExported,
+        .resizes        = m_resizes,
+        .slotCount      = m_slotCount,
+        .slotSize       = m_slotSize
+    };
+}
+
+void ShmExporter::writerThread() {
+    std::unique_lock lock(m_queueMutex);
+
+    while(true) {
+        m_queueCondition.wait(lock, [this] { return !m_running || !m_queue.empty(); });
+        if(!m_running) {
+            break;
+        }
+
+        FramePtr frame = std::move(m_queue.front());
+        m_queue.pop_front();
+        lock.unlock();
+
+        // readers notice the closed flag and reopen the new ring under the same name
+        bool resized = false;
+        if(frame->size > m_ring.getSlotDataSize()) {
+            m_ring.close();
+            resized = true;
+
+            if(!m_ring.create(m_name, m_slotCount, frame->size)) {
+                lock.lock();
+                m_running = false;
+                m_queue.clear();
+                break;
+            }
+        }
+
+        const ShmSlotHeader info = {
+            .sequence      = {},
+            .format        = (Uint32)frame->format,
+            .width         = (Uint32)frame->width,
+            .height        = (Uint32)frame->height,
+            .pitch         = (Uint32)frame->pitch,
+            .size          = frame->size,
+            .timestampNS   = frame->timestampNS,
+            .frameSequence = frame->sequence
+        };
+
+        m_ring.write(info, frame->pixels);
+
+        lock.lock();
+        m_framesExported++;
+        m_bytesExported += frame->size;
+        if(resized) {
+            m_resizes++;
+            m_slotSize = m_ring.getSlotDataSize();
+        }
+    }
+}
@@ -0,0 +1,218 @@
+#include <cstring>
+#include <fcntl.h>
+#include <shm_ring.hpp>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+static_assert(sizeof(ShmRingHeader) <= ShmRing::headerSize && sizeof(ShmSlotHeader) <= ShmRing::slotHeaderSize);
+
+static constexpr size_t pageSize = 4096;
+
+static size_t alignSize(size_t size) { return (size + pageSize - 1) & ~(pageSize - 1); }
+
+ShmRing::~ShmRing() { close(); }
+
+bool ShmRing::create(const std::string& name, Uint32 slotCount, size_t slotDataSize) {
+    close();
+
+    // whatever a crashed writer left behind
+    shm_unlink(name.c_str());
+
+    m_fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if(m_fd < 0) {
+        SDL_Log("Couldn't create shared memory %s: %s", name.c_str(), strerror(errno));
+        return false;
+    }
+
+    const size_t slotSize = alignSize(slotHeaderSize + slotDataSize);
+    m_size                = headerSize + slotSize * slotCount;
+
+    if(ftruncate(m_fd, m_size) != 0) {
+        SDL_Log("Couldn't size shared memory %s to %zu bytes: %s", name.c_str(), m_size, strerror(errno));
+
+        ::close(m_fd);
+        m_fd = -1;
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    void* memory = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if(memory == MAP_FAILED) {
+        SDL_Log("Couldn't map shared memory %s: %s", name.c_str(), strerror(errno));
+
+        ::close(m_fd);
+        m_fd = -1;
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    m_name   = name;
+    m_writer = true;
+    m_memory = (Uint8*)memory;
+    m_header = new(m_memory) ShmRingHeader{};
+
+    m_header->version        = version;
+    m_header->slotCount      = slotCount;
+    m_header->slotHeaderSize = slotHeaderSize;
+    m_header->slotSize       = slotSize;
+
+    for(Uint32 i = 0; i < slotCount; i++) {
+        new(getSlot(i)) ShmSlotHeader{};
+    }
+
+    // magic last, a reader that sees it sees a complete header
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(m_header->magic, "CCRS", 4);
+
+    return true;
+}
+
+bool ShmRing::open(const std::string& name) {
+    close();
+
+    m_fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if(m_fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if(fstat(m_fd, &info) != 0 || (size_t)info.st_size < headerSize) {
+        ::close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+
+    m_size       = info.st_size;
+    void* memory = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, m_fd, 0);
+    if(memory == MAP_FAILED) {
+        ::close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+
+    m_name   = name;
+    m_writer = false;
+    m_memory = (Uint8*)memory;
+    m_header = (ShmRingHeader*)m_memory;
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if(memcmp(m_header->magic, "CCRS", 4) != 0 || m_header->version != version || headerSize + m_header->slotSize * m_header->slotCount > m_size) {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void ShmRing::close() {
+    if(m_memory == nullptr) {
+        return;
+    }
+
+    if(m_writer) {
+        m_header->closed = 1;
+        m_header->notify.fetch_add(1);
+
+#ifdef __linux__
+        syscall(SYS_futex, &m_header->notify, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#endif
+
+        shm_unlink(m_name.c_str());
+    }
+
+    munmap(m_memory, m_size);
+    ::close(m_fd);
+
+    m_fd     = -1;
+    m_memory = nullptr;
+    m_header = nullptr;
+    m_size   = 0;
+}
+
+bool ShmRing::isOpen() const { return m_memory != nullptr; }
+bool ShmRing::isClosed() const { return m_header == nullptr || m_header->closed != 0; }
+size_t ShmRing::getSlotDataSize() const { return m_header == nullptr ? 0 : m_header->slotSize - slotHeaderSize; }
+const ShmRingHeader* ShmRing::getHeader() const { return m_header; }
+
+void ShmRing::write(const ShmSlotHeader& info, const Uint8* data) {
+    const Uint64 index  = m_header->published.load(std::memory_order_relaxed);
+    ShmSlotHeader* slot = (ShmSlotHeader*)getSlot(index);
+
+    // odd while writing, the fence keeps the payload from being written before readers can tell
+    slot->sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot->format        = info.format;
+    slot->width         = info.width;
+    slot->height        = info.height;
+    slot->pitch         = info.pitch;
+    slot->size          = info.size;
+    slot->timestampNS   = info.timestampNS;
+    slot->frameSequence = info.frameSequence;
+
+    memcpy((Uint8*)slot + slotHeaderSize, data, info.size);
+
+    slot->sequence.store(2 * index + 2, std::memory_order_release);
+    m_header->published.store(index + 1, std::memory_order_release);
+    m_header->notify.fetch_add(1, std::memory_order_release);
+
+#ifdef __linux__
+    syscall(SYS_futex, &m_header->notify, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+Uint64 ShmRing::wait(Uint64 seen, int timeoutMS) const {
+    const Uint64 deadlineNS = SDL_GetTicksNS() + (Uint64)timeoutMS * SDL_NS_PER_MS;
+
+    while(true) {
+        const Uint32 notify    = m_header->notify.load(std::memory_order_acquire);
+        const Uint64 published = m_header->published.load(std::memory_order_acquire);
+        if(published > seen || m_header->closed != 0) {
+            return published;
+        }
+
+        const Uint64 nowNS = SDL_GetTicksNS();
+        if(nowNS >= deadlineNS) {
+            return published;
+        }
+
+#ifdef __linux__
+        // returns straight away if notify changed since it was read, so no wakeup can be missed
+        const Uint64 remainingNS = deadlineNS - nowNS;
+        struct timespec timeout  = { (time_t)(remainingNS / SDL_NS_PER_SECOND), (long)(remainingNS % SDL_NS_PER_SECOND) };
+        syscall(SYS_futex, &m_header->notify, FUTEX_WAIT, notify, &timeout, nullptr, 0);
+#else
+        (void)notify;
+        SDL_DelayNS(SDL_NS_PER_MS);
+#endif
+    }
+}
+
+bool ShmRing::acquire(Uint64 index, View* view) const {
+    const ShmSlotHeader* slot = (const ShmSlotHeader*)getSlot(index);
+
+    const Uint64 sequence = slot->sequence.load(std::memory_order_acquire);
+    if(sequence != 2 * index + 2) {
+        return false;
+    }
+
+    view->header   = slot;
+    view->data     = (const Uint8*)slot + slotHeaderSize;
+    view->sequence = sequence;
+
+    return true;
+}
+
+bool ShmRing::validate(const View& view) const {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return view.header->sequence.load(std::memory_order_relaxed) == view.sequence;
+}
+
+Uint8* ShmRing::getSlot(Uint64 index) const { return m_memory + headerSize + (index % m_header->slotCount) * m_header->slotSize; }
@@ -0,0 +1,241 @@
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <udp_audio.hpp>
+#include <unistd.h>
+
+// how long a blocked receive waits before checking whether we are stopping
+static constexpr int receiveTimeoutMS = 100;
+
+UdpAudioReceiver::UdpAudioReceiver(Uint64 targetLatencyMS)
+    : m_targetPackets(std::max<size_t>(1, (targetLatencyMS + udpAudioPacketMS - 1) / udpAudioPacketMS))
+    , m_slots(slotCount)
+    , m_running(false) {
+    for(Slot& slot : m_slots) {
+        slot.data.resize(udpAudioPacketSize);
+    }
+}
+
+UdpAudioReceiver::~UdpAudioReceiver() {
+    stop();
+}
+
+bool UdpAudioReceiver::start(const std::string& address, Uint16 port) {
+    stop();
+
+    sockaddr_in bindAddress = {};
+    bindAddress.sin_family  = AF_INET;
+    bindAddress.sin_port    = htons(port);
+    if(inet_pton(AF_INET, address.c_str(), &bindAddress.sin_addr) != 1) {
+        SDL_Log("Invalid audio receive address: %s", address.c_str());
+        return false;
+    }
+
+    m_fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if(m_fd < 0) {
+        SDL_Log("Couldn't create audio receive socket: %s", strerror(errno));
+        return false;
+    }
+
+    const timeval timeout = { .tv_sec = 0, .tv_usec = receiveTimeoutMS * 1000 };
+    setsockopt(m_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    if(bind(m_fd, (sockaddr*)&bindAddress, sizeof(bindAddress)) != 0) {
+        SDL_Log("Couldn't receive audio on %s:%u: %s", address.c_str(), port, strerror(errno));
+
+        close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+
+    m_port            = port;
+    m_started         = false;
+    m_playing         = false;
+    m_lastArrivalNS   = 0;
+    m_jitterNS        = 0.0;
+    m_packetsReceived = 0;
+    m_packetsLost     = 0;
+    m_packetsLate     = 0;
+    m_packetsSkipped  = 0;
+    m_underruns       = 0;
+
+    m_running = true;
+    m_thread  = std::thread(&UdpAudioReceiver::receiveThread, this);
+
+    SDL_Log("Receiving audio on %s:%u, %zums buffered", address.c_str(), port, m_targetPackets * udpAudioPacketMS);
+    return true;
+}
+
+void UdpAudioReceiver::stop() {
+    if(!m_running) {
+        return;
+    }
+
+    m_running = false;
+    m_thread.join();
+
+    close(m_fd);
+    m_fd = -1;
+}
+
+bool UdpAudioReceiver::isRunning() const { return m_running; }
+Uint16 UdpAudioReceiver::getPort() const { return m_port; }
+
+void UdpAudioReceiver::read(Uint8* out, size_t size) {
+    std::lock_guard lock(m_mutex);
+
+    while(size > 0) {
+        if(!m_playing) {
+            if(getBufferedPackets() < m_targetPackets) {
+                memset(out, 0, size);
+                return;
+            }
+
+            m_playing = true;
+        }
+
+        Slot& slot = m_slots[m_nextSequence % slotCount];
+
+        if(m_readOffset == 0) {
+            // nothing newer either, the sender stopped or the network stalled. wait for the target latency again
+            if(getBufferedPackets() == 0) {
+                m_playing = false;
+                m_underruns++;
+                continue;
+            }
+
+            // newer packets are here already, this one is lost or too late to matter
+            m_concealing = !slot.filled || slot.sequence != m_nextSequence;
+        }
+
+        const size_t copied = std::min(size, udpAudioPacketSize - m_readOffset);
+        if(m_concealing) {
+            memset(out, 0, copied);
+        }
+        else {
+            memcpy(out, slot.data.data() + m_readOffset, copied);
+        }
+
+        out          += copied;
+        size         -= copied;
+        m_readOffset += copied;
+
+        if(m_readOffset < udpAudioPacketSize) {
+            continue;
+        }
+
+        if(m_concealing) {
+            m_packetsLost++;
+        }
+
+        slot.filled  = false;
+        m_readOffset = 0;
+        m_nextSequence++;
+
+        // the two sound cards clocks drift apart, so the buffer slowly grows or runs dry. growing is fixed here by
+        // skipping ahead once it's well past the target, running dry by the underrun above
+        if(getBufferedPackets() > m_targetPackets * 2 + 4) {
+            while(getBufferedPackets() > m_targetPackets) {
+                m_slots[m_nextSequence % slotCount].filled = false;
+                m_nextSequence++;
+                m_packetsSkipped++;
+            }
+        }
+    }
+}
+
+UdpAudioReceiver::Stats UdpAudioReceiver::getStats() {
+    std::lock_guard lock(m_mutex);
+
+    return Stats{
+        .receiving       = m_lastArrivalNS != 0 && SDL_GetTicksNS() - m_lastArrivalNS < SDL_NS_PER_SECOND,
+        .packetsReceived = m_packetsReceived,
+        .packetsLost     = m_packetsLost,
+        .packetsLate     = m_packetsLate,
+        .packetsSkipped  = m_packetsSkipped,
+        .underruns       = m_underruns,
+        .jitterMS        = m_jitterNS / SDL_NS_PER_MS,
+        .bufferedMS      = (double)(getBufferedPackets() * udpAudioPacketMS),
+        .bufferBytes     = m_slots.size() * udpAudioPacketSize
+    };
+}
+
+void UdpAudioReceiver::receiveThread() {
+    std::vector<Uint8> packet(sizeof(UdpAudioHeader) + udpAudioPacketSize + 1);
+
+    while(m_running) {
+        const ssize_t received = recv(m_fd, packet.data(), packet.size(), 0);
+        if(received != (ssize_t)(sizeof(UdpAudioHeader) + udpAudioPacketSize)) {
+            continue;
+        }
+
+        UdpAudioHeader header;
+        memcpy(&header, packet.data(), sizeof(header));
+        if(memcmp(header.magic, udpAudioMagic, sizeof(header.magic)) != 0) {
+            continue;
+        }
+
+        insert(header, packet.data() + sizeof(header));
+    }
+}
+
+void UdpAudioReceiver::insert(const UdpAudioHeader& header, const Uint8* data) {
+    const Uint64 arrivalNS = SDL_GetTicksNS();
+
+    std::lock_guard lock(m_mutex);
+    m_packetsReceived++;
+
+    // how much the spacing between arrivals differs from the spacing the sender recorded them at
+    if(m_lastArrivalNS != 0) {
+        const double difference = (double)(Sint64)(arrivalNS - m_lastArrivalNS) - (double)(Sint64)(header.timestampNS - m_lastSentNS);
+        m_jitterNS += (std::abs(difference) - m_jitterNS) / 16.0;
+    }
+
+    m_lastArrivalNS = arrivalNS;
+    m_lastSentNS    = header.timestampNS;
+
+    const Sint32 ahead = (Sint32)(header.sequence - m_nextSequence);
+
+    // the sender restarted or we didnt play anything for a long time, start over from this packet
+    if(!m_started || ahead >= (Sint32)slotCount || ahead < -(Sint32)slotCount) {
+        for(Slot& slot : m_slots) {
+            slot.filled = false;
+        }
+
+        m_started      = true;
+        m_playing      = false;
+        m_nextSequence = header.sequence;
+        m_lastSequence = header.sequence;
+        m_readOffset   = 0;
+    }
+    else if(ahead < 0) {
+        m_packetsLate++;
+        return;
+    }
+
+    Slot& slot = m_slots[header.sequence % slotCount];
+    if(slot.filled && slot.sequence == header.sequence) {
+        m_packetsLate++;
+        return;
+    }
+
+    slot.filled   = true;
+    slot.sequence = header.sequence;
+    memcpy(slot.data.data(), data, udpAudioPacketSize);
+
+    if((Sint32)(header.sequence - m_lastSequence) > 0) {
+        m_lastSequence = header.sequence;
+    }
+}
+
+size_t UdpAudioReceiver::getBufferedPackets() const {
+    if(!m_started) {
+        return 0;
+    }
+
+    return (size_t)std::max<Sint32>(0, (Sint32)(m_lastSequence - m_nextSequence) + 1);
+}
@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <udp_audio.hpp>
+#include <unistd.h>
+
+UdpAudioSender::UdpAudioSender()
+    : m_packet(sizeof(UdpAudioHeader) + udpAudioPacketSize)
+    , m_held(sizeof(UdpAudioHeader) + udpAudioPacketSize)
+    , m_loss(0.0f)
+    , m_reorder(0.0f)
+    , m_packetsSent(0)
+    , m_packetsFailed(0)
+    , m_packetsLost(0)
+    , m_packetsReordered(0)
+    , m_running(false) {}
+
+UdpAudioSender::~UdpAudioSender() {
+    stop();
+}
+
+bool UdpAudioSender::start(const std::string& host, Uint16 port) {
+    stop();
+
+    addrinfo hints    = {};
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+
+    addrinfo* addresses = nullptr;
+    const int error     = getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses);
+    if(error != 0) {
+        SDL_Log("Couldn't resolve %s: %s", host.c_str(), gai_strerror(error));
+        return false;
+    }
+
+    // connected, so every packet is a plain send and the kernel knows the route up front
+    for(addrinfo* address = addresses; address != nullptr && m_fd < 0; address = address->ai_next) {
+        m_fd = socket(address->ai_family, address->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, address->ai_protocol);
+        if(m_fd >= 0 && connect(m_fd, address->ai_addr, address->ai_addrlen) != 0) {
+            close(m_fd);
+            m_fd = -1;
+        }
+    }
+
+    freeaddrinfo(addresses);
+
+    if(m_fd < 0) {
+        SDL_Log("Couldn't send audio to %s:%u: %s", host.c_str(), port, strerror(errno));
+        return false;
+    }
+
+    m_destination      = host + ":" + std::to_string(port);
+    m_packetFill       = 0;
+    m_sequence         = 0;
+    m_holding          = false;
+    m_packetsSent      = 0;
+    m_packetsFailed    = 0;
+    m_packetsLost      = 0;
+    m_packetsReordered = 0;
+
+    m_running = true;
+
+    SDL_Log("Sending audio to %s", m_destination.c_str());
+    return true;
+}
+
+void UdpAudioSender::stop() {
+    if(!m_running) {
+        return;
+    }
+
+    m_running = false;
+
+    close(m_fd);
+    m_fd = -1;
+}
+
+bool UdpAudioSender::isRunning() const { return m_running; }
+const std::string& UdpAudioSender::getDestination() const { return m_destination; }
+
+void UdpAudioSender::setImpairment(float loss, float reorder) {
+    m_loss    = loss;
+    m_reorder = reorder;
+}
+
+void UdpAudioSender::onAudio(const Uint8* data, size_t size, Uint64 timestampNS) {
+    if(!m_running) {
+        return;
+    }
+
+    while(size > 0) {
+        // the packet is dated by its first sample
+        if(m_packetFill == 0) {
+            UdpAudioHeader* header = (UdpAudioHeader*)m_packet.data();
+            memcpy(header->magic, udpAudioMagic, sizeof(header->magic));
+            header->sequence    = m_sequence++;
+            header->timestampNS = timestampNS;
+        }
+
+        // sending may have swapped the buffer with a held back one, so it's looked up every time
+        const size_t copied = std::min(size, udpAudioPacketSize - m_packetFill);
+        memcpy(m_packet.data() + sizeof(UdpAudioHeader) + m_packetFill, data, copied);
+
+        m_packetFill += copied;
+        data         += copied;
+        size         -= copied;
+        timestampNS  += copied * SDL_NS_PER_SECOND / udpAudioBytesPerSecond;
+
+        if(m_packetFill == udpAudioPacketSize) {
+            sendPacket();
+            m_packetFill = 0;
+        }
+    }
+}
+
+UdpAudioSender::Stats UdpAudioSender::getStats() const {
+    return Stats{
+        .packetsSent      = m_packetsSent,
+        .packetsFailed    = m_packetsFailed,
+        .packetsLost      = m_packetsLost,
+        .packetsReordered = m_packetsReordered
+    };
+}
+
+void UdpAudioSender::sendPacket() {
+    if(roll(m_loss)) {
+        m_packetsLost++;
+        return;
+    }
+
+    // hold this one back and send it after the next
+    if(!m_holding && roll(m_reorder)) {
+        std::swap(m_packet, m_held);
+        m_holding = true;
+
+        m_packetsReordered++;
+        return;
+    }
+
+    if(send(m_fd, m_packet.data(), m_packet.size(), MSG_DONTWAIT | MSG_NOSIGNAL) < 0) {
+        m_packetsFailed++;
+    }
+    else {
+        m_packetsSent++;
+    }
+
+    if(m_holding) {
+        m_holding = false;
+
+        if(send(m_fd, m_held.data(), m_held.size(), MSG_DONTWAIT | MSG_NOSIGNAL) < 0) {
+            m_packetsFailed++;
+        }
+        else {
+            m_packetsSent++;
+        }
+    }
+}
+
+// xorshift, good enough to decide which packets to mess with
+bool UdpAudioSender::roll(float chance) {
+    if(chance <= 0.0f) {
+        return false;
+    }
+
+    m_random ^= m_random << 13;
+    m_random ^= m_random >> 17;
+    m_random ^= m_random << 5;
+
+    return (m_random & 0xFFFFFF) < chance * 0x1000000;
+}
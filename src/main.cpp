@@ -2,6 +2,8 @@
 #include <settings.hpp>
 
 int main(int argc, char** argv) {
+    Settings::get()->setOverrides(argc, argv);
+
     Application* app = new Application();
     while(app->loop());
 
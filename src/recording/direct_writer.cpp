@@ -0,0 +1,224 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <direct_writer.hpp>
+
+DirectWriter::DirectWriter(size_t queueDepth)
+    : m_queueDepth(queueDepth)
+    , m_inFlight(0)
+    , m_bytesWritten(0)
+    , m_writeErrors(0) {}
+
+DirectWriter::~DirectWriter() {
+    close();
+}
+
+bool DirectWriter::open(const std::string& path) {
+    close();
+
+    m_direct = true;
+    m_fd     = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+    if(m_fd < 0 && errno == EINVAL) {
+        m_direct = false;
+        m_fd     = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    }
+
+    if(m_fd < 0) {
+        SDL_Log("Couldn't open %s for writing: %s", path.c_str(), strerror(errno));
+        return false;
+    }
+
+    m_bytesWritten = 0;
+    m_writeErrors  = 0;
+
+#ifdef HAVE_LIBURING
+    int err = io_uring_queue_init(m_queueDepth, &m_ring, 0);
+    if(err == 0) {
+        m_uring = true;
+        return true;
+    }
+
+    SDL_Log("io_uring unavailable (%s), falling back to pwrite", strerror(-err));
+#endif
+
+    m_pool = std::make_unique<WorkerPool>(2, m_queueDepth);
+    return true;
+}
+
+void DirectWriter::close() {
+    if(m_fd < 0) {
+        return;
+    }
+
+    flush();
+
+#ifdef HAVE_LIBURING
+    if(m_uring) {
+        io_uring_queue_exit(&m_ring);
+        m_uring = false;
+    }
+#endif
+
+    m_pool.reset();
+
+    ::close(m_fd);
+    m_fd = -1;
+}
+
+bool DirectWriter::isOpen() const { return m_fd >= 0; }
+bool DirectWriter::isDirect() const { return m_direct; }
+
+bool DirectWriter::isUsingUring() const {
+#ifdef HAVE_LIBURING
+    return m_uring;
+#else
+    return false;
+#endif
+}
+
+void DirectWriter::write(const void* data, size_t size, Uint64 offset, std::shared_ptr<void> keepAlive) {
+    if(m_fd < 0) {
+        return;
+    }
+
+    Request* request = new Request{ (const Uint8*)data, size, offset, std::move(keepAlive) };
+    m_inFlight++;
+
+#ifdef HAVE_LIBURING
+    if(m_uring) {
+        while(m_inFlight > m_queueDepth) {
+            reapUring(true);
+        }
+
+        if(submitUring(request)) {
+            reapUring(false);
+            return;
+        }
+
+        // couldn't get a submission slot, do this one synchronously
+        writeBlocking(request);
+        return;
+    }
+#endif
+
+    m_pool->submit([this, request]() { writeBlocking(request); });
+}
+
+void DirectWriter::flush() {
+#ifdef HAVE_LIBURING
+    if(m_uring) {
+        while(m_inFlight > 0) {
+            reapUring(true);
+        }
+
+        return;
+    }
+#endif
+
+    if(m_pool != nullptr) {
+        m_pool->wait();
+    }
+}
+
+Uint64 DirectWriter::getBytesWritten() const { return m_bytesWritten; }
+Uint64 DirectWriter::getWriteErrors() const { return m_writeErrors; }
+size_t DirectWriter::getInFlight() const { return m_inFlight; }
+
+size_t DirectWriter::getResumableSize(size_t written) const {
+    return m_direct ? written & ~(alignment - 1) : written;
+}
+
+void DirectWriter::writeBlocking(Request* request) {
+    size_t written = 0;
+    while(written < request->size) {
+        ssize_t res = pwrite(m_fd, request->data + written, request->size - written, request->offset + written);
+        if(res < 0 && errno == EINTR) {
+            continue;
+        }
+
+        // under O_DIRECT the rest of a short write has to start on a block boundary again
+        const size_t resumable = res > 0 ? getResumableSize(res) : 0;
+        if(resumable == 0) {
+            m_writeErrors++;
+            break;
+        }
+
+        written += resumable;
+    }
+
+    m_bytesWritten += written;
+    m_inFlight--;
+
+    delete request;
+}
+
+#ifdef HAVE_LIBURING
+bool DirectWriter::submitUring(Request* request) {
+    struct io_uring_sqe* sqe = io_uring_get_sqe(&m_ring);
+    if(sqe == nullptr) {
+        io_uring_submit(&m_ring);
+        if((sqe = io_uring_get_sqe(&m_ring)) == nullptr) {
+            return false;
+        }
+    }
+
+    io_uring_prep_write(sqe, m_fd, request->data, request->size, request->offset);
+    io_uring_sqe_set_data(sqe, request);
+
+    // once the sqe is queued the request belongs to the ring, if this submit fails the next one (or reapUring) sends it
+    io_uring_submit(&m_ring);
+    return true;
+}
+
+void DirectWriter::reapUring(bool wait) {
+    // sends anything a failed submit left queued, otherwise waiting could block on writes that never went out
+    io_uring_submit(&m_ring);
+
+    struct io_uring_cqe* cqe = nullptr;
+
+    int err = wait ? io_uring_wait_cqe(&m_ring, &cqe) : io_uring_peek_cqe(&m_ring, &cqe);
+    while(err == 0 && cqe != nullptr) {
+        Request* request = (Request*)io_uring_cqe_get_data(cqe);
+        const int res    = cqe->res;
+
+        io_uring_cqe_seen(&m_ring, cqe);
+
+        const size_t resumable = res > 0 && (size_t)res < request->size ? getResumableSize(res) : 0;
+        if(resumable > 0) {
+            // short write, send the rest
+            m_bytesWritten += resumable;
+
+            request->data   += resumable;
+            request->size   -= resumable;
+            request->offset += resumable;
+
+            if(!submitUring(request)) {
+                writeBlocking(request);
+            }
+        }
+        else if(res > 0 && (size_t)res < request->size) {
+            // less than a block went out under O_DIRECT, nothing can be resent from an aligned offset
+            m_writeErrors++;
+
+            m_inFlight--;
+            delete request;
+        }
+        else {
+            if(res < 0) {
+                m_writeErrors++;
+            }
+            else {
+                m_bytesWritten += res;
+            }
+
+            m_inFlight--;
+            delete request;
+        }
+
+        cqe = nullptr;
+        err = io_uring_peek_cqe(&m_ring, &cqe);
+    }
+}
+#endif
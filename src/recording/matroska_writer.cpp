@@ -0,0 +1,383 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <matroska_writer.hpp>
+
+// element ids, see https://www.matroska.org/technical/elements.html
+enum : Uint32 {
+    EBML_ID_HEADER                = 0x1A45DFA3,
+    EBML_ID_VERSION               = 0x4286,
+    EBML_ID_READ_VERSION          = 0x42F7,
+    EBML_ID_MAX_ID_LENGTH         = 0x42F2,
+    EBML_ID_MAX_SIZE_LENGTH       = 0x42F3,
+    EBML_ID_DOC_TYPE              = 0x4282,
+    EBML_ID_DOC_TYPE_VERSION      = 0x4287,
+    EBML_ID_DOC_TYPE_READ_VERSION = 0x4285,
+    EBML_ID_VOID                  = 0xEC,
+
+    MKV_ID_SEGMENT            = 0x18538067,
+    MKV_ID_SEEK_HEAD          = 0x114D9B74,
+    MKV_ID_SEEK               = 0x4DBB,
+    MKV_ID_SEEK_ID            = 0x53AB,
+    MKV_ID_SEEK_POSITION      = 0x53AC,
+    MKV_ID_INFO               = 0x1549A966,
+    MKV_ID_TIMESTAMP_SCALE    = 0x2AD7B1,
+    MKV_ID_MUXING_APP         = 0x4D80,
+    MKV_ID_WRITING_APP        = 0x5741,
+    MKV_ID_DURATION           = 0x4489,
+    MKV_ID_TRACKS             = 0x1654AE6B,
+    MKV_ID_TRACK_ENTRY        = 0xAE,
+    MKV_ID_TRACK_NUMBER       = 0xD7,
+    MKV_ID_TRACK_UID          = 0x73C5,
+    MKV_ID_TRACK_TYPE         = 0x83,
+    MKV_ID_FLAG_LACING        = 0x9C,
+    MKV_ID_CODEC_ID           = 0x86,
+    MKV_ID_VIDEO              = 0xE0,
+    MKV_ID_PIXEL_WIDTH        = 0xB0,
+    MKV_ID_PIXEL_HEIGHT       = 0xBA,
+    MKV_ID_COLOUR_SPACE       = 0x2EB524,
+    MKV_ID_AUDIO              = 0xE1,
+    MKV_ID_SAMPLING_FREQUENCY = 0xB5,
+    MKV_ID_CHANNELS           = 0x9F,
+    MKV_ID_BIT_DEPTH          = 0x6264,
+    MKV_ID_CLUSTER            = 0x1F43B675,
+    MKV_ID_CLUSTER_TIMESTAMP  = 0xE7,
+    MKV_ID_SIMPLE_BLOCK       = 0xA3,
+    MKV_ID_CUES               = 0x1C53BB6B,
+    MKV_ID_CUE_POINT          = 0xBB,
+    MKV_ID_CUE_TIME           = 0xB3,
+    MKV_ID_CUE_TRACK_POSITION = 0xB7,
+    MKV_ID_CUE_TRACK          = 0xF7,
+    MKV_ID_CUE_CLUSTER_POS    = 0xF1
+};
+
+static constexpr Uint8 videoTrackNumber = 1;
+static constexpr Uint8 audioTrackNumber = 2;
+
+// room left after the segment header for the seek head written on close
+static constexpr size_t seekHeadReservation = 128;
+
+// new clusters start on a video keyframe once the current one spans this long, or whenever it gets too big
+static constexpr Uint64 clusterDurationMS = 1000;
+static constexpr size_t maxClusterSize    = 8 * 1024 * 1024;
+
+static void putID(std::vector<Uint8>& out, Uint32 id) {
+    for(int shift = 24; shift >= 0; shift -= 8) {
+        if((id >> shift) != 0) {
+            out.push_back((Uint8)(id >> shift));
+        }
+    }
+}
+
+static void putSize(std::vector<Uint8>& out, Uint64 size) {
+    int length = 1;
+    while(length < 8 && size >= (1ull << (7 * length)) - 1) {
+        length++;
+    }
+
+    const Uint64 value = size | (1ull << (7 * length));
+    for(int i = length - 1; i >= 0; i--) {
+        out.push_back((Uint8)(value >> (8 * i)));
+    }
+}
+
+static void putFixedSize(std::vector<Uint8>& out, Uint64 size) {
+    out.push_back(0x01);
+    for(int i = 6; i >= 0; i--) {
+        out.push_back((Uint8)(size >> (8 * i)));
+    }
+}
+
+static void putUInt(std::vector<Uint8>& out, Uint32 id, Uint64 value) {
+    int length = 1;
+    while(length < 8 && (value >> (8 * length)) != 0) {
+        length++;
+    }
+
+    putID(out, id);
+    putSize(out, length);
+    for(int i = length - 1; i >= 0; i--) {
+        out.push_back((Uint8)(value >> (8 * i)));
+    }
+}
+
+static void putFloat(std::vector<Uint8>& out, Uint32 id, double value) {
+    Uint64 bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    putID(out, id);
+    putSize(out, 8);
+    for(int i = 7; i >= 0; i--) {
+        out.push_back((Uint8)(bits >> (8 * i)));
+    }
+}
+
+static void putBinary(std::vector<Uint8>& out, Uint32 id, const void* data, size_t size) {
+    putID(out, id);
+    putSize(out, size);
+    out.insert(out.end(), (const Uint8*)data, (const Uint8*)data + size);
+}
+
+static void putString(std::vector<Uint8>& out, Uint32 id, const std::string& value) { putBinary(out, id, value.data(), value.size()); }
+static void putMaster(std::vector<Uint8>& out, Uint32 id, const std::vector<Uint8>& children) { putBinary(out, id, children.data(), children.size()); }
+
+static void putVoid(std::vector<Uint8>& out, size_t totalSize) {
+    // one byte id, one byte size, so anything from 2 to 128 bytes can be filled exactly
+    out.push_back((Uint8)EBML_ID_VOID);
+    out.push_back((Uint8)(0x80 | (totalSize - 2)));
+    out.insert(out.end(), totalSize - 2, 0);
+}
+
+MatroskaWriter::MatroskaWriter() {}
+
+MatroskaWriter::~MatroskaWriter() {
+    close();
+}
+
+bool MatroskaWriter::open(const std::string& path, const VideoTrack& video, const AudioTrack* audio) {
+    close();
+
+    m_file = fopen(path.c_str(), "wb");
+    if(m_file == nullptr) {
+        SDL_Log("Couldn't open %s for writing: %s", path.c_str(), strerror(errno));
+        return false;
+    }
+
+    setvbuf(m_file, nullptr, _IOFBF, 1024 * 1024);
+
+    m_hasAudio           = audio != nullptr;
+    m_position           = 0;
+    m_lastTimestampMS    = 0;
+    m_clusterTimestampMS = 0;
+    m_clusterHasKeyframe = false;
+    m_cluster.clear();
+    m_cues.clear();
+
+    std::vector<Uint8> out;
+    std::vector<Uint8> children;
+
+    putUInt(children, EBML_ID_VERSION, 1);
+    putUInt(children, EBML_ID_READ_VERSION, 1);
+    putUInt(children, EBML_ID_MAX_ID_LENGTH, 4);
+    putUInt(children, EBML_ID_MAX_SIZE_LENGTH, 8);
+    putString(children, EBML_ID_DOC_TYPE, "matroska");
+    putUInt(children, EBML_ID_DOC_TYPE_VERSION, 4);
+    putUInt(children, EBML_ID_DOC_TYPE_READ_VERSION, 2);
+    putMaster(out, EBML_ID_HEADER, children);
+
+    // unknown size until close, so a crash still leaves a playable file
+    putID(out, MKV_ID_SEGMENT);
+    m_segmentSizePosition = out.size();
+    out.push_back(0x01);
+    out.insert(out.end(), 7, 0xFF);
+
+    m_segmentDataPosition = out.size();
+    m_seekHeadPosition    = out.size();
+    putVoid(out, seekHeadReservation);
+
+    children.clear();
+    putUInt(children, MKV_ID_TIMESTAMP_SCALE, 1000000);
+    putString(children, MKV_ID_MUXING_APP, "CaptureCardRelay");
+    putString(children, MKV_ID_WRITING_APP, "CaptureCardRelay");
+    putFloat(children, MKV_ID_DURATION, 0.0);
+
+    m_infoPosition = out.size();
+    putMaster(out, MKV_ID_INFO, children);
+    // duration is the last child, its 8 byte payload ends the element
+    m_durationPosition = out.size() - 8;
+
+    std::vector<Uint8> tracks;
+    std::vector<Uint8> settings;
+
+    children.clear();
+    putUInt(children, MKV_ID_TRACK_NUMBER, videoTrackNumber);
+    putUInt(children, MKV_ID_TRACK_UID, videoTrackNumber);
+    putUInt(children, MKV_ID_TRACK_TYPE, 1);
+    putUInt(children, MKV_ID_FLAG_LACING, 0);
+    putString(children, MKV_ID_CODEC_ID, video.codecID);
+
+    putUInt(settings, MKV_ID_PIXEL_WIDTH, video.width);
+    putUInt(settings, MKV_ID_PIXEL_HEIGHT, video.height);
+    if(video.fourcc != 0) {
+        putBinary(settings, MKV_ID_COLOUR_SPACE, &video.fourcc, sizeof(video.fourcc));
+    }
+
+    putMaster(children, MKV_ID_VIDEO, settings);
+    putMaster(tracks, MKV_ID_TRACK_ENTRY, children);
+
+    if(audio != nullptr) {
+        children.clear();
+        settings.clear();
+
+        putUInt(children, MKV_ID_TRACK_NUMBER, audioTrackNumber);
+        putUInt(children, MKV_ID_TRACK_UID, audioTrackNumber);
+        putUInt(children, MKV_ID_TRACK_TYPE, 2);
+        putUInt(children, MKV_ID_FLAG_LACING, 0);
+        putString(children, MKV_ID_CODEC_ID, "A_PCM/INT/LIT");
+
+        putFloat(settings, MKV_ID_SAMPLING_FREQUENCY, audio->sampleRate);
+        putUInt(settings, MKV_ID_CHANNELS, audio->channels);
+        putUInt(settings, MKV_ID_BIT_DEPTH, audio->bitDepth);
+
+        putMaster(children, MKV_ID_AUDIO, settings);
+        putMaster(tracks, MKV_ID_TRACK_ENTRY, children);
+    }
+
+    m_tracksPosition = out.size();
+    putMaster(out, MKV_ID_TRACKS, tracks);
+
+    writeRaw(out.data(), out.size());
+    return true;
+}
+
+void MatroskaWriter::close() {
+    if(m_file == nullptr) {
+        return;
+    }
+
+    flushCluster();
+
+    std::vector<Uint8> out;
+    std::vector<Uint8> children;
+    std::vector<Uint8> positions;
+
+    const Uint64 cuesPosition = m_position;
+    for(const CuePoint& cue : m_cues) {
+        positions.clear();
+        putUInt(positions, MKV_ID_CUE_TRACK, videoTrackNumber);
+        putUInt(positions, MKV_ID_CUE_CLUSTER_POS, cue.clusterPosition - m_segmentDataPosition);
+
+        std::vector<Uint8> point;
+        putUInt(point, MKV_ID_CUE_TIME, cue.timestampMS);
+        putMaster(point, MKV_ID_CUE_TRACK_POSITION, positions);
+
+        putMaster(children, MKV_ID_CUE_POINT, point);
+    }
+
+    if(!m_cues.empty()) {
+        putMaster(out, MKV_ID_CUES, children);
+        writeRaw(out.data(), out.size());
+    }
+
+    const Uint64 segmentSize = m_position - m_segmentDataPosition;
+
+    // seek head pointing at the top level elements, padded out to the reserved space
+    out.clear();
+    children.clear();
+
+    const std::pair<Uint32, Uint64> entries[] = {
+        { MKV_ID_INFO,   m_infoPosition   },
+        { MKV_ID_TRACKS, m_tracksPosition },
+        { MKV_ID_CUES,   cuesPosition     }
+    };
+
+    for(const auto& [id, position] : entries) {
+        if(id == MKV_ID_CUES && m_cues.empty()) {
+            continue;
+        }
+
+        std::vector<Uint8> seek;
+        std::vector<Uint8> idBytes;
+        putID(idBytes, id);
+
+        putBinary(seek, MKV_ID_SEEK_ID, idBytes.data(), idBytes.size());
+        putUInt(seek, MKV_ID_SEEK_POSITION, position - m_segmentDataPosition);
+        putMaster(children, MKV_ID_SEEK, seek);
+    }
+
+    putMaster(out, MKV_ID_SEEK_HEAD, children);
+    putVoid(out, seekHeadReservation - out.size());
+
+    fseek(m_file, m_seekHeadPosition, SEEK_SET);
+    fwrite(out.data(), 1, out.size(), m_file);
+
+    out.clear();
+    putFixedSize(out, segmentSize);
+    fseek(m_file, m_segmentSizePosition, SEEK_SET);
+    fwrite(out.data(), 1, out.size(), m_file);
+
+    out.clear();
+    putFloat(out, MKV_ID_DURATION, (double)m_lastTimestampMS);
+    fseek(m_file, m_durationPosition, SEEK_SET);
+    fwrite(out.data() + out.size() - 8, 1, 8, m_file);
+
+    fclose(m_file);
+    m_file = nullptr;
+}
+
+bool MatroskaWriter::isOpen() const { return m_file != nullptr; }
+
+void MatroskaWriter::writeVideo(const Uint8* data, size_t size, Uint64 timestampNS, bool keyframe) {
+    writeBlock(videoTrackNumber, data, size, timestampNS, keyframe);
+}
+
+void MatroskaWriter::writeAudio(const Uint8* data, size_t size, Uint64 timestampNS) {
+    if(!m_hasAudio) {
+        return;
+    }
+
+    writeBlock(audioTrackNumber, data, size, timestampNS, true);
+}
+
+Uint64 MatroskaWriter::getBytesWritten() const { return m_position; }
+
+void MatroskaWriter::writeBlock(Uint8 track, const Uint8* data, size_t size, Uint64 timestampNS, bool keyframe) {
+    if(m_file == nullptr) {
+        return;
+    }
+
+    const Uint64 timestampMS = timestampNS / 1000000;
+    const bool videoKeyframe = track == videoTrackNumber && keyframe;
+
+    if(!m_cluster.empty()) {
+        const Sint64 relative = (Sint64)timestampMS - (Sint64)m_clusterTimestampMS;
+
+        if(relative > INT16_MAX || relative < INT16_MIN || m_cluster.size() + size > maxClusterSize || (videoKeyframe && relative >= (Sint64)clusterDurationMS)) {
+            flushCluster();
+        }
+    }
+
+    if(m_cluster.empty()) {
+        m_clusterTimestampMS = timestampMS;
+        m_clusterHasKeyframe = false;
+
+        putUInt(m_cluster, MKV_ID_CLUSTER_TIMESTAMP, timestampMS);
+    }
+
+    const Sint16 relative = (Sint16)((Sint64)timestampMS - (Sint64)m_clusterTimestampMS);
+
+    putID(m_cluster, MKV_ID_SIMPLE_BLOCK);
+    putSize(m_cluster, 4 + size);
+    m_cluster.push_back(0x80 | track);
+    m_cluster.push_back((Uint8)((Uint16)relative >> 8));
+    m_cluster.push_back((Uint8)((Uint16)relative & 0xFF));
+    m_cluster.push_back(keyframe ? 0x80 : 0x00);
+    m_cluster.insert(m_cluster.end(), data, data + size);
+
+    m_clusterHasKeyframe |= videoKeyframe;
+    m_lastTimestampMS = std::max(m_lastTimestampMS, timestampMS);
+}
+
+void MatroskaWriter::flushCluster() {
+    if(m_cluster.empty()) {
+        return;
+    }
+
+    if(m_clusterHasKeyframe) {
+        m_cues.push_back(CuePoint{ m_clusterTimestampMS, m_position });
+    }
+
+    std::vector<Uint8> header;
+    putID(header, MKV_ID_CLUSTER);
+    putSize(header, m_cluster.size());
+
+    writeRaw(header.data(), header.size());
+    writeRaw(m_cluster.data(), m_cluster.size());
+
+    m_cluster.clear();
+}
+
+void MatroskaWriter::writeRaw(const void* data, size_t size) {
+    fwrite(data, 1, size, m_file);
+    m_position += size;
+}
@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <mjpeg_recorder.hpp>
+
+MjpegRecorder::MjpegRecorder(size_t maxQueuedFrames, size_t maxQueuedAudioPackets)
+    : m_maxQueuedFrames(maxQueuedFrames), m_maxQueuedAudioPackets(maxQueuedAudioPackets) {}
+
+MjpegRecorder::~MjpegRecorder() {
+    stop();
+}
+
+bool MjpegRecorder::start(const std::string& path, int width, int height) {
+    stop();
+
+    const MatroskaWriter::VideoTrack video = { .codecID = "V_MJPEG", .fourcc = 0, .width = width, .height = height };
+    const MatroskaWriter::AudioTrack audio = { .sampleRate = sampleRate, .channels = channels, .bitDepth = bitDepth };
+
+    if(!m_writer.open(path, video, &audio)) {
+        return false;
+    }
+
+    m_freeAudioBuffers.resize(m_maxQueuedAudioPackets);
+    for(std::vector<Uint8>& buffer : m_freeAudioBuffers) {
+        buffer.reserve(packetSize);
+    }
+
+    m_pendingAudio.data.clear();
+    m_pendingAudio.data.reserve(packetSize);
+
+    m_path                = path;
+    m_startNS             = SDL_GetTicksNS();
+    m_framesDropped       = 0;
+    m_framesWritten       = 0;
+    m_audioPacketsDropped = 0;
+    m_audioPacketsWritten = 0;
+    m_bytesWritten        = 0;
+
+    m_recording = true;
+    m_thread    = std::thread(&MjpegRecorder::writerThread, this);
+
+    SDL_Log("Recording MJPEG passthrough to %s (%dx%d)", path.c_str(), width, height);
+    return true;
+}
+
+void MjpegRecorder::stop() {
+    m_queueMutex.lock();
+    if(!m_recording) {
+        m_queueMutex.unlock();
+        return;
+    }
+
+    m_recording = false;
+    m_queueMutex.unlock();
+
+    m_queueCondition.notify_all();
+    m_thread.join();
+
+    // whatever didn't fill a whole packet yet
+    if(!m_pendingAudio.data.empty()) {
+        m_writer.writeAudio(m_pendingAudio.data.data(), m_pendingAudio.data.size(), m_pendingAudio.timestampNS - std::min(m_pendingAudio.timestampNS, m_startNS));
+        m_pendingAudio.data.clear();
+    }
+
+    m_writer.close();
+    m_freeAudioBuffers.clear();
+    m_audioPackets.clear();
+
+    SDL_Log(
+        "Finished recording %s: %llu frames written, %llu dropped, %llu audio packets written, %llu dropped",
+        m_path.c_str(),
+        (unsigned long long)m_framesWritten,
+        (unsigned long long)m_framesDropped,
+        (unsigned long long)m_audioPacketsWritten,
+        (unsigned long long)m_audioPacketsDropped
+    );
+}
+
+bool MjpegRecorder::isRecording() const { return m_recording; }
+const std::string& MjpegRecorder::getPath() const { return m_path; }
+
+void MjpegRecorder::onFrame(const FramePtr& frame) {
+    std::unique_lock lock(m_queueMutex);
+    if(!m_recording || frame->format != SDL_PIXELFORMAT_MJPG || frame->timestampNS < m_startNS) {
+        return;
+    }
+
+    if(m_frames.size() >= m_maxQueuedFrames) {
+        m_framesDropped++;
+        return;
+    }
+
+    m_frames.push_back(frame);
+
+    lock.unlock();
+    m_queueCondition.notify_one();
+}
+
+void MjpegRecorder::onAudio(const Uint8* data, size_t size, Uint64 timestampNS) {
+    std::unique_lock lock(m_queueMutex);
+    if(!m_recording) {
+        return;
+    }
+
+    bool queued = false;
+    while(size > 0) {
+        if(m_pendingAudio.data.empty()) {
+            m_pendingAudio.timestampNS = timestampNS;
+        }
+
+        const size_t chunk = std::min(size, packetSize - m_pendingAudio.data.size());
+        m_pendingAudio.data.insert(m_pendingAudio.data.end(), data, data + chunk);
+
+        data        += chunk;
+        size        -= chunk;
+        timestampNS += chunk * 1000000000ull / bytesPerSecond;
+
+        if(m_pendingAudio.data.size() < packetSize) {
+            continue;
+        }
+
+        if(m_audioPackets.size() >= m_maxQueuedAudioPackets || m_freeAudioBuffers.empty()) {
+            m_audioPacketsDropped++;
+            m_pendingAudio.data.clear();
+            continue;
+        }
+
+        m_audioPackets.push_back(std::move(m_pendingAudio));
+
+        m_pendingAudio.data = std::move(m_freeAudioBuffers.back());
+        m_freeAudioBuffers.pop_back();
+        m_pendingAudio.data.clear();
+
+        queued = true;
+    }
+
+    lock.unlock();
+    if(queued) {
+        m_queueCondition.notify_one();
+    }
+}
+
+MjpegRecorder::Stats MjpegRecorder::getStats() {
+    std::lock_guard lock(m_queueMutex);
+
+    return Stats{
+        .framesWritten       = m_framesWritten,
+        .framesDropped       = m_framesDropped,
+        .audioPacketsWritten = m_audioPacketsWritten,
+        .audioPacketsDropped = m_audioPacketsDropped,
+        .bytesWritten        = m_bytesWritten,
+        .queuedFrames        = m_frames.size(),
+        .queuedAudioPackets  = m_audioPackets.size()
+    };
+}
+
+void MjpegRecorder::writerThread() {
+    std::unique_lock lock(m_queueMutex);
+
+    while(true) {
+        const bool haveFrame = !m_frames.empty();
+        const bool haveAudio = !m_audioPackets.empty();
+
+        if(!haveFrame && !haveAudio) {
+            if(!m_recording) {
+                return;
+            }
+
+            m_queueCondition.wait(lock);
+            continue;
+        }
+
+        bool writeFrame = haveFrame;
+        if(haveFrame && haveAudio) {
+            writeFrame = m_frames.front()->timestampNS <= m_audioPackets.front().timestampNS;
+        }
+        else if(m_recording) {
+            // give the other stream a moment to catch up so blocks land in the file in order
+            const Uint64 headNS = haveFrame ? m_frames.front()->timestampNS : m_audioPackets.front().timestampNS;
+            if(SDL_GetTicksNS() < headNS + maxInterleaveDelayNS) {
+                m_queueCondition.wait_for(lock, std::chrono::milliseconds(10));
+                continue;
+            }
+        }
+
+        if(writeFrame) {
+            FramePtr frame = std::move(m_frames.front());
+            m_frames.pop_front();
+
+            lock.unlock();
+            m_writer.writeVideo(frame->pixels, frame->size, frame->timestampNS - m_startNS);
+            frame.reset();
+            lock.lock();
+
+            m_framesWritten++;
+        }
+        else {
+            AudioPacket packet = std::move(m_audioPackets.front());
+            m_audioPackets.pop_front();
+
+            lock.unlock();
+            m_writer.writeAudio(packet.data.data(), packet.data.size(), packet.timestampNS - std::min(packet.timestampNS, m_startNS));
+            lock.lock();
+
+            m_audioPacketsWritten++;
+            m_freeAudioBuffers.push_back(std::move(packet.data));
+        }
+
+        m_bytesWritten = m_writer.getBytesWritten();
+    }
+}
@@ -0,0 +1,150 @@
+#include <cstring>
+#include <raw_recorder.hpp>
+
+static size_t alignSize(size_t size) { return (size + DirectWriter::alignment - 1) & ~(DirectWriter::alignment - 1); }
+
+RawRecorder::RawRecorder(size_t maxQueuedFrames)
+    : m_maxQueuedFrames(maxQueuedFrames) {}
+
+RawRecorder::~RawRecorder() {
+    stop();
+}
+
+bool RawRecorder::start(const std::string& path) {
+    stop();
+
+    if(!m_writer.open(path)) {
+        return false;
+    }
+
+    m_path          = path;
+    m_offset        = DirectWriter::alignment;
+    m_framesDropped = 0;
+    m_framesWritten = 0;
+    m_highWaterMark = 0;
+    m_index.clear();
+
+    m_recording = true;
+    m_thread    = std::thread(&RawRecorder::writerThread, this);
+
+    SDL_Log("Recording raw frames to %s (%s, %s)", path.c_str(), m_writer.isDirect() ? "O_DIRECT" : "buffered", m_writer.isUsingUring() ? "io_uring" : "pwrite");
+    return true;
+}
+
+void RawRecorder::stop() {
+    m_queueMutex.lock();
+    if(!m_recording) {
+        m_queueMutex.unlock();
+        return;
+    }
+
+    m_recording = false;
+    m_queueMutex.unlock();
+
+    m_queueCondition.notify_all();
+    m_thread.join();
+
+    writeIndex();
+    m_writer.close();
+
+    SDL_Log("Finished recording %s: %llu frames written, %llu dropped", m_path.c_str(), (unsigned long long)m_framesWritten, (unsigned long long)m_framesDropped);
+}
+
+bool RawRecorder::isRecording() const { return m_recording; }
+const std::string& RawRecorder::getPath() const { return m_path; }
+
+void RawRecorder::onFrame(const FramePtr& frame) {
+    std::unique_lock lock(m_queueMutex);
+    if(!m_recording) {
+        return;
+    }
+
+    if(m_queue.size() >= m_maxQueuedFrames) {
+        m_framesDropped++;
+        return;
+    }
+
+    m_queue.push_back(frame);
+    m_highWaterMark = std::max(m_highWaterMark, m_queue.size());
+
+    lock.unlock();
+    m_queueCondition.notify_one();
+}
+
+RawRecorder::Stats RawRecorder::getStats() {
+    std::lock_guard lock(m_queueMutex);
+
+    return Stats{
+        .framesWritten   = m_framesWritten,
+        .framesDropped   = m_framesDropped,
+        .bytesWritten    = m_writer.getBytesWritten(),
+        .writeErrors     = m_writer.getWriteErrors(),
+        .queuedFrames    = m_queue.size(),
+        .maxQueuedFrames = m_highWaterMark,
+        .inFlightWrites  = m_writer.getInFlight(),
+        .direct          = m_writer.isDirect(),
+        .uring           = m_writer.isUsingUring()
+    };
+}
+
+void RawRecorder::writerThread() {
+    std::unique_lock lock(m_queueMutex);
+
+    while(true) {
+        m_queueCondition.wait(lock, [this]() { return !m_recording || !m_queue.empty(); });
+        if(m_queue.empty()) {
+            return;
+        }
+
+        FramePtr frame = std::move(m_queue.front());
+        m_queue.pop_front();
+        m_framesWritten++;
+
+        lock.unlock();
+
+        const size_t size = alignSize(frame->size);
+        m_index.push_back(RawRecordingIndexEntry{
+            .offset      = m_offset,
+            .timestampNS = frame->timestampNS,
+            .size        = (Uint32)frame->size,
+            .format      = (Uint32)frame->format,
+            .width       = (Uint32)frame->width,
+            .height      = (Uint32)frame->height,
+            .pitch       = (Uint32)frame->pitch,
+            .reserved    = 0
+        });
+
+        // pool frames are padded to the alignment, so the payload goes out as is and returns to its pool once written
+        m_writer.write(frame->pixels, size, m_offset, frame);
+        m_offset += size;
+
+        frame.reset();
+        lock.lock();
+    }
+}
+
+void RawRecorder::writeIndex() {
+    const size_t indexSize = alignSize(m_index.size() * sizeof(RawRecordingIndexEntry));
+    if(indexSize > 0) {
+        Uint8* index = (Uint8*)SDL_aligned_alloc(DirectWriter::alignment, indexSize);
+        memset(index, 0, indexSize);
+        memcpy(index, m_index.data(), m_index.size() * sizeof(RawRecordingIndexEntry));
+
+        m_writer.write(index, indexSize, m_offset, std::shared_ptr<void>(index, SDL_aligned_free));
+    }
+
+    Uint8* header = (Uint8*)SDL_aligned_alloc(DirectWriter::alignment, DirectWriter::alignment);
+    memset(header, 0, DirectWriter::alignment);
+
+    RawRecordingHeader info = {
+        .magic       = { 'C', 'C', 'R', 'V' },
+        .version     = version,
+        .indexOffset = m_offset,
+        .frameCount  = m_index.size()
+    };
+
+    memcpy(header, &info, sizeof(info));
+    m_writer.write(header, DirectWriter::alignment, 0, std::shared_ptr<void>(header, SDL_aligned_free));
+
+    m_writer.flush();
+}
@@ -0,0 +1,215 @@
+#include <SDL3_image/SDL_image.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <screenshot_writer.hpp>
+#include <vector>
+
+static const char* getExtension(ScreenshotWriter::Format format) {
+    switch(format) {
+    case ScreenshotWriter::Format::QOI: return ".qoi";
+    case ScreenshotWriter::Format::BMP: return ".bmp";
+    default:                            return ".png";
+    }
+}
+
+static bool writeFile(const std::string& path, const void* data, size_t size) {
+    FILE* file = fopen(path.c_str(), "wb");
+    if(file == nullptr) {
+        SDL_Log("Couldn't open %s for writing: %s", path.c_str(), strerror(errno));
+        return false;
+    }
+
+    const bool written = fwrite(data, 1, size, file) == size;
+    fclose(file);
+
+    return written;
+}
+
+// https://qoiformat.org/qoi-specification.pdf, 3 channels straight from an RGB24 surface
+static bool saveQOI(SDL_Surface* surface, const std::string& path) {
+    struct Pixel {
+        Uint8 r, g, b, a;
+    };
+
+    std::vector<Uint8> out;
+    out.reserve(14 + (size_t)surface->w * surface->h * 4 + 8);
+
+    const Uint8 header[] = {
+        'q', 'o', 'i', 'f',
+        (Uint8)(surface->w >> 24), (Uint8)(surface->w >> 16), (Uint8)(surface->w >> 8), (Uint8)surface->w,
+        (Uint8)(surface->h >> 24), (Uint8)(surface->h >> 16), (Uint8)(surface->h >> 8), (Uint8)surface->h,
+        3, 0
+    };
+
+    out.insert(out.end(), header, header + sizeof(header));
+
+    Pixel index[64] = {};
+    Pixel previous  = { 0, 0, 0, 255 };
+    int run         = 0;
+
+    for(int y = 0; y < surface->h; y++) {
+        const Uint8* row = (const Uint8*)surface->pixels + (size_t)y * surface->pitch;
+
+        for(int x = 0; x < surface->w; x++) {
+            const Pixel pixel = { row[x * 3], row[x * 3 + 1], row[x * 3 + 2], 255 };
+
+            if(memcmp(&pixel, &previous, sizeof(pixel)) == 0) {
+                if(++run == 62) {
+                    out.push_back(0xC0 | (run - 1));
+                    run = 0;
+                }
+
+                continue;
+            }
+
+            if(run > 0) {
+                out.push_back(0xC0 | (run - 1));
+                run = 0;
+            }
+
+            const int hash = (pixel.r * 3 + pixel.g * 5 + pixel.b * 7 + pixel.a * 11) % 64;
+            if(memcmp(&index[hash], &pixel, sizeof(pixel)) == 0) {
+                out.push_back(hash);
+                previous = pixel;
+
+                continue;
+            }
+
+            index[hash] = pixel;
+
+            const Sint8 dr  = pixel.r - previous.r;
+            const Sint8 dg  = pixel.g - previous.g;
+            const Sint8 db  = pixel.b - previous.b;
+            const Sint8 drg = dr - dg;
+            const Sint8 dbg = db - dg;
+
+            if(dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+                out.push_back(0x40 | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2));
+            }
+            else if(dg >= -32 && dg <= 31 && drg >= -8 && drg <= 7 && dbg >= -8 && dbg <= 7) {
+                out.push_back(0x80 | (dg + 32));
+                out.push_back((drg + 8) << 4 | (dbg + 8));
+            }
+            else {
+                out.push_back(0xFE);
+                out.push_back(pixel.r);
+                out.push_back(pixel.g);
+                out.push_back(pixel.b);
+            }
+
+            previous = pixel;
+        }
+    }
+
+    if(run > 0) {
+        out.push_back(0xC0 | (run - 1));
+    }
+
+    const Uint8 end[] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+    out.insert(out.end(), end, end + sizeof(end));
+
+    return writeFile(path, out.data(), out.size());
+}
+
+ScreenshotWriter::ScreenshotWriter(size_t threadCount, size_t maxQueuedFrames)
+    : m_format(Format::PNG)
+    , m_bursting(false)
+    , m_saved(0)
+    , m_dropped(0)
+    , m_failed(0)
+    , m_encodeNS(0)
+    , m_pool(threadCount, maxQueuedFrames) {}
+
+void ScreenshotWriter::setFormat(Format format) { m_format = format; }
+
+bool ScreenshotWriter::capture(const FramePtr& frame, const std::string& path, const Done& done) {
+    const Format format = m_format;
+
+    // the job keeps its own reference, the frame goes back to the camera's pool once it's written
+    const bool queued = m_pool.trySubmit([this, frame, path, format, done]() {
+        const bool saved = encode(frame, path, format);
+        if(done) {
+            done(saved);
+        }
+    });
+
+    if(!queued) {
+        m_dropped++;
+        return false;
+    }
+
+    return true;
+}
+
+void ScreenshotWriter::startBurst(const std::string& basePath) {
+    std::lock_guard lock(m_burstMutex);
+    m_burstPath = basePath;
+    m_bursting  = true;
+}
+
+void ScreenshotWriter::stopBurst() { m_bursting = false; }
+bool ScreenshotWriter::isBursting() const { return m_bursting; }
+
+void ScreenshotWriter::onFrame(const FramePtr& frame) {
+    if(!m_bursting) {
+        return;
+    }
+
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), "-%06llu", (unsigned long long)frame->sequence);
+
+    std::lock_guard lock(m_burstMutex);
+    capture(frame, m_burstPath + suffix);
+}
+
+ScreenshotWriter::Stats ScreenshotWriter::getStats() {
+    const Uint64 saved = m_saved;
+
+    return Stats{
+        .saved           = saved,
+        .dropped         = m_dropped,
+        .failed          = m_failed,
+        .queued          = m_pool.getQueuedJobs(),
+        .averageEncodeMS = saved > 0 ? (double)m_encodeNS / saved / SDL_NS_PER_MS : 0.0
+    };
+}
+
+bool ScreenshotWriter::encode(const FramePtr& frame, const std::string& path, Format format) {
+    const Uint64 startNS = SDL_GetTicksNS();
+
+    bool saved = false;
+    if(frame->format == SDL_PIXELFORMAT_MJPG) {
+        saved = writeFile(path + ".jpg", frame->pixels, frame->size);
+    }
+    else {
+        SDL_Surface* surface = SDL_CreateSurface(frame->width, frame->height, SDL_PIXELFORMAT_RGB24);
+
+        if(surface != nullptr && SDL_ConvertPixels(frame->width, frame->height, frame->format, frame->pixels, frame->pitch, SDL_PIXELFORMAT_RGB24, surface->pixels, surface->pitch)) {
+            const std::string file = path + getExtension(format);
+
+            switch(format) {
+            case Format::QOI: saved = saveQOI(surface, file); break;
+            case Format::BMP: saved = SDL_SaveBMP(surface, file.c_str()); break;
+            default:          saved = IMG_SavePNG(surface, file.c_str()); break;
+            }
+        }
+
+        if(!saved) {
+            SDL_Log("Couldn't save screenshot %s: %s", path.c_str(), SDL_GetError());
+        }
+
+        SDL_DestroySurface(surface);
+    }
+
+    if(!saved) {
+        m_failed++;
+        return false;
+    }
+
+    m_saved++;
+    m_encodeNS += SDL_GetTicksNS() - startNS;
+
+    return true;
+}
@@ -0,0 +1,160 @@
+#include <cstring>
+#include <frame_codec.hpp>
+
+// runs of unchanged bytes shorter than this are cheaper to keep as literals than to split the literal run
+static constexpr size_t minZeroRun = 16;
+
+// varint run header, (length << 1) | isZeroRun
+static constexpr size_t maxHeaderSize = 10;
+
+static Uint64 load64(const Uint8* data) {
+    Uint64 value;
+    memcpy(&value, data, sizeof(value));
+
+    return value;
+}
+
+static Uint8* putHeader(Uint8* out, size_t length, bool zeroRun) {
+    Uint64 value = ((Uint64)length << 1) | (zeroRun ? 1 : 0);
+    while(value >= 0x80) {
+        *out++  = (Uint8)(value | 0x80);
+        value >>= 7;
+    }
+
+    *out++ = (Uint8)value;
+    return out;
+}
+
+static const Uint8* getHeader(const Uint8* data, const Uint8* end, Uint64* value) {
+    *value = 0;
+    for(int shift = 0; data < end && shift < 64; shift += 7) {
+        const Uint8 byte  = *data++;
+        *value           |= (Uint64)(byte & 0x7F) << shift;
+
+        if((byte & 0x80) == 0) {
+            return data;
+        }
+    }
+
+    return nullptr;
+}
+
+// the plain loops below are written so the compiler vectorizes them
+static Uint8* putLiterals(Uint8* out, const Uint8* pixels, size_t start, size_t end, size_t pitch) {
+    out = putHeader(out, end - start, false);
+
+    size_t i = start;
+    for(; i < end && i < pitch; i++) {
+        *out++ = pixels[i];
+    }
+
+    const Uint8* above = pixels + i - pitch;
+    const Uint8* row   = pixels + i;
+    const size_t count = end - i;
+    for(size_t j = 0; j < count; j++) {
+        out[j] = (Uint8)(row[j] - above[j]);
+    }
+
+    return out + count;
+}
+
+size_t getMaxEncodedSize(size_t size) { return size + size / minZeroRun * maxHeaderSize + 2 * maxHeaderSize; }
+
+size_t encodeFrame(const Uint8* pixels, size_t size, size_t pitch, Uint8* out) {
+    if(pitch == 0) {
+        return 0;
+    }
+
+    Uint8* const begin = out;
+
+    size_t literalStart = 0;
+    size_t i            = pitch;
+
+    // compare 8 bytes at a time against the row above, only whole words are ever part of a zero run
+    while(i + sizeof(Uint64) <= size) {
+        if(load64(pixels + i) != load64(pixels + i - pitch)) {
+            i += sizeof(Uint64);
+            continue;
+        }
+
+        size_t end = i + sizeof(Uint64);
+        while(end + sizeof(Uint64) <= size && load64(pixels + end) == load64(pixels + end - pitch)) {
+            end += sizeof(Uint64);
+        }
+
+        if(end - i >= minZeroRun) {
+            if(i > literalStart) {
+                out = putLiterals(out, pixels, literalStart, i, pitch);
+            }
+
+            out          = putHeader(out, end - i, true);
+            literalStart = end;
+        }
+
+        i = end;
+    }
+
+    if(size > literalStart) {
+        out = putLiterals(out, pixels, literalStart, size, pitch);
+    }
+
+    const size_t encodedSize = out - begin;
+    return encodedSize < size ? encodedSize : 0;
+}
+
+bool decodeFrame(const Uint8* data, size_t dataSize, size_t pitch, Uint8* out, size_t size) {
+    const Uint8* end = data + dataSize;
+    size_t position  = 0;
+
+    while(data < end) {
+        Uint64 header;
+        if((data = getHeader(data, end, &header)) == nullptr) {
+            return false;
+        }
+
+        const size_t length = header >> 1;
+        if(length > size - position) {
+            return false;
+        }
+
+        if(header & 1) {
+            if(pitch == 0 || position < pitch) {
+                return false;
+            }
+
+            // may overlap itself when the run is longer than a row, so copy forwards one row at a time
+            size_t remaining = length;
+            while(remaining > 0) {
+                const size_t chunk = SDL_min(remaining, pitch);
+                memcpy(out + position, out + position - pitch, chunk);
+
+                position  += chunk;
+                remaining -= chunk;
+            }
+
+            continue;
+        }
+
+        if(length > (size_t)(end - data)) {
+            return false;
+        }
+
+        size_t i = 0;
+        for(; i < length && position + i < pitch; i++) {
+            out[position + i] = data[i];
+        }
+
+        Uint8* row         = out + position + i;
+        const Uint8* above = row - pitch;
+        const Uint8* input = data + i;
+        const size_t count = length - i;
+        for(size_t j = 0; j < count; j++) {
+            row[j] = (Uint8)(input[j] + above[j]);
+        }
+
+        data     += length;
+        position += length;
+    }
+
+    return position == size;
+}
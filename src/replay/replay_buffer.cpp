@@ -0,0 +1,591 @@
+#include <algorithm>
+#include <cstring>
+#include <frame_codec.hpp>
+#include <matroska_writer.hpp>
+#include <replay_buffer.hpp>
+
+static size_t audioBytes(Uint64 durationNS, size_t bytesPerSecond) {
+    // whole sample frames only, 2 channels of 16 bits
+    return (size_t)(durationNS * bytesPerSecond / SDL_NS_PER_SECOND) & ~(size_t)3;
+}
+
+static Uint64 audioDuration(size_t size, size_t bytesPerSecond) { return (Uint64)size * SDL_NS_PER_SECOND / bytesPerSecond; }
+
+static bool getVideoTrack(const Frame& frame, MatroskaWriter::VideoTrack* track) {
+    track->width  = frame.width;
+    track->height = frame.height;
+    track->fourcc = 0;
+
+    if(frame.format == SDL_PIXELFORMAT_MJPG) {
+        track->codecID = "V_MJPEG";
+        return true;
+    }
+
+    track->codecID = "V_UNCOMPRESSED";
+
+    // yuv formats are fourccs already, in the same byte order matroska stores them
+    if(SDL_ISPIXELFORMAT_FOURCC(frame.format)) {
+        track->fourcc = frame.format;
+        return true;
+    }
+
+    if(frame.format == SDL_PIXELFORMAT_ARGB8888 || frame.format == SDL_PIXELFORMAT_XRGB8888) {
+        track->fourcc = SDL_FOURCC('B', 'G', 'R', 'A');
+        return true;
+    }
+
+    return false;
+}
+
+// uncompressed matroska frames have no row padding, returns the frame itself when there is none to strip
+static const Uint8* packFrame(const Frame& frame, std::vector<Uint8>& packed, size_t* size) {
+    struct Plane {
+        int rowBytes;
+        int rows;
+        int pitch;
+    };
+
+    // compressed frames have no rows, their pitch is the payload size
+    if(frame.format == SDL_PIXELFORMAT_MJPG) {
+        *size = frame.size;
+        return frame.pixels;
+    }
+
+    const int chromaWidth  = (frame.width + 1) / 2;
+    const int chromaHeight = (frame.height + 1) / 2;
+
+    Plane planes[3];
+    int planeCount = 1;
+
+    switch(frame.format) {
+    case SDL_PIXELFORMAT_NV12:
+    case SDL_PIXELFORMAT_NV21:
+        planes[0]  = { frame.width, frame.height, frame.pitch };
+        planes[1]  = { chromaWidth * 2, chromaHeight, frame.pitch };
+        planeCount = 2;
+        break;
+    case SDL_PIXELFORMAT_P010:
+        planes[0]  = { frame.width * 2, frame.height, frame.pitch };
+        planes[1]  = { chromaWidth * 4, chromaHeight, frame.pitch };
+        planeCount = 2;
+        break;
+    case SDL_PIXELFORMAT_YV12:
+    case SDL_PIXELFORMAT_IYUV:
+        planes[0]  = { frame.width, frame.height, frame.pitch };
+        planes[1]  = { chromaWidth, chromaHeight, (frame.pitch + 1) / 2 };
+        planes[2]  = planes[1];
+        planeCount = 3;
+        break;
+    default:
+        planes[0] = { frame.width * SDL_BYTESPERPIXEL(frame.format), frame.height, frame.pitch };
+        break;
+    }
+
+    size_t packedSize = 0;
+    bool padded       = false;
+    for(int i = 0; i < planeCount; i++) {
+        packedSize += (size_t)planes[i].rowBytes * planes[i].rows;
+        padded     |= planes[i].rowBytes != planes[i].pitch;
+    }
+
+    if(!padded) {
+        *size = frame.size;
+        return frame.pixels;
+    }
+
+    packed.resize(packedSize);
+
+    const Uint8* source = frame.pixels;
+    Uint8* destination  = packed.data();
+    for(int i = 0; i < planeCount; i++) {
+        for(int row = 0; row < planes[i].rows; row++) {
+            memcpy(destination, source, planes[i].rowBytes);
+
+            source      += planes[i].pitch;
+            destination += planes[i].rowBytes;
+        }
+    }
+
+    *size = packedSize;
+    return packed.data();
+}
+
+ReplayBuffer::ReplayBuffer(size_t capacity, Uint64 maxDurationNS, bool compress, size_t maxQueuedFrames)
+    : m_capacity(capacity)
+    , m_maxDurationNS(maxDurationNS)
+    , m_compress(compress)
+    , m_decodePool(FramePool::create(4))
+    , m_maxQueuedFrames(maxQueuedFrames)
+    , m_saving(false) {
+    // pages are only committed once the ring first reaches them
+    m_arena = (Uint8*)SDL_aligned_alloc(FramePool::frameAlignment, capacity);
+    if(m_arena == nullptr) {
+        SDL_Log("Couldn't allocate %zu bytes for the replay buffer", capacity);
+        return;
+    }
+
+    m_pendingAudio.resize(bytesPerSecond);
+    m_audioScratch.resize(bytesPerSecond);
+
+    m_running = true;
+    m_thread  = std::thread(&ReplayBuffer::ingestThread, this);
+}
+
+ReplayBuffer::~ReplayBuffer() {
+    if(m_saveThread.joinable()) {
+        m_saveThread.join();
+    }
+
+    m_queueMutex.lock();
+    m_running = false;
+    m_queueMutex.unlock();
+
+    m_queueCondition.notify_all();
+    if(m_thread.joinable()) {
+        m_thread.join();
+    }
+
+    SDL_aligned_free(m_arena);
+}
+
+bool ReplayBuffer::isValid() const { return m_arena != nullptr; }
+
+void ReplayBuffer::onFrame(const FramePtr& frame) {
+    std::unique_lock lock(m_queueMutex);
+    if(!m_running) {
+        return;
+    }
+
+    if(m_queue.size() >= m_maxQueuedFrames) {
+        m_framesDropped++;
+        return;
+    }
+
+    m_queue.push_back(frame);
+
+    lock.unlock();
+    m_queueCondition.notify_one();
+}
+
+void ReplayBuffer::onAudio(const Uint8* data, size_t size, Uint64 timestampNS) {
+    std::lock_guard lock(m_audioMutex);
+    if(m_pendingAudioSize == 0) {
+        m_pendingAudioStart = timestampNS;
+    }
+
+    // only overflows if the ingest thread stalls for a whole second, the rest is lost
+    const size_t count = std::min(size, m_pendingAudio.size() - m_pendingAudioSize);
+    memcpy(m_pendingAudio.data() + m_pendingAudioSize, data, count);
+
+    m_pendingAudioSize += count;
+}
+
+Uint64 ReplayBuffer::getOldestTimestamp() {
+    std::lock_guard lock(m_mutex);
+    return m_frames.empty() ? 0 : m_frames.front().timestampNS;
+}
+
+Uint64 ReplayBuffer::getNewestTimestamp() {
+    std::lock_guard lock(m_mutex);
+    return m_frames.empty() ? 0 : m_frames.back().timestampNS;
+}
+
+FramePtr ReplayBuffer::getFrame(Uint64 timestampNS, const FramePtr& current) {
+    // decoded without the lock below, the time-shift audio callback reads audio under it
+    FrameEntry entry;
+    {
+        std::lock_guard lock(m_mutex);
+        if(m_frames.empty()) {
+            return nullptr;
+        }
+
+        auto it = std::upper_bound(m_frames.begin(), m_frames.end(), timestampNS, [](Uint64 timestampNS, const FrameEntry& entry) {
+            return timestampNS < entry.timestampNS;
+        });
+
+        if(it != m_frames.begin()) {
+            it--;
+        }
+
+        if(current != nullptr && current->sequence == it->sequence) {
+            return current;
+        }
+
+        entry = *it;
+    }
+
+    return decode(entry);
+}
+
+void ReplayBuffer::readAudio(Uint64 timestampNS, Uint8* out, size_t size) {
+    memset(out, 0, size);
+
+    std::lock_guard lock(m_mutex);
+
+    const Uint64 endNS = timestampNS + audioDuration(size, bytesPerSecond);
+
+    // first entry that could still reach timestampNS
+    auto it = std::upper_bound(m_audio.begin(), m_audio.end(), timestampNS, [](Uint64 timestampNS, const AudioEntry& entry) {
+        return timestampNS < entry.timestampNS;
+    });
+
+    if(it != m_audio.begin()) {
+        it--;
+    }
+
+    for(; it != m_audio.end() && it->timestampNS < endNS; it++) {
+        size_t source      = 0;
+        size_t destination = 0;
+
+        if(it->timestampNS < timestampNS) {
+            source = audioBytes(timestampNS - it->timestampNS, bytesPerSecond);
+        }
+        else {
+            destination = audioBytes(it->timestampNS - timestampNS, bytesPerSecond);
+        }
+
+        if(source >= it->size || destination >= size) {
+            continue;
+        }
+
+        const size_t count = std::min(it->size - source, size - destination);
+        memcpy(out + destination, m_arena + it->offset + source, count);
+    }
+}
+
+bool ReplayBuffer::save(const std::string& path, Uint64 durationNS) {
+    if(m_saving) {
+        return false;
+    }
+
+    if(m_saveThread.joinable()) {
+        m_saveThread.join();
+    }
+
+    std::vector<FrameEntry> frames;
+    std::vector<AudioEntry> audio;
+
+    m_mutex.lock();
+    if(!m_frames.empty()) {
+        const Uint64 startNS = m_frames.back().timestampNS - std::min(m_frames.back().timestampNS, durationNS);
+
+        for(const FrameEntry& entry : m_frames) {
+            if(entry.timestampNS >= startNS) {
+                frames.push_back(entry);
+            }
+        }
+
+        for(const AudioEntry& entry : m_audio) {
+            if(entry.timestampNS >= startNS) {
+                audio.push_back(entry);
+            }
+        }
+    }
+
+    m_mutex.unlock();
+
+    if(frames.empty()) {
+        return false;
+    }
+
+    m_saving     = true;
+    m_saveThread = std::thread(&ReplayBuffer::saveThread, this, path, std::move(frames), std::move(audio));
+
+    return true;
+}
+
+bool ReplayBuffer::isSaving() const { return m_saving; }
+
+ReplayBuffer::Stats ReplayBuffer::getStats() {
+    Stats stats;
+
+    m_queueMutex.lock();
+    stats.framesStored  = m_framesStored;
+    stats.framesDropped = m_framesDropped;
+    m_queueMutex.unlock();
+
+    std::lock_guard lock(m_mutex);
+    stats.storedFrames = m_frames.size();
+    stats.durationNS   = m_frames.empty() ? 0 : m_frames.back().timestampNS - m_frames.front().timestampNS;
+    stats.usedBytes    = m_usedBytes;
+    stats.rawBytes     = m_rawBytes;
+    stats.capacity     = m_capacity;
+
+    return stats;
+}
+
+void ReplayBuffer::ingestThread() {
+    std::deque<FramePtr> frames;
+    std::unique_lock lock(m_queueMutex);
+
+    while(true) {
+        // audio is picked up at least this often even if no frames arrive
+        m_queueCondition.wait_for(lock, std::chrono::milliseconds(20), [this]() { return !m_running || !m_queue.empty(); });
+        if(!m_running) {
+            return;
+        }
+
+        frames.swap(m_queue);
+        lock.unlock();
+
+        m_audioMutex.lock();
+        const size_t audioSize  = m_pendingAudioSize;
+        const Uint64 audioStart = m_pendingAudioStart;
+
+        memcpy(m_audioScratch.data(), m_pendingAudio.data(), audioSize);
+        m_pendingAudioSize = 0;
+        m_audioMutex.unlock();
+
+        if(audioSize > 0) {
+            storeAudio(m_audioScratch.data(), audioSize, audioStart);
+        }
+
+        const size_t count = frames.size();
+        for(const FramePtr& frame : frames) {
+            storeFrame(frame);
+        }
+
+        frames.clear();
+
+        lock.lock();
+        m_framesStored += count;
+    }
+}
+
+void ReplayBuffer::storeFrame(const FramePtr& frame) {
+    const Uint8* data = frame->pixels;
+    size_t storedSize = frame->size;
+    bool compressed   = false;
+
+    // mjpg doesnt get any smaller
+    if(m_compress && frame->format != SDL_PIXELFORMAT_MJPG) {
+        if(m_scratch.size() < getMaxEncodedSize(frame->size)) {
+            m_scratch.resize(getMaxEncodedSize(frame->size));
+        }
+
+        const size_t encodedSize = encodeFrame(frame->pixels, frame->size, frame->pitch, m_scratch.data());
+        if(encodedSize > 0) {
+            data       = m_scratch.data();
+            storedSize = encodedSize;
+            compressed = true;
+        }
+    }
+
+    if(storedSize > m_capacity) {
+        return;
+    }
+
+    m_mutex.lock();
+    const size_t offset = reserve(storedSize);
+    m_mutex.unlock();
+
+    // nothing references the reserved range yet, so the copy doesnt need the lock
+    memcpy(m_arena + offset, data, storedSize);
+
+    std::lock_guard lock(m_mutex);
+    m_frames.push_back(FrameEntry{
+        .offset      = offset,
+        .storedSize  = storedSize,
+        .sequence    = m_frameSequence++,
+        .timestampNS = frame->timestampNS,
+        .format      = frame->format,
+        .width       = frame->width,
+        .height      = frame->height,
+        .pitch       = frame->pitch,
+        .size        = frame->size,
+        .compressed  = compressed
+    });
+
+    m_usedBytes += storedSize;
+    m_rawBytes  += frame->size;
+
+    trim();
+}
+
+void ReplayBuffer::storeAudio(const Uint8* data, size_t size, Uint64 timestampNS) {
+    m_mutex.lock();
+    const size_t offset = reserve(size);
+    m_mutex.unlock();
+
+    memcpy(m_arena + offset, data, size);
+
+    std::lock_guard lock(m_mutex);
+    m_audio.push_back(AudioEntry{
+        .offset      = offset,
+        .size        = size,
+        .sequence    = m_audioSequence++,
+        .timestampNS = timestampNS
+    });
+
+    m_usedBytes += size;
+    m_rawBytes  += size;
+
+    trim();
+}
+
+size_t ReplayBuffer::reserve(size_t size) {
+    auto popFrame = [this]() {
+        m_usedBytes -= m_frames.front().storedSize;
+        m_rawBytes  -= m_frames.front().size;
+        m_frames.pop_front();
+    };
+
+    auto popAudio = [this]() {
+        m_usedBytes -= m_audio.front().size;
+        m_rawBytes  -= m_audio.front().size;
+        m_audio.pop_front();
+    };
+
+    size_t offset = m_writeOffset;
+    if(offset + size > m_capacity) {
+        // the tail is too short, whatever is still stored there is the oldest data so it goes before wrapping around
+        while(!m_frames.empty() && m_frames.front().offset >= offset) {
+            popFrame();
+        }
+
+        while(!m_audio.empty() && m_audio.front().offset >= offset) {
+            popAudio();
+        }
+
+        offset = 0;
+    }
+
+    // entries are laid out in the order they were written, so the oldest of each kind is the only one that can overlap
+    while(!m_frames.empty() && m_frames.front().offset < offset + size && offset < m_frames.front().offset + m_frames.front().storedSize) {
+        popFrame();
+    }
+
+    while(!m_audio.empty() && m_audio.front().offset < offset + size && offset < m_audio.front().offset + m_audio.front().size) {
+        popAudio();
+    }
+
+    m_writeOffset = offset + size;
+    return offset;
+}
+
+void ReplayBuffer::trim() {
+    while(m_frames.size() > 1 && m_frames.back().timestampNS - m_frames.front().timestampNS > m_maxDurationNS) {
+        m_usedBytes -= m_frames.front().storedSize;
+        m_rawBytes  -= m_frames.front().size;
+        m_frames.pop_front();
+    }
+
+    while(m_audio.size() > 1 && m_audio.back().timestampNS - m_audio.front().timestampNS > m_maxDurationNS) {
+        m_usedBytes -= m_audio.front().size;
+        m_rawBytes  -= m_audio.front().size;
+        m_audio.pop_front();
+    }
+}
+
+bool ReplayBuffer::isStored(const FrameEntry& entry) {
+    std::lock_guard lock(m_mutex);
+    return !m_frames.empty() && entry.sequence >= m_frames.front().sequence;
+}
+
+FramePtr ReplayBuffer::decode(const FrameEntry& entry) {
+    if(!isStored(entry)) {
+        return nullptr;
+    }
+
+    FramePtr frame = m_decodePool->acquire(entry.size);
+
+    frame->format      = entry.format;
+    frame->width       = entry.width;
+    frame->height      = entry.height;
+    frame->pitch       = entry.pitch;
+    frame->timestampNS = entry.timestampNS;
+    frame->sequence    = entry.sequence;
+
+    bool decoded = true;
+    if(!entry.compressed) {
+        memcpy(frame->pixels, m_arena + entry.offset, entry.size);
+    }
+    else {
+        decoded = decodeFrame(m_arena + entry.offset, entry.storedSize, entry.pitch, frame->pixels, entry.size);
+    }
+
+    // the ingest thread evicts an entry under the lock before writing over its range, so if it's still stored now
+    // nothing touched it while it was being read
+    if(!isStored(entry)) {
+        return nullptr;
+    }
+
+    if(!decoded) {
+        SDL_Log("Couldn't decode replay frame %llu", (unsigned long long)entry.sequence);
+        return nullptr;
+    }
+
+    return frame;
+}
+
+void ReplayBuffer::saveThread(std::string path, std::vector<FrameEntry> frames, std::vector<AudioEntry> audio) {
+    const Uint64 startNS = audio.empty() ? frames.front().timestampNS : std::min(frames.front().timestampNS, audio.front().timestampNS);
+
+    MatroskaWriter writer;
+    MatroskaWriter::VideoTrack video;
+    const MatroskaWriter::AudioTrack audioTrack = { .sampleRate = 48000, .channels = 2, .bitDepth = 16 };
+
+    std::vector<Uint8> packed;
+    std::vector<Uint8> samples;
+
+    size_t frameIndex = 0;
+    size_t audioIndex = 0;
+    size_t written    = 0;
+
+    while(frameIndex < frames.size() || audioIndex < audio.size()) {
+        const bool nextIsFrame = audioIndex >= audio.size() || (frameIndex < frames.size() && frames[frameIndex].timestampNS <= audio[audioIndex].timestampNS);
+
+        // entries may have been evicted since the snapshot, anything older than the oldest stored one is gone
+        if(nextIsFrame) {
+            const FrameEntry& entry = frames[frameIndex++];
+
+            FramePtr frame = decode(entry);
+            if(frame == nullptr) {
+                continue;
+            }
+
+            if(!writer.isOpen()) {
+                if(!getVideoTrack(*frame, &video)) {
+                    SDL_Log("Can't save replays in %s", SDL_GetPixelFormatName(frame->format));
+                    break;
+                }
+
+                if(!writer.open(path, video, &audioTrack)) {
+                    break;
+                }
+            }
+
+            // the primary camera can change while buffering, the track only fits the first format
+            if(frame->width != video.width || frame->height != video.height || (frame->format == SDL_PIXELFORMAT_MJPG) != (video.codecID == "V_MJPEG")) {
+                continue;
+            }
+
+            size_t size;
+            const Uint8* data = packFrame(*frame, packed, &size);
+
+            writer.writeVideo(data, size, frame->timestampNS - startNS);
+            written++;
+
+            continue;
+        }
+
+        const AudioEntry& entry = audio[audioIndex++];
+
+        m_mutex.lock();
+        const bool alive = !m_audio.empty() && entry.sequence >= m_audio.front().sequence;
+        if(alive) {
+            samples.assign(m_arena + entry.offset, m_arena + entry.offset + entry.size);
+        }
+
+        m_mutex.unlock();
+
+        if(alive && writer.isOpen()) {
+            writer.writeAudio(samples.data(), samples.size(), entry.timestampNS - startNS);
+        }
+    }
+
+    writer.close();
+    SDL_Log("Saved replay %s: %zu of %zu frames", path.c_str(), written, frames.size());
+
+    m_saving = false;
+}
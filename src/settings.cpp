@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <filesystem>
@@ -75,7 +76,6 @@ SDL_CameraID Settings::getSelectedCamera() {
         camera = cameras[i];
 
         const char* name = SDL_GetCameraName(camera);
-        printf("name: %s\n", name);
 
         if(name != nullptr && strcmp(name, selectedName.value().c_str()) == 0) {
             SDL_free(cameras);
@@ -104,6 +104,56 @@ void Settings::setSelectedCamera(SDL_CameraID camera) {
     setValue("camera", name);
 }
 
+// one key per camera, the name cant contain the separator between key and value
+static std::string getCropKey(SDL_CameraID camera) {
+    const char* name = SDL_GetCameraName(camera);
+    if(name == nullptr) {
+        return "";
+    }
+
+    std::string key = std::string("crop.") + name;
+    std::replace(key.begin(), key.end(), ':', '_');
+
+    return key;
+}
+
+std::optional<SDL_FRect> Settings::getCameraCrop(SDL_CameraID camera) {
+    const std::string key = getCropKey(camera);
+    if(key.empty()) {
+        return std::nullopt;
+    }
+
+    std::optional<std::string> value = getValue(key);
+    if(!value.has_value()) {
+        return std::nullopt;
+    }
+
+    SDL_FRect crop;
+    if(sscanf(value.value().c_str(), "%f,%f,%f,%f", &crop.x, &crop.y, &crop.w, &crop.h) != 4 || crop.w <= 0.0f || crop.h <= 0.0f) {
+        SDL_Log("Ignoring invalid crop for %s: %s", SDL_GetCameraName(camera), value.value().c_str());
+        return std::nullopt;
+    }
+
+    return crop;
+}
+
+void Settings::setCameraCrop(SDL_CameraID camera, const std::optional<SDL_FRect>& crop) {
+    const std::string key = getCropKey(camera);
+    if(key.empty()) {
+        return;
+    }
+
+    if(!crop.has_value()) {
+        clearValue(key);
+        return;
+    }
+
+    char value[128];
+    snprintf(value, sizeof(value), "%.4f,%.4f,%.4f,%.4f", crop->x, crop->y, crop->w, crop->h);
+
+    setValue(key, value);
+}
+
 SDL_AudioDeviceID Settings::getSelectedRecordingDevice() {
     int recordingDeviceCount   = 0;
     SDL_AudioDeviceID* devices = SDL_GetAudioRecordingDevices(&recordingDeviceCount);
@@ -157,7 +207,168 @@ void Settings::setVolume(int volume) { setValue("volume", std::to_string(clampVo
 bool Settings::isFullscreen() { return getValue("fullscreen").value_or("false") == "true"; }
 void Settings::setFullscreen(bool fullscreen) { setValue("fullscreen", fullscreen ? "true" : "false"); }
 
+CameraLayout Settings::getCameraLayout() {
+    std::string layout = getValue("layout").value_or("single");
+    if(layout == "grid") {
+        return CameraLayout::GRID;
+    }
+    else if(layout == "pip") {
+        return CameraLayout::PICTURE_IN_PICTURE;
+    }
+
+    return CameraLayout::SINGLE;
+}
+
+void Settings::setCameraLayout(CameraLayout layout) {
+    switch(layout) {
+    case CameraLayout::GRID:               setValue("layout", "grid"); break;
+    case CameraLayout::PICTURE_IN_PICTURE: setValue("layout", "pip"); break;
+    default:                               setValue("layout", "single"); break;
+    }
+}
+
+DeinterlaceMode Settings::getDeinterlaceMode() {
+    std::string mode = getValue("deinterlace").value_or("off");
+    if(mode == "weave") {
+        return DeinterlaceMode::WEAVE;
+    }
+    else if(mode == "bob") {
+        return DeinterlaceMode::BOB;
+    }
+    else if(mode == "adaptive") {
+        return DeinterlaceMode::ADAPTIVE;
+    }
+
+    return DeinterlaceMode::OFF;
+}
+
+void Settings::setDeinterlaceMode(DeinterlaceMode mode) {
+    switch(mode) {
+    case DeinterlaceMode::WEAVE:    setValue("deinterlace", "weave"); break;
+    case DeinterlaceMode::BOB:      setValue("deinterlace", "bob"); break;
+    case DeinterlaceMode::ADAPTIVE: setValue("deinterlace", "adaptive"); break;
+    default:                        setValue("deinterlace", "off"); break;
+    }
+}
+
+bool Settings::isTopFieldFirst() { return getValue("fieldOrder").value_or("tff") != "bff"; }
+bool Settings::isFitCameraToWindow() { return getValue("fitCameraToWindow").value_or("false") == "true"; }
+
+HiddenCameraMode Settings::getHiddenCameraMode() {
+    std::string mode = getValue("hiddenCameras").value_or("keep");
+    if(mode == "lowest") {
+        return HiddenCameraMode::LOWEST;
+    }
+    else if(mode == "pause") {
+        return HiddenCameraMode::PAUSE;
+    }
+
+    return HiddenCameraMode::KEEP;
+}
+
+int Settings::getMaxCameras() { return std::max(1, std::atoi(getValue("maxCameras").value_or("4").c_str())); }
+
+// in MiB, default fits one 4k YUY2 frame plus a couple of 1080p ones
+size_t Settings::getUploadBudget() { return (size_t)std::max(0, std::atoi(getValue("uploadBudget").value_or("24").c_str())) * 1024 * 1024; }
+size_t Settings::getTexturePoolSize() { return (size_t)std::max(0, std::atoi(getValue("texturePoolSize").value_or("256").c_str())) * 1024 * 1024; }
+
+int Settings::getClayMaxElements() { return std::clamp(std::atoi(getValue("clayMaxElements").value_or("1024").c_str()), 256, 65536); }
+// clay hashes measured words into one bucket per 32 of them
+int Settings::getClayMaxMeasuredWords() { return std::clamp(std::atoi(getValue("clayMaxMeasuredWords").value_or("4096").c_str()), 256, 131072) / 32 * 32; }
+
+std::string Settings::getRecordingDirectory() {
+    std::optional<std::string> directory = getValue("recordingDirectory");
+    if(directory.has_value()) {
+        return directory.value();
+    }
+
+    const char* videos = SDL_GetUserFolder(SDL_FOLDER_VIDEOS);
+    if(videos != nullptr) {
+        return videos;
+    }
+
+    return std::getenv("HOME") != nullptr ? std::getenv("HOME") : ".";
+}
+
+std::string Settings::getScreenshotDirectory() {
+    std::optional<std::string> directory = getValue("screenshotDirectory");
+    if(directory.has_value()) {
+        return directory.value();
+    }
+
+    const char* pictures = SDL_GetUserFolder(SDL_FOLDER_PICTURES);
+    if(pictures != nullptr) {
+        return pictures;
+    }
+
+    return getRecordingDirectory();
+}
+
+std::string Settings::getScreenshotFormat() { return getValue("screenshotFormat").value_or("png"); }
+
+// in MiB, compressed desktop captures fit minutes while raw 1080p60 only fits a few seconds
+size_t Settings::getReplayBufferSize() { return (size_t)std::max(0, std::atoi(getValue("replayBufferSize").value_or("0").c_str())) * 1024 * 1024; }
+
+int Settings::getReplaySeconds() { return std::max(1, std::atoi(getValue("replaySeconds").value_or("120").c_str())); }
+int Settings::getReplaySaveSeconds() { return std::max(1, std::atoi(getValue("replaySaveSeconds").value_or("30").c_str())); }
+bool Settings::isReplayCompressionEnabled() { return getValue("replayCompression").value_or("true") == "true"; }
+
+std::string Settings::getShmExportName() {
+    std::string name = getValue("shmExport").value_or("");
+
+    // shm_open names start with a slash
+    if(!name.empty() && name[0] != '/') {
+        name = "/" + name;
+    }
+
+    return name;
+}
+
+int Settings::getShmExportSlots() { return std::clamp(std::atoi(getValue("shmExportSlots").value_or("4").c_str()), 2, 64); }
+std::string Settings::getAudioSocketPath() { return getValue("audioSocket").value_or(""); }
+std::string Settings::getPipeVideoPath() { return getValue("pipeVideo").value_or(""); }
+std::string Settings::getPipeAudioPath() { return getValue("pipeAudio").value_or(""); }
+
+PipeFullPolicy Settings::getPipeFullPolicy() {
+    if(getValue("pipeFullPolicy").value_or("dropNewest") == "dropOldest") {
+        return PipeFullPolicy::DROP_OLDEST;
+    }
+
+    return PipeFullPolicy::DROP_NEWEST;
+}
+
+int Settings::getHttpPreviewPort() { return std::clamp(std::atoi(getValue("httpPreviewPort").value_or("0").c_str()), 0, 65535); }
+std::string Settings::getHttpPreviewAddress() { return getValue("httpPreviewAddress").value_or("127.0.0.1"); }
+int Settings::getHttpPreviewFPS() { return std::clamp(std::atoi(getValue("httpPreviewFPS").value_or("10").c_str()), 1, 60); }
+int Settings::getHttpPreviewQuality() { return std::clamp(std::atoi(getValue("httpPreviewQuality").value_or("75").c_str()), 1, 100); }
+
+std::string Settings::getUdpAudioDestination() { return getValue("udpAudioSend").value_or(""); }
+float Settings::getUdpAudioLoss() { return std::clamp((float)std::atof(getValue("udpAudioLoss").value_or("0").c_str()), 0.0f, 100.0f) / 100.0f; }
+float Settings::getUdpAudioReorder() { return std::clamp((float)std::atof(getValue("udpAudioReorder").value_or("0").c_str()), 0.0f, 100.0f) / 100.0f; }
+int Settings::getUdpAudioReceivePort() { return std::clamp(std::atoi(getValue("udpAudioReceivePort").value_or("0").c_str()), 0, 65535); }
+std::string Settings::getUdpAudioReceiveAddress() { return getValue("udpAudioReceiveAddress").value_or("0.0.0.0"); }
+int Settings::getUdpAudioLatency() { return std::clamp(std::atoi(getValue("udpAudioLatency").value_or("10").c_str()), 5, 300); }
+
+void Settings::setOverrides(int argc, char** argv) {
+    for(int i = 1; i < argc; i++) {
+        const std::string argument = argv[i];
+
+        const size_t pos = argument.find("=");
+        if(argument.rfind("--", 0) != 0 || pos == std::string::npos || pos == 2) {
+            SDL_Log("Ignoring argument %s, expected --key=value", argv[i]);
+            continue;
+        }
+
+        m_overrides[argument.substr(2, pos - 2)] = argument.substr(pos + 1);
+    }
+}
+
 std::optional<std::string> Settings::getValue(std::string key) {
+    auto overridden = m_overrides.find(key);
+    if(overridden != m_overrides.end()) {
+        return overridden->second;
+    }
+
     if(m_cache.find(key) == m_cache.end()) {
         return std::nullopt;
     }
@@ -166,12 +377,16 @@ std::optional<std::string> Settings::getValue(std::string key) {
 }
 
 void Settings::setValue(std::string key, std::string value) {
+    // changed while running, that wins over the command line from now on
+    m_overrides.erase(key);
     m_cache[key] = value;
 
     save();
 }
 
 void Settings::clearValue(std::string key) {
+    m_overrides.erase(key);
+
     auto it = m_cache.find(key);
     if(it != m_cache.end()) {
         m_cache.erase(it);
@@ -0,0 +1,79 @@
+#include <worker_pool.hpp>
+
+WorkerPool::WorkerPool(size_t threadCount, size_t maxQueuedJobs)
+    : m_maxQueuedJobs(maxQueuedJobs) {
+    for(size_t i = 0; i < threadCount; i++) {
+        m_threads.emplace_back(&WorkerPool::workerThread, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    m_mutex.lock();
+    m_stopping = true;
+    m_mutex.unlock();
+
+    m_jobAvailable.notify_all();
+    for(std::thread& thread : m_threads) {
+        thread.join();
+    }
+}
+
+bool WorkerPool::trySubmit(Job job) {
+    std::unique_lock lock(m_mutex);
+    if(m_jobs.size() >= m_maxQueuedJobs) {
+        return false;
+    }
+
+    m_jobs.push_back(std::move(job));
+    lock.unlock();
+
+    m_jobAvailable.notify_one();
+    return true;
+}
+
+void WorkerPool::submit(Job job) {
+    std::unique_lock lock(m_mutex);
+    m_jobFinished.wait(lock, [this]() { return m_jobs.size() < m_maxQueuedJobs; });
+
+    m_jobs.push_back(std::move(job));
+    lock.unlock();
+
+    m_jobAvailable.notify_one();
+}
+
+void WorkerPool::wait() {
+    std::unique_lock lock(m_mutex);
+    m_jobFinished.wait(lock, [this]() { return m_jobs.empty() && m_runningJobs == 0; });
+}
+
+size_t WorkerPool::getQueuedJobs() {
+    std::lock_guard lock(m_mutex);
+    return m_jobs.size();
+}
+
+size_t WorkerPool::getThreadCount() const { return m_threads.size(); }
+
+void WorkerPool::workerThread() {
+    std::unique_lock lock(m_mutex);
+
+    while(true) {
+        m_jobAvailable.wait(lock, [this]() { return m_stopping || !m_jobs.empty(); });
+        if(m_jobs.empty()) {
+            // only reachable when stopping, queued jobs are always drained first
+            return;
+        }
+
+        Job job = std::move(m_jobs.front());
+        m_jobs.pop_front();
+        m_runningJobs++;
+
+        // the job is destroyed before relocking since it may hold the last reference to something expensive
+        lock.unlock();
+        job();
+        job = nullptr;
+        lock.lock();
+
+        m_runningJobs--;
+        m_jobFinished.notify_all();
+    }
+}
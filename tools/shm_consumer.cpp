@@ -0,0 +1,82 @@
+// reference reader for the shared memory frame export, prints what arrives once a second.
+// frames are read in place, a real consumer would hand view.data to its encoder or analysis instead of summing it
+#include <SDL3/SDL.h>
+
+#include <cstdio>
+#include <shm_ring.hpp>
+#include <string>
+
+int main(int argc, char** argv) {
+    const std::string name = argc > 1 ? argv[1] : "/capturecardrelay";
+
+    ShmRing ring;
+    Uint64 seen = 0;
+
+    Uint64 frames   = 0;
+    Uint64 bytes    = 0;
+    Uint64 skipped  = 0;
+    Uint64 torn     = 0;
+    Uint64 checksum = 0;
+
+    Uint64 lastFrameSequence = 0;
+    Uint64 reportNS          = SDL_GetTicksNS();
+
+    while(true) {
+        if(!ring.isOpen() || ring.isClosed()) {
+            if(!ring.open(name)) {
+                SDL_Delay(500);
+                continue;
+            }
+
+            printf("opened %s, %u slots of %zu bytes\n", name.c_str(), ring.getHeader()->slotCount, ring.getSlotDataSize());
+
+            // start with whatever is newest instead of the backlog
+            seen              = ring.getHeader()->published;
+            lastFrameSequence = 0;
+        }
+
+        const Uint64 published = ring.wait(seen, 1000);
+        if(published > seen) {
+            ShmRing::View view;
+            if(ring.acquire(published - 1, &view)) {
+                // touch every cache line like a real consumer would
+                Uint64 sum = 0;
+                for(Uint64 i = 0; i < view.header->size; i += 64) {
+                    sum += view.data[i];
+                }
+
+                if(ring.validate(view)) {
+                    if(lastFrameSequence != 0 && view.header->frameSequence > lastFrameSequence + 1) {
+                        skipped += view.header->frameSequence - lastFrameSequence - 1;
+                    }
+
+                    lastFrameSequence = view.header->frameSequence;
+                    checksum         += sum;
+                    bytes            += view.header->size;
+                    frames++;
+                }
+                else {
+                    torn++;
+                }
+            }
+
+            seen = published;
+        }
+
+        const Uint64 nowNS = SDL_GetTicksNS();
+        if(nowNS - reportNS >= SDL_NS_PER_SECOND) {
+            const double seconds = (double)(nowNS - reportNS) / SDL_NS_PER_SECOND;
+
+            printf("%.1f fps, %.1f MiB/s, %llu skipped, %llu torn (checksum %llx)\n", frames / seconds, bytes / seconds / (1024.0 * 1024.0), (unsigned long long)skipped, (unsigned long long)torn, (unsigned long long)checksum);
+            fflush(stdout);
+
+            frames   = 0;
+            bytes    = 0;
+            skipped  = 0;
+            torn     = 0;
+            reportNS = nowNS;
+        }
+    }
+
+    return 0;
+}